@@ -2,7 +2,13 @@
 //  Created by IvanBrekman on 03.11.2021.
 //
 
-#define VALIDATE_LEVEL 4
+#ifndef VALIDATE_LEVEL
+    #define VALIDATE_LEVEL 4
+#endif
 
-#define LOG_PRINTF 1
-#define LOG_GRAPH  1
+#ifndef LOG_PRINTF
+    #define LOG_PRINTF 1
+#endif
+#ifndef LOG_GRAPH
+    #define LOG_GRAPH  1
+#endif
@@ -0,0 +1,377 @@
+#include <cstdlib>
+#include <cstring>
+#include <cstdarg>
+#include <atomic>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include "async_log.h"
+
+struct AsyncLogRecord {
+    std::atomic<unsigned long> seq;     // Record is free for position seq, or filled for position seq - 1
+    int  file;
+    int  size;
+    char data[ASYNC_LOG_RECORD_SIZE];
+};
+
+enum async_log_states {
+    LOG_STOPPED  = 0,
+    LOG_STARTING = 1,
+    LOG_RUNNING  = 2,
+    LOG_STOPPING = 3,
+    LOG_BROKEN   = 4    // Start failed, all records are dropped
+};
+
+static const char* const ASYNC_LOG_FILENAMES[ASYNC_LOG_N_FILES] = { "log.txt", "log.html" };
+static const unsigned long ASYNC_LOG_MASK = ASYNC_LOG_RECORDS - 1;
+
+static AsyncLogRecord*            log_ring = NULL;
+static std::atomic<unsigned long> log_tail(0);          // Next position for writing threads
+static std::atomic<unsigned long> log_head(0);          // Next position for background thread
+static std::atomic<unsigned long> log_dropped(0);
+static std::atomic<int>           log_state(LOG_STOPPED);
+static std::atomic<int>           log_writers(0);       // Threads, which can touch ring now
+static std::atomic<int>           log_sleeping(0);      // Background thread waits for records
+static pthread_t                  log_thread;
+
+static pthread_mutex_t log_mutex   = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  log_wakeup  = PTHREAD_COND_INITIALIZER;   // New records or stop
+static pthread_cond_t  log_drained = PTHREAD_COND_INITIALIZER;   // Background thread moved records
+
+static int   log_fds    [ASYNC_LOG_N_FILES] = { -1, -1 };
+static char* log_batches[ASYNC_LOG_N_FILES] = { NULL, NULL };
+static int   log_batch_sizes[ASYNC_LOG_N_FILES] = { 0, 0 };
+
+//! Function writes collected batch of file to disk
+//! \param file index of log file (see async_log_files)
+static void flush_batch(int file) {
+    if (log_batch_sizes[file] == 0) return;
+
+    if (log_fds[file] < 0) {
+        log_fds[file] = open(ASYNC_LOG_FILENAMES[file], O_WRONLY | O_CREAT | O_APPEND, 0644);
+    }
+    if (log_fds[file] >= 0) {
+        ssize_t written = write(log_fds[file], log_batches[file], (size_t)log_batch_sizes[file]);
+        (void)written;
+    }
+
+    log_batch_sizes[file] = 0;
+}
+
+//! Function adds text to batch of file (batch is written, if it is full)
+//! \param file index of log file
+//! \param data ptr to text
+//! \param size size of text
+static void add_to_batch(int file, const char* data, int size) {
+    if (log_batch_sizes[file] + size > ASYNC_LOG_BATCH_SIZE) {
+        flush_batch(file);
+    }
+
+    memcpy(log_batches[file] + log_batch_sizes[file], data, (size_t)size);
+    log_batch_sizes[file] += size;
+}
+
+//! Function moves all filled records from ring to files
+//! \return number of moved records
+static int drain_ring() {
+    static unsigned long reported_dropped = 0;
+
+    unsigned long head  = log_head.load(std::memory_order_relaxed);
+    int           moved = 0;
+
+    for ( ; ; head++, moved++) {
+        AsyncLogRecord* record = &log_ring[head & ASYNC_LOG_MASK];
+        if (record->seq.load(std::memory_order_acquire) != head + 1) break;
+
+        add_to_batch(record->file, record->data, record->size);
+
+        record->seq.store(head + ASYNC_LOG_RECORDS, std::memory_order_release);
+        log_head.store(head + 1, std::memory_order_release);
+    }
+
+    unsigned long dropped = log_dropped.load(std::memory_order_relaxed);
+    if (dropped != reported_dropped) {
+        char message[64] = "";
+        int  size = snprintf(message, sizeof(message), "async log: %lu records dropped\n", dropped - reported_dropped);
+
+        add_to_batch(ASYNC_LOG_TXT, message, size);
+        reported_dropped = dropped;
+    }
+
+    for (int file = 0; file < ASYNC_LOG_N_FILES; file++) {
+        flush_batch(file);
+    }
+
+    return moved;
+}
+
+//! Function checks if background thread has record to move
+//! \return 1 if next record is filled, else 0
+static int ring_has_record() {
+    unsigned long head = log_head.load(std::memory_order_relaxed);
+    return log_ring[head & ASYNC_LOG_MASK].seq.load(std::memory_order_seq_cst) == head + 1;
+}
+
+//! Function wakes background thread, if it sleeps (called after record is filled). Only first
+//! thread after thread fell asleep takes mutex
+static void wake_writer() {
+    if (log_sleeping.load(std::memory_order_seq_cst) && log_sleeping.exchange(0, std::memory_order_seq_cst)) {
+        pthread_mutex_lock(&log_mutex);
+        pthread_cond_signal(&log_wakeup);
+        pthread_mutex_unlock(&log_mutex);
+    }
+}
+
+//! Function of background thread: drains ring till async_log_stop is called
+//! \return NULL
+static void* writer_thread(void*) {
+    while (log_state.load(std::memory_order_acquire) == LOG_RUNNING) {
+        if (drain_ring() != 0) {
+            pthread_mutex_lock(&log_mutex);
+            pthread_cond_broadcast(&log_drained);
+            pthread_mutex_unlock(&log_mutex);
+            continue;
+        }
+
+        // Flag is set before ring is checked, so thread, which fills record after check, sees flag and wakes it
+        pthread_mutex_lock(&log_mutex);
+        log_sleeping.store(1, std::memory_order_seq_cst);
+        if (log_state.load(std::memory_order_acquire) == LOG_RUNNING && !ring_has_record()) {
+            pthread_cond_wait(&log_wakeup, &log_mutex);
+        }
+        log_sleeping.store(0, std::memory_order_relaxed);
+        pthread_mutex_unlock(&log_mutex);
+    }
+
+    while (drain_ring() != 0) {
+        continue;
+    }
+
+    pthread_mutex_lock(&log_mutex);
+    pthread_cond_broadcast(&log_drained);
+    pthread_mutex_unlock(&log_mutex);
+
+    return NULL;
+}
+
+//! Function stops log at exit of program, so all records get to disk
+static void stop_at_exit() {
+    async_log_stop();
+}
+
+//! Function starts background thread (it is called automatically by first record)
+//! \return 1 if log is running, else 0
+int async_log_start() {
+    int state = log_state.load(std::memory_order_acquire);
+
+    while (state != LOG_RUNNING) {
+        if (state == LOG_BROKEN || state == LOG_STOPPING) return 0;
+
+        if (state == LOG_STOPPED && log_state.compare_exchange_strong(state, LOG_STARTING)) {
+            log_ring = (AsyncLogRecord*) calloc(ASYNC_LOG_RECORDS, sizeof(AsyncLogRecord));
+            for (int file = 0; file < ASYNC_LOG_N_FILES && log_ring != NULL; file++) {
+                log_batches[file] = (char*) calloc(ASYNC_LOG_BATCH_SIZE, sizeof(char));
+            }
+
+            if (log_ring == NULL || log_batches[ASYNC_LOG_TXT] == NULL || log_batches[ASYNC_LOG_HTML] == NULL) {
+                log_state.store(LOG_BROKEN, std::memory_order_release);
+                return 0;
+            }
+
+            unsigned long head = log_head.load(std::memory_order_relaxed);
+            log_tail.store(head, std::memory_order_relaxed);
+            for (unsigned long i = 0; i < (unsigned long)ASYNC_LOG_RECORDS; i++) {
+                log_ring[(head + i) & ASYNC_LOG_MASK].seq.store(head + i, std::memory_order_relaxed);
+            }
+
+            log_state.store(LOG_RUNNING, std::memory_order_release);
+            if (pthread_create(&log_thread, NULL, writer_thread, NULL) != 0) {
+                log_state.store(LOG_BROKEN, std::memory_order_release);
+                return 0;
+            }
+
+            static int registered = 0;
+            if (!registered) registered = !atexit(stop_at_exit);
+
+            return 1;
+        }
+
+        state = log_state.load(std::memory_order_acquire);
+    }
+
+    return 1;
+}
+
+//! Function writes all records to files and stops background thread. Ring is freed only
+//! after all threads in async_log_write leave it
+//! \return 1 if log was running, else 0
+int async_log_stop() {
+    int state = LOG_RUNNING;
+    if (!log_state.compare_exchange_strong(state, LOG_STOPPING)) return 0;
+
+    // Writers, which came after state change, see it and leave; waiting for ones, which came before
+    while (log_writers.load(std::memory_order_seq_cst) != 0) {
+        sched_yield();
+    }
+
+    pthread_mutex_lock(&log_mutex);
+    pthread_cond_signal(&log_wakeup);
+    pthread_mutex_unlock(&log_mutex);
+
+    pthread_join(log_thread, NULL);
+
+    for (int file = 0; file < ASYNC_LOG_N_FILES; file++) {
+        if (log_fds[file] >= 0) close(log_fds[file]);
+        log_fds[file] = -1;
+
+        free(log_batches[file]);
+        log_batches[file] = NULL;
+    }
+    free(log_ring);
+    log_ring = NULL;
+
+    log_state.store(LOG_STOPPED, std::memory_order_release);
+    return 1;
+}
+
+//! Function waits till all records, which were written before call, are on disk
+//! \return 1 if log is running, else 0
+int async_log_flush() {
+    if (log_state.load(std::memory_order_acquire) != LOG_RUNNING) return 0;
+
+    unsigned long tail = log_tail.load(std::memory_order_acquire);
+
+    pthread_mutex_lock(&log_mutex);
+    while (log_head.load(std::memory_order_acquire) < tail && log_state.load(std::memory_order_acquire) == LOG_RUNNING) {
+        pthread_cond_wait(&log_drained, &log_mutex);
+    }
+    pthread_mutex_unlock(&log_mutex);
+
+    return 1;
+}
+
+//! Function writes long message to file directly, after all earlier records
+//! \param file index of log file (see async_log_files)
+//! \param data ptr to message
+//! \param size size of message
+//! \return     1 if message is written, else 0
+static int write_directly(int file, const char* data, size_t size) {
+    async_log_flush();
+
+    int fd = open(ASYNC_LOG_FILENAMES[file], O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) {
+        log_dropped.fetch_add(1, std::memory_order_relaxed);
+        return 0;
+    }
+
+    while (size > 0) {
+        ssize_t written = write(fd, data, size);
+        if (written <= 0) break;
+
+        data += written;
+        size -= (size_t)written;
+    }
+
+    close(fd);
+    return size == 0;
+}
+
+//! Function reserves neighbour records and fills them with message (called, while thread is in log_writers)
+//! \param file      index of log file (see async_log_files)
+//! \param data      ptr to message
+//! \param size      size of message
+//! \param n_records number of records for message
+//! \return          1 if message is in ring, 0 if it was dropped
+static int write_records(int file, const char* data, size_t size, unsigned long n_records) {
+    // Reserving n_records neighbour records. Background thread frees records in order,
+    // so if last of them is free, all of them are free
+    unsigned long pos = log_tail.load(std::memory_order_relaxed);
+    for ( ; ; ) {
+        unsigned long last = pos + n_records - 1;
+        long diff = (long)(log_ring[last & ASYNC_LOG_MASK].seq.load(std::memory_order_acquire) - last);
+
+        if (diff == 0) {
+            if (log_tail.compare_exchange_weak(pos, pos + n_records, std::memory_order_relaxed)) break;
+        } else if (diff < 0) {
+            log_dropped.fetch_add(1, std::memory_order_relaxed);
+            return 0;
+        } else {
+            pos = log_tail.load(std::memory_order_relaxed);
+        }
+    }
+
+    for (unsigned long i = 0; i < n_records; i++) {
+        AsyncLogRecord* record = &log_ring[(pos + i) & ASYNC_LOG_MASK];
+        size_t part = size < (size_t)ASYNC_LOG_RECORD_SIZE ? size : (size_t)ASYNC_LOG_RECORD_SIZE;
+
+        record->file = file;
+        record->size = (int)part;
+        memcpy(record->data, data, part);
+
+        // seq_cst: background thread sets log_sleeping before it checks record, so one of them sees other
+        record->seq.store(pos + i + 1, std::memory_order_seq_cst);
+
+        data += part;
+        size -= part;
+    }
+
+    wake_writer();
+    return 1;
+}
+
+//! Function appends message to ring (long message is written directly)
+//! \param file index of log file (see async_log_files)
+//! \param data ptr to message
+//! \param size size of message
+//! \return     1 if message is in ring or file, 0 if it was dropped
+int async_log_write(int file, const char* data, size_t size) {
+    if (size == 0) return 1;
+    if (file < 0 || file >= ASYNC_LOG_N_FILES || !async_log_start()) {
+        log_dropped.fetch_add(1, std::memory_order_relaxed);
+        return 0;
+    }
+
+    unsigned long n_records = (size + ASYNC_LOG_RECORD_SIZE - 1) / ASYNC_LOG_RECORD_SIZE;
+    if (n_records > (unsigned long)ASYNC_LOG_MAX_RECORDS) {
+        return write_directly(file, data, size);
+    }
+
+    // Thread is counted before state is checked, so async_log_stop doesn`t free ring under it
+    log_writers.fetch_add(1, std::memory_order_seq_cst);
+
+    int result = 0;
+    if (log_state.load(std::memory_order_seq_cst) == LOG_RUNNING) {
+        result = write_records(file, data, size, n_records);
+    } else {
+        log_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    log_writers.fetch_sub(1, std::memory_order_release);
+    return result;
+}
+
+//! Function formats message and appends it to ring
+//! \param file   index of log file (see async_log_files)
+//! \param format printf format string
+//! \return       1 if message is in ring, 0 if it was dropped
+int async_log_printf(int file, const char* format, ...) {
+    char message[ASYNC_LOG_RECORD_SIZE * 4] = "";
+
+    va_list args;
+    va_start(args, format);
+    int size = vsnprintf(message, sizeof(message), format, args);
+    va_end(args);
+
+    if (size < 0) return 0;
+    if ((size_t)size >= sizeof(message)) size = (int)sizeof(message) - 1;
+
+    return async_log_write(file, message, (size_t)size);
+}
+
+//! Function gets number of dropped records
+//! \return number of records, which were dropped because ring was full
+unsigned long async_log_dropped() {
+    return log_dropped.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,52 @@
+#ifndef ASYNC_LOG_H
+#define ASYNC_LOG_H
+
+#include <cstdio>
+#include <cstdlib>
+
+// Asynchronous log------------------------------------------------------------
+// Threads append records to lock-free ring in memory. One background thread (started on first
+// record) takes them in order and writes to log files in batches through file descriptors,
+// which stay open till exit. Thread sleeps on condition variable, while ring is empty.
+// If ring is full, record is dropped: number of dropped records is written to log.txt and
+// can be got by async_log_dropped(). Messages longer than ASYNC_LOG_MAX_RECORDS records
+// aren`t put to ring: they are written synchronously after all earlier records.
+
+const int ASYNC_LOG_RECORDS     = 1 << 13;     // Should be power of 2
+const int ASYNC_LOG_RECORD_SIZE = 240;         // Longer messages take several neighbour records
+const int ASYNC_LOG_MAX_RECORDS = 1 << 11;     // Longest message in ring (in records)
+const int ASYNC_LOG_BATCH_SIZE  = 1 << 16;     // Size of writer buffer for one file
+
+enum async_log_files {
+    ASYNC_LOG_TXT  = 0,     // log.txt
+    ASYNC_LOG_HTML = 1,     // log.html
+
+    ASYNC_LOG_N_FILES
+};
+
+//! Runs code, which writes to FILE* async_log_file, and sends all written text as one message
+#define ASYNC_LOG_CALL(file, code) {                                                \
+    char*  async_log_buf  = NULL;                                                   \
+    size_t async_log_size = 0;                                                      \
+    FILE*  async_log_file = open_memstream(&async_log_buf, &async_log_size);        \
+                                                                                    \
+    if (async_log_file != NULL) {                                                   \
+        code;                                                                       \
+        fclose(async_log_file);                                                     \
+                                                                                    \
+        async_log_write(file, async_log_buf, async_log_size);                       \
+    }                                                                               \
+    free(async_log_buf);                                                            \
+}
+
+int async_log_start();
+int async_log_stop();
+int async_log_flush();
+
+int async_log_write (int file, const char* data, size_t size);
+int async_log_printf(int file, const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+unsigned long async_log_dropped();
+// ----------------------------------------------------------------------------
+
+#endif // ASYNC_LOG_H
@@ -8,10 +8,275 @@
 #include <cerrno>
 #include <fcntl.h>
 #include <unistd.h>
+#include <pthread.h>
 #include <cstdio>
+#include <cstring>
 
 #include "baselib.h"
 
+#if PTR_CHECK == PTR_CHECK_MAPS
+const unsigned long MIN_VALID_ADDRESS  = 4096;      // First page is never mapped
+const int           BAD_PTR_CACHE_SIZE = 16;        // Pages of last bad pointers
+const long          BAD_PTR_CACHE_TIME = 10000000;  // ns, while bad pages are answered without rereading maps
+
+struct MemRange {
+    unsigned long begin;
+    unsigned long end;
+};
+
+//! Readable ranges of process. Published ranges aren`t changed: new ones replace them
+struct MemRanges {
+    MemRange*  ranges;
+    int        n_ranges;
+    MemRanges* next_retired;
+};
+
+//! Slot of thread for lookups: ranges, which are in hazard of some slot, aren`t freed
+struct MemRangesReader {
+    MemRanges*       hazard;
+    int              in_use;
+    MemRangesReader* next;
+};
+
+static MemRanges*       mem_ranges     = NULL;     // Published ranges (loaded and stored atomically)
+static MemRanges*       retired_ranges = NULL;     // Replaced ranges, which readers can still use
+static MemRangesReader* mem_readers    = NULL;     // Slots of all threads (changed under mutex)
+static pthread_mutex_t  mem_ranges_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static pthread_key_t  mem_reader_key  = { };
+static pthread_once_t mem_reader_once = PTHREAD_ONCE_INIT;
+static thread_local MemRangesReader* mem_reader = NULL;
+
+static unsigned long bad_ptr_pages[BAD_PTR_CACHE_SIZE] = { };
+static long          bad_ptr_deadline = 0;         // Bad pages are forgotten after it (or after reload)
+static int           bad_ptr_next     = 0;
+
+//! Function gets monotonic time
+//! \return time in ns
+static long mem_ranges_time() {
+    struct timespec ts = { };
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ts.tv_sec * 1000000000L + ts.tv_nsec;
+}
+
+//! Function frees slot of finished thread for next threads (pthread key destructor)
+//! \param reader ptr to MemRangesReader object
+static void free_mem_reader(void* reader) {
+    __atomic_store_n(&((MemRangesReader*)reader)->hazard, (MemRanges*)NULL, __ATOMIC_RELEASE);
+    __atomic_store_n(&((MemRangesReader*)reader)->in_use, 0, __ATOMIC_RELEASE);
+}
+
+//! Function creates key, which frees slots of finished threads
+static void create_mem_reader_key() {
+    pthread_key_create(&mem_reader_key, free_mem_reader);
+}
+
+//! Function gets slot of current thread (takes free slot or adds new one on first call of thread)
+//! \return ptr to MemRangesReader object (NULL if there is no memory)
+static MemRangesReader* get_mem_reader() {
+    if (mem_reader != NULL) return mem_reader;
+
+    pthread_once(&mem_reader_once, create_mem_reader_key);
+    pthread_mutex_lock(&mem_ranges_mutex);
+
+    MemRangesReader* reader = mem_readers;
+    while (reader != NULL && __atomic_load_n(&reader->in_use, __ATOMIC_ACQUIRE)) reader = reader->next;
+
+    if (reader == NULL) {
+        reader = (MemRangesReader*) calloc(1, sizeof(MemRangesReader));
+
+        if (reader != NULL) {
+            reader->next = mem_readers;
+            mem_readers  = reader;
+        }
+    }
+    if (reader != NULL) reader->in_use = 1;
+
+    pthread_mutex_unlock(&mem_ranges_mutex);
+
+    if (reader != NULL) {
+        pthread_setspecific(mem_reader_key, reader);
+        mem_reader = reader;
+    }
+    return reader;
+}
+
+//! Function reads readable memory ranges of process from /proc/self/maps (neighbour ranges are merged)
+//! \return ptr to new MemRanges object (NULL if error)
+static MemRanges* load_mem_ranges() {
+    FILE* maps = fopen("/proc/self/maps", "r");
+    if (maps == NULL) return NULL;
+
+    MemRanges* new_ranges = (MemRanges*) calloc(1, sizeof(MemRanges));
+    int capacity = 0;
+
+    unsigned long begin = 0;
+    unsigned long end   = 0;
+    char perms[5] = "";
+    while (new_ranges != NULL && fscanf(maps, "%lx-%lx %4s%*[^\n]", &begin, &end, perms) == 3) {
+        if (perms[0] != 'r') continue;
+
+        if (new_ranges->n_ranges > 0 && new_ranges->ranges[new_ranges->n_ranges - 1].end == begin) {
+            new_ranges->ranges[new_ranges->n_ranges - 1].end = end;
+            continue;
+        }
+
+        if (new_ranges->n_ranges == capacity) {
+            capacity = capacity > 0 ? capacity * 2 : 64;
+
+            MemRange* ranges = (MemRange*) realloc(new_ranges->ranges, capacity * sizeof(MemRange));
+            if (ranges == NULL) break;
+
+            new_ranges->ranges = ranges;
+        }
+        new_ranges->ranges[new_ranges->n_ranges++] = { begin, end };
+    }
+
+    fclose(maps);
+    return new_ranges;
+}
+
+//! Function checks if address lies in one of ranges (binary search, ranges are sorted)
+//! \param ranges ptr to MemRanges object (can be NULL)
+//! \param addr   checking address
+//! \return       1 if address is found, else 0
+static int find_mem_range(const MemRanges* ranges, unsigned long addr) {
+    if (ranges == NULL) return 0;
+
+    int left  = 0;
+    int right = ranges->n_ranges - 1;
+
+    while (left <= right) {
+        int mid = (left + right) / 2;
+
+        if      (addr <  ranges->ranges[mid].begin) right = mid - 1;
+        else if (addr >= ranges->ranges[mid].end)   left  = mid + 1;
+        else                                        return 1;
+    }
+
+    return 0;
+}
+
+//! Function looks address up in published ranges. Ranges are kept in hazard of thread slot, so
+//! they aren`t freed during search
+//! \param addr checking address
+//! \return     1 if address is found, else 0
+static int find_published_mem_range(unsigned long addr) {
+    MemRangesReader* reader = get_mem_reader();
+    if (reader == NULL) {
+        pthread_mutex_lock(&mem_ranges_mutex);
+        int found = find_mem_range(mem_ranges, addr);
+        pthread_mutex_unlock(&mem_ranges_mutex);
+
+        return found;
+    }
+
+    MemRanges* ranges = NULL;
+    do {
+        ranges = __atomic_load_n(&mem_ranges, __ATOMIC_SEQ_CST);
+        __atomic_store_n(&reader->hazard, ranges, __ATOMIC_SEQ_CST);
+    } while (ranges != __atomic_load_n(&mem_ranges, __ATOMIC_SEQ_CST));
+
+    int found = find_mem_range(ranges, addr);
+    __atomic_store_n(&reader->hazard, (MemRanges*)NULL, __ATOMIC_RELEASE);
+
+    return found;
+}
+
+//! Function checks if page of address was bad recently
+//! \param page page of checking address
+//! \return     1 if page is in bad pointers cache, else 0
+static int find_bad_ptr_page(unsigned long page) {
+    if (mem_ranges_time() >= __atomic_load_n(&bad_ptr_deadline, __ATOMIC_ACQUIRE)) return 0;
+
+    for (int i = 0; i < BAD_PTR_CACHE_SIZE; i++) {
+        if (__atomic_load_n(&bad_ptr_pages[i], __ATOMIC_RELAXED) == page) return 1;
+    }
+
+    return 0;
+}
+
+//! Function frees retired ranges, which are not in hazard of any thread (called under mutex)
+static void free_retired_mem_ranges() {
+    MemRanges** link = &retired_ranges;
+
+    while (*link != NULL) {
+        MemRanges* ranges = *link;
+
+        int used = 0;
+        for (MemRangesReader* reader = mem_readers; reader != NULL && !used; reader = reader->next) {
+            used = __atomic_load_n(&reader->hazard, __ATOMIC_SEQ_CST) == ranges;
+        }
+
+        if (used) {
+            link = &ranges->next_retired;
+        } else {
+            *link = ranges->next_retired;
+
+            free(ranges->ranges);
+            free(ranges);
+        }
+    }
+}
+
+//! Function rereads ranges after miss and publishes them (called under mutex)
+//! \param addr checking address
+//! \return     1 if address is found in new ranges, else 0
+static int reload_mem_ranges(unsigned long addr) {
+    MemRanges* new_ranges = load_mem_ranges();
+    if (new_ranges == NULL) return 0;
+
+    MemRanges* old_ranges = __atomic_exchange_n(&mem_ranges, new_ranges, __ATOMIC_SEQ_CST);
+    if (old_ranges != NULL) {
+        old_ranges->next_retired = retired_ranges;
+        retired_ranges = old_ranges;
+    }
+    free_retired_mem_ranges();
+
+    long now = mem_ranges_time();
+    if (now >= bad_ptr_deadline) {  // Pages are forgotten, they could be mapped since
+        for (int i = 0; i < BAD_PTR_CACHE_SIZE; i++) __atomic_store_n(&bad_ptr_pages[i], 0UL, __ATOMIC_RELAXED);
+        __atomic_store_n(&bad_ptr_deadline, now + BAD_PTR_CACHE_TIME, __ATOMIC_RELEASE);
+    }
+
+    int found = find_mem_range(new_ranges, addr);
+    if (!found) {
+        __atomic_store_n(&bad_ptr_pages[bad_ptr_next], addr / MIN_VALID_ADDRESS, __ATOMIC_RELAXED);
+        bad_ptr_next = (bad_ptr_next + 1) % BAD_PTR_CACHE_SIZE;
+    }
+
+    return found;
+}
+
+//! Function checks validity of pointer by cached /proc/self/maps ranges. Lookup takes no lock: ranges are
+//! published by atomic ptr and are reread under lock only on miss, so good pointers cost no syscalls.
+//! Pages of bad pointers are remembered for BAD_PTR_CACHE_TIME, so repeated bad pointer rereads maps
+//! not more often. !Note! memory unmapped after caching still looks readable and page mapped after
+//! its bad pointer was cached looks bad up to BAD_PTR_CACHE_TIME
+//! \param  ptr checking pointer
+//! \return 0 if all is good, else != 0 (errno is set like in PTR_CHECK_PROBE version)
+int isbadreadptr(const void* ptr) {
+    unsigned long addr = (unsigned long)ptr;
+    int found = 0;
+
+    if (addr >= MIN_VALID_ADDRESS) {
+        found = find_published_mem_range(addr);
+
+        if (!found && !find_bad_ptr_page(addr / MIN_VALID_ADDRESS)) {
+            pthread_mutex_lock(&mem_ranges_mutex);
+
+            found = find_mem_range(mem_ranges, addr);   // Other thread could reload ranges, while this one waited
+            if (!found) found = reload_mem_ranges(addr);
+
+            pthread_mutex_unlock(&mem_ranges_mutex);
+        }
+    }
+
+    errno = found ? 0 : EFAULT;
+    return errno;
+}
+#else
 //! Function checks validity of pointer
 //! \param  ptr checking pointer
 //! \return 0 if all is good, else != 0
@@ -24,6 +289,7 @@ int isbadreadptr(const void* ptr) {
 
     return errno;
 }
+#endif
 
 //! Function writes current date and time to calendar_date
 //! \param calendar_date ptr to string, where current date and time will bw written
@@ -103,29 +369,137 @@ char* bin4(int number) {
 
 //! Function convert number to string
 //! \param number converting number
-//! \return       converted number
+//! \return       converted number (string is valid till next 8 calls in this thread)
 const char* to_string(int number) {
-    if (number == 0) {
-        return "0";
+    static const int RING_SIZE = 8;     // One printf call can use several numbers
+
+    static thread_local char ring[RING_SIZE][INT_STR_SIZE] = { };
+    static thread_local int  ring_pos = 0;
+
+    char* str_num = ring[ring_pos];
+    ring_pos = (ring_pos + 1) % RING_SIZE;
+
+    format_int(str_num, number);
+    return (const char*) str_num;
+}
+
+//! Function writes number to buffer without allocations
+//! \param buf    ptr to buffer (at least INT_STR_SIZE chars)
+//! \param number number
+//! \return       length of written string
+int format_int(char* buf, int number) {
+    static const char DIGIT_PAIRS[] = "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+                                      "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+                                      "8081828384858687888990919293949596979899";
+
+    char  digits[INT_STR_SIZE] = "";
+    char* digit = digits + INT_STR_SIZE;
+
+    unsigned int abs_number = number < 0 ? 0U - (unsigned int)number : (unsigned int)number;
+    while (abs_number >= 100) {
+        unsigned int pair = abs_number % 100;
+        abs_number /= 100;
+
+        *--digit = DIGIT_PAIRS[2 * pair + 1];
+        *--digit = DIGIT_PAIRS[2 * pair];
+    }
+    if (abs_number >= 10) {
+        *--digit = DIGIT_PAIRS[2 * abs_number + 1];
+        *--digit = DIGIT_PAIRS[2 * abs_number];
+    } else {
+        *--digit = (char)('0' + abs_number);
+    }
+    if (number < 0) *--digit = '-';
+
+    int len = (int)(digits + INT_STR_SIZE - digit);
+    memcpy(buf, digit, (size_t)len);
+    buf[len] = '\0';
+
+    return len;
+}
+
+//! Function prepares dump buffer for writing to file
+//! \param buf  ptr to DumpBuffer object
+//! \param file ptr to file (all text, which was written to it before, goes first)
+void dump_buffer_open(DumpBuffer* buf, FILE* file) {
+    assert(VALID_PTR(buf)  && "Invalid buf ptr");
+    assert(VALID_PTR(file) && "Invalid file ptr");
+
+    fflush(file);
+
+    buf->file = file;
+    buf->fd   = fileno(file);
+    buf->size = 0;
+}
+
+//! Function writes collected text of dump buffer to its file
+//! \param buf ptr to DumpBuffer object
+void dump_buffer_flush(DumpBuffer* buf) {
+    assert(VALID_PTR(buf) && "Invalid buf ptr");
+
+    if (buf->fd < 0) {
+        if (buf->size > 0) fwrite(buf->data, sizeof(char), (size_t)buf->size, buf->file);
+        buf->size = 0;
+        return;
     }
 
-    int shift = 0;
-    if (number < 0) {
-        shift = 1;
-        number = -number;
+    for (int written = 0; written < buf->size; ) {
+        ssize_t part = write(buf->fd, buf->data + written, (size_t)(buf->size - written));
+        if (part <= 0 && errno != EINTR) break;
+        if (part > 0) written += (int)part;
     }
+    buf->size = 0;
+}
 
-    int d_num = digits_number(number, 10);
-    char* str_num = (char*) calloc(d_num + shift + 1, sizeof(char));
+//! Function writes text, which doesn`t fit in dump buffer: flushes buffer and appends text
+//! \param buf ptr to DumpBuffer object
+//! \param str ptr to text
+//! \param len length of text
+void dump_buffer_spill(DumpBuffer* buf, const char* str, int len) {
+    dump_buffer_flush(buf);
 
-    for (int i = d_num - 1; number > 0; i--) {
-        str_num[i + shift] = (char)('0' + (number % 10));
-        number /= 10;
+    for ( ; len > DUMP_BUFFER_SIZE; str += DUMP_BUFFER_SIZE, len -= DUMP_BUFFER_SIZE) {
+        memcpy(buf->data, str, DUMP_BUFFER_SIZE);
+        buf->size = DUMP_BUFFER_SIZE;
+        dump_buffer_flush(buf);
     }
-    if (shift) str_num[0] = '-';
-    str_num[d_num + shift] = '\0';
 
-    return (const char*) str_num;
+    memcpy(buf->data, str, (size_t)len);
+    buf->size = len;
+}
+
+//! Function appends text aligned to right (like "%*s")
+//! \param buf   ptr to DumpBuffer object
+//! \param str   ptr to text
+//! \param len   length of text
+//! \param width minimal width of field
+static void dump_buffer_aligned(DumpBuffer* buf, const char* str, int len, int width) {
+    static const char SPACES[] = "                ";
+
+    for (int pad = width - len; pad > 0; pad -= (int)sizeof(SPACES) - 1) {
+        dump_buffer_write(buf, SPACES, pad < (int)sizeof(SPACES) - 1 ? pad : (int)sizeof(SPACES) - 1);
+    }
+
+    dump_buffer_write(buf, str, len);
+}
+
+//! Function appends string aligned to right (like "%*s")
+//! \param buf   ptr to DumpBuffer object
+//! \param str   ptr to string
+//! \param width minimal width of field
+void dump_buffer_padded(DumpBuffer* buf, const char* str, int width) {
+    dump_buffer_aligned(buf, str, (int)strlen(str), width);
+}
+
+//! Function appends number aligned to right (like "%*d")
+//! \param buf    ptr to DumpBuffer object
+//! \param number number
+//! \param width  minimal width of field
+void dump_buffer_int(DumpBuffer* buf, int number, int width) {
+    char str_num[INT_STR_SIZE] = "";
+    int  len = format_int(str_num, number);
+
+    dump_buffer_aligned(buf, str_num, len, width);
 }
 
 //! Function compares to int  values
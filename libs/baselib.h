@@ -5,6 +5,10 @@
 #ifndef BASELIB_H
 #define BASELIB_H
 
+#include <cstring>
+
+#include "async_log.h"
+
 #ifndef VALIDATE_LEVEL
     #define VALIDATE_LEVEL 1
 #endif
@@ -17,6 +21,15 @@
     #define LOG_GRAPH 0
 #endif
 
+// Backends of isbadreadptr (VALID_PTR)----------------------------------------
+#define PTR_CHECK_PROBE 0   // Writes 1 byte from ptr to /dev/random: 3 syscalls per check
+#define PTR_CHECK_MAPS  1   // Looks ptr up in cached /proc/self/maps ranges: syscalls only on cache miss
+
+#ifndef PTR_CHECK
+    #define PTR_CHECK PTR_CHECK_MAPS
+#endif
+// ----------------------------------------------------------------------------
+
 #define dbg(code) do{ printf("%s:%d\n", __FILE__, __LINE__); code }while(0)
 #define LOCATION(var) { TYPE, #var, __FILE__, __FUNCTION__, __LINE__ }
 #define VALID_PTR(ptr) !isbadreadptr((const void*)(ptr))
@@ -46,26 +59,23 @@ Default define to ASSERT_OK. Use it to customize macros for each project.
 
 */
 
+// Log macros write to log.txt and log.html through asynchronous log (see async_log.h)
 #define LOG_DUMP(obj, reason, func) {                                               \
     if (VALIDATE_LEVEL >= HIGHEST_VALIDATE) {                                       \
-        FILE* log = open_file("log.txt", "a");                                      \
-        func(obj, reason, log);                                                     \
-        fclose(log);                                                                \
+        ASYNC_LOG_CALL(ASYNC_LOG_TXT, func(obj, reason, async_log_file));           \
     }                                                                               \
 }
 
 #define LOG_DUMP_GRAPH(obj, reason, func) {                                         \
-    FILE* gr_log = open_file("log.html", "a");                                      \
-    if (LOG_GRAPH == 1) func(obj, reason, gr_log);                                  \
-    fclose(gr_log);                                                                 \
+    if (LOG_GRAPH == 1) {                                                           \
+        ASYNC_LOG_CALL(ASYNC_LOG_HTML, func(obj, reason, async_log_file));          \
+    }                                                                               \
 }
 
 #define PRINT_WARNING(text) {                                                       \
     printf(ORANGE text NATURAL);                                                    \
     if (VALIDATE_LEVEL >= HIGHEST_VALIDATE) {                                       \
-        FILE* wlog = open_file("log.txt", "a");                                     \
-        fprintf(wlog, text);                                                        \
-        fclose(wlog);                                                               \
+        async_log_printf(ASYNC_LOG_TXT, text);                                      \
     }                                                                               \
 }
 
@@ -144,6 +154,52 @@ enum poisons {
     date = NULL;                                                \
 };
 
+// Dump buffer-----------------------------------------------------------------
+// Fixed scratch buffer for dumps: text is collected in it and written to file by big blocks,
+// numbers are formatted without allocations. It lives on stack of dump function, so memory
+// of dump doesn`t depend on size of dumped object. Blocks go straight to file descriptor
+// by write (FILE is flushed on open), memory streams get them by fwrite.
+
+const int INT_STR_SIZE     = 12;        // Enough for any int with sign and '\0'
+const int DUMP_BUFFER_SIZE = 1 << 12;
+
+struct DumpBuffer {
+    FILE* file;
+    int   fd;       // -1 if file has no descriptor (memory stream)
+    int   size;
+    char  data[DUMP_BUFFER_SIZE];
+};
+
+int  format_int(char* buf, int number);
+
+void dump_buffer_open   (DumpBuffer* buf, FILE* file);
+void dump_buffer_flush  (DumpBuffer* buf);
+void dump_buffer_spill  (DumpBuffer* buf, const char* str, int len);
+void dump_buffer_padded (DumpBuffer* buf, const char* str, int width);
+void dump_buffer_int    (DumpBuffer* buf, int number, int width);
+
+//! Function appends text to dump buffer (it is inline: dumps call it for each few chars)
+//! \param buf ptr to DumpBuffer object
+//! \param str ptr to text
+//! \param len length of text
+inline void dump_buffer_write(DumpBuffer* buf, const char* str, int len) {
+    if (buf->size + len > DUMP_BUFFER_SIZE) {
+        dump_buffer_spill(buf, str, len);
+        return;
+    }
+
+    memcpy(buf->data + buf->size, str, (size_t)len);
+    buf->size += len;
+}
+
+//! Function appends string to dump buffer
+//! \param buf ptr to DumpBuffer object
+//! \param str ptr to string
+inline void dump_buffer_puts(DumpBuffer* buf, const char* str) {
+    dump_buffer_write(buf, str, (int)strlen(str));
+}
+// ----------------------------------------------------------------------------
+
 int isbadreadptr(const void* ptr);
 char* datetime(char* calendar_date);
 
@@ -0,0 +1,166 @@
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <spawn.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+
+#include "dot_pool.h"
+
+extern char** environ;
+
+struct DotJob {
+    char*  dot_text;
+    size_t size;
+    int    number;
+
+    DotJob* next;
+};
+
+static pthread_once_t  pool_once  = PTHREAD_ONCE_INIT;
+static pthread_mutex_t pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t  pool_has_jobs = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t  pool_is_idle  = PTHREAD_COND_INITIALIZER;
+
+static DotJob* jobs_first  = NULL;
+static DotJob* jobs_last   = NULL;
+static int     n_jobs      = 0;     // Jobs in queue and jobs, which are rendered now
+static int     next_number = 1;     // Numbers start from 1: list_dump_graph returns 0 on error
+static int     pool_ok     = 0;
+
+static unsigned long dropped_jobs = 0;
+
+//! Function writes DOT text of job to file and runs dot on it
+//! \param job ptr to DotJob object
+static void render_job(const DotJob* job) {
+    char dot_path  [DOT_POOL_PATH_SIZE] = "";
+    char image_path[DOT_POOL_PATH_SIZE] = "";
+    snprintf(dot_path,   sizeof(dot_path),   "logs/dot_%d_%d.txt",   (int)getpid(), job->number);
+    snprintf(image_path, sizeof(image_path), "logs/graph_%d_%d.png", (int)getpid(), job->number);
+
+    int fd = open(dot_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return;
+
+    ssize_t written = write(fd, job->dot_text, job->size);
+    close(fd);
+    if (written != (ssize_t)job->size) return;
+
+    char  dot_name[] = "dot";
+    char  format[]   = "-Tpng";
+    char  output[]   = "-o";
+    char* args[] = { dot_name, format, dot_path, output, image_path, NULL };
+
+    pid_t pid = 0;
+    if (posix_spawnp(&pid, "dot", NULL, NULL, args, environ) == 0) {
+        waitpid(pid, NULL, 0);
+    }
+
+    unlink(dot_path);
+}
+
+//! Function of worker thread: renders jobs from queue
+//! \return NULL
+static void* dot_worker(void*) {
+    for ( ; ; ) {
+        pthread_mutex_lock(&pool_mutex);
+        while (jobs_first == NULL) {
+            pthread_cond_wait(&pool_has_jobs, &pool_mutex);
+        }
+
+        DotJob* job = jobs_first;
+        jobs_first  = job->next;
+        if (jobs_first == NULL) jobs_last = NULL;
+        pthread_mutex_unlock(&pool_mutex);
+
+        render_job(job);
+        free(job->dot_text);
+        free(job);
+
+        pthread_mutex_lock(&pool_mutex);
+        if (--n_jobs == 0) pthread_cond_broadcast(&pool_is_idle);
+        pthread_mutex_unlock(&pool_mutex);
+    }
+
+    return NULL;
+}
+
+//! Function waits for all jobs at exit, so all images are rendered
+static void wait_at_exit() {
+    dot_pool_wait();
+}
+
+//! Function starts worker threads (called once by first job)
+static void start_pool() {
+    mkdir("logs", 0755);
+
+    for (int i = 0; i < DOT_POOL_WORKERS; i++) {
+        pthread_t worker;
+        if (pthread_create(&worker, NULL, dot_worker, NULL) != 0) continue;
+
+        pthread_detach(worker);
+        pool_ok = 1;
+    }
+
+    atexit(wait_at_exit);
+}
+
+//! Function gives DOT text to workers
+//! \param dot_text   ptr to DOT text (allocated by malloc, pool frees it)
+//! \param size       size of DOT text
+//! \param image_path ptr to buffer for path of future image
+//! \param path_size  size of image_path buffer (DOT_POOL_PATH_SIZE is enough)
+//! \return           number of job (>= 1, -1 if job was dropped)
+int dot_pool_submit(char* dot_text, size_t size, char* image_path, size_t path_size) {
+    pthread_once(&pool_once, start_pool);
+
+    DotJob* job = (DotJob*) calloc(1, sizeof(DotJob));
+
+    pthread_mutex_lock(&pool_mutex);
+    if (!pool_ok || job == NULL || n_jobs >= DOT_POOL_MAX_JOBS) {
+        dropped_jobs++;
+        pthread_mutex_unlock(&pool_mutex);
+
+        free(job);
+        free(dot_text);
+        if (path_size > 0) image_path[0] = '\0';
+        return -1;
+    }
+
+    int number = next_number++;
+    *job = { dot_text, size, number, NULL };
+
+    if (jobs_last != NULL) jobs_last->next = job;
+    else                   jobs_first      = job;
+    jobs_last = job;
+    n_jobs++;
+
+    pthread_cond_signal(&pool_has_jobs);
+    pthread_mutex_unlock(&pool_mutex);
+
+    snprintf(image_path, path_size, "logs/graph_%d_%d.png", (int)getpid(), number);
+    return number;
+}
+
+//! Function waits till all given jobs are rendered
+//! \return 1
+int dot_pool_wait() {
+    pthread_mutex_lock(&pool_mutex);
+    while (n_jobs > 0) {
+        pthread_cond_wait(&pool_is_idle, &pool_mutex);
+    }
+    pthread_mutex_unlock(&pool_mutex);
+
+    return 1;
+}
+
+//! Function gets number of dropped jobs
+//! \return number of jobs, which were dropped because queue was full
+unsigned long dot_pool_dropped() {
+    pthread_mutex_lock(&pool_mutex);
+    unsigned long dropped = dropped_jobs;
+    pthread_mutex_unlock(&pool_mutex);
+
+    return dropped;
+}
@@ -0,0 +1,23 @@
+#ifndef DOT_POOL_H
+#define DOT_POOL_H
+
+#include <cstdio>
+
+// Graphviz worker pool--------------------------------------------------------
+// Caller gives DOT text from memory and gets path of future image at once. Worker threads
+// write DOT to logs/dot_<pid>_<n>.txt and render it by dot to logs/graph_<pid>_<n>.png.
+// Number n grows monotonically, so images of dumps made in one second don`t overwrite each other.
+// Workers don`t touch log.html: caller writes html with path of image, and log is appended
+// in batches by async log thread (see libs/async_log.h).
+
+const int DOT_POOL_WORKERS   = 2;
+const int DOT_POOL_MAX_JOBS  = 64;      // Jobs over this number are dropped
+const int DOT_POOL_PATH_SIZE = 64;
+
+int dot_pool_submit(char* dot_text, size_t size, char* image_path, size_t path_size);
+int dot_pool_wait();
+
+unsigned long dot_pool_dropped();
+// ----------------------------------------------------------------------------
+
+#endif // DOT_POOL_H
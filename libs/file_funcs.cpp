@@ -5,13 +5,19 @@
 #include <cstdio>
 #include <cstdlib>
 #include <cassert>
+#include <cerrno>
 
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
 #include <cstring>
-#include <cctype>
+#include <cstdint>
 
 #include "baselib.h"
 #include "file_funcs.h"
+#include "text_scan.h"
 
 //! Function replaces old_symbol to new_symbol in string n_replace times
 //! \param string     pointer to string
@@ -25,24 +31,21 @@
 int replace(char* string, size_t size, char old_symbol, char new_symbol, int n_replace) {
     assert(VALID_PTR(string) && "invalid string ptr");
 
-    int n_rep = 0;
-
-    for (int i = 0; i < (int)size; i++) {
-        if (n_rep >= n_replace && n_replace >= 0) {
-            break;
-        }
-        if (string[i] == old_symbol) {
-            string[i] = new_symbol;
-            n_rep++;
-        }
-    }
-
-    return n_rep;
+    size_t limit = n_replace < 0 ? SIZE_MAX : (size_t)n_replace;
+    return (int)scan_replace_byte(string, string + size, old_symbol, new_symbol, limit);
 }
 
 void free_text(struct Text* data) {
     assert(VALID_PTR(data) && "Invalid data ptr");
 
+    if (data->is_mapped) {
+        if (data->data != NULL) munmap(data->data, data->data_size);
+        free(data->text);
+
+        data->is_mapped = 0;
+        data->lines     = 0;
+    }
+
     data->data = NULL;
     data->data_size = -1;
 
@@ -74,7 +77,7 @@ void print_text(const Text* data, const char* sep, const char* end) {
 
     printf("[ ");
     for (int i = 0; i < (int)data->lines; i++) {
-        printf("\"%s\"", data->text[i].ptr);
+        printf("\"%.*s\"", (int)data->text[i].len, data->text[i].ptr);
         if (i + 1 < (int)data->lines) printf("%s", sep);
     }
     printf(" ]%s", end);
@@ -98,6 +101,411 @@ void print_strings(const char** array, size_t size, const char* sep, const char*
     printf(" ]%s", end);
 }
 
+// Line splitting--------------------------------------------------------------
+// Buffer is checked by blocks of TEXT_SCAN_BLOCK bytes: kernel gives masks of delimiters and spaces
+// of block, so bounds of lines and their first/last letters are found by bit operations
+// without loop by bytes of line. Only lines, which are started in previous blocks, use scan funcs.
+
+struct LineSplit {
+    char delimiter;
+    int  skip_empty_strings;
+    int  skip_first_last_spaces;
+    int  need_delimiter;    // Last line without delimiter is not added
+    int  cut_spaces;        // Write '\0' after last letter; string of spaces becomes empty at its beginning
+};
+
+//! Function adds line to strings by its bounds and bounds of its letters
+//! \param strings    ptr to array of strings
+//! \param n_strings  ptr to number of written strings
+//! \param skiped_str ptr to number of skipped strings
+//! \param split      ptr to LineSplit object with options
+//! \param start      ptr to beginning of line
+//! \param line_end   ptr to end of line
+//! \param first      ptr to first letter (line_end if line is string of spaces)
+//! \param last       ptr after last letter
+static inline void add_line(String* strings, size_t* n_strings, size_t* skiped_str, const LineSplit* split,
+                            char* start, char* line_end, char* first, char* last) {
+    if (split->skip_first_last_spaces) {
+        if (first == line_end && split->cut_spaces) first = last = start;
+        if (split->cut_spaces) *last = '\0';
+    } else {
+        first = start;
+        last  = line_end;
+    }
+
+    if (split->skip_empty_strings && last == first) {
+        (*skiped_str)++;
+    } else {
+        strings[(*n_strings)++] = { first, (size_t)(last - first) };
+    }
+}
+
+//! Function splits buffer to lines by delimiter
+//! \param data        ptr to buffer
+//! \param size        size of buffer
+//! \param strings     ptr to array of strings
+//! \param max_strings max number of written strings
+//! \param split       ptr to LineSplit object with options
+//! \param skiped_str  ptr to number of skipped strings
+//! \return            number of written strings
+static size_t split_lines(char* data, size_t size, String* strings, size_t max_strings,
+                          const LineSplit* split, size_t* skiped_str) {
+    size_t n_strings = 0;
+
+    char* start = data;
+    char* end   = data + size;
+
+    for (char* block = data; end - block >= TEXT_SCAN_BLOCK && n_strings < max_strings; block += TEXT_SCAN_BLOCK) {
+        uint64_t delimiters = 0, spaces = 0;
+        scan_block_masks(block, split->delimiter, &delimiters, &spaces);
+
+        uint64_t letters = ~(spaces | delimiters);
+        for ( ; delimiters != 0 && n_strings < max_strings; delimiters &= delimiters - 1) {
+            char* line_end = block + __builtin_ctzll(delimiters);
+            char* first    = line_end;
+            char* last     = line_end;
+
+            if (!split->skip_first_last_spaces) {
+                // Bounds of letters are not needed
+            } else if (start >= block) {
+                uint64_t line_letters = letters & (~0ULL << (start - block)) & ((1ULL << (line_end - block)) - 1);
+                if (line_letters != 0) {
+                    first = block + __builtin_ctzll(line_letters);
+                    last  = block + TEXT_SCAN_BLOCK - __builtin_clzll(line_letters);
+                }
+            } else {
+                first = start + (scan_skip_spaces(start, line_end) - start);
+                last  = first + (scan_trim_spaces(first, line_end) - first);
+            }
+
+            add_line(strings, &n_strings, skiped_str, split, start, line_end, first, last);
+            start = line_end + 1;
+        }
+    }
+
+    while (start < end && n_strings < max_strings) {
+        char* line_end = start + (scan_find_byte(start, end, split->delimiter) - start);   // Buffer is not const
+        if (line_end == end && split->need_delimiter) break;
+
+        char* first = line_end;
+        char* last  = line_end;
+        if (split->skip_first_last_spaces) {
+            first = start + (scan_skip_spaces(start, line_end) - start);
+            last  = first + (scan_trim_spaces(first, line_end) - first);
+        }
+
+        add_line(strings, &n_strings, skiped_str, split, start, line_end, first, last);
+        start = line_end + 1;
+    }
+
+    return n_strings;
+}
+// ----------------------------------------------------------------------------
+
+// Parallel line splitting-----------------------------------------------------
+// Buffer is cut to chunks after delimiters. Threads count lines of their chunks (get_text_from_file
+// replaces '\n' by '\0' in the same pass), prefix sums of counts give parts of strings array, then
+// threads split their chunks to their parts. Skipped strings leave gaps, which are closed at the end,
+// so strings are the same as strings of serial split.
+
+struct TextChunk {
+    char*  begin;
+    char*  end;
+
+    size_t max_strings;     // Lines in chunk
+    size_t offset;          // Beginning of chunk part in strings
+    size_t n_strings;
+    size_t skiped_str;
+    size_t extra_delimiters;    // '\0' in chunk before replacing (they break equality with serial split)
+
+    String*          strings;
+    const LineSplit* split;
+    int              replace_newlines;
+    int              check_delimiters;  // Count extra_delimiters (needed only for several chunks)
+};
+
+//! Function counts lines of chunk (thread function)
+//! \param arg ptr to TextChunk object
+//! \return    NULL
+static void* count_chunk_lines(void* arg) {
+    TextChunk* chunk = (TextChunk*)arg;
+
+    if (chunk->replace_newlines) {
+        if (chunk->check_delimiters) {
+            chunk->extra_delimiters = scan_count_byte(chunk->begin, chunk->end, chunk->split->delimiter);
+        }
+        chunk->max_strings      = scan_replace_byte(chunk->begin, chunk->end, '\n', chunk->split->delimiter, SIZE_MAX);
+    } else {
+        chunk->max_strings = scan_count_byte(chunk->begin, chunk->end, chunk->split->delimiter);
+        if (!chunk->split->need_delimiter && chunk->end > chunk->begin && chunk->end[-1] != chunk->split->delimiter) {
+            chunk->max_strings++;
+        }
+    }
+
+    return NULL;
+}
+
+//! Function splits chunk to its part of strings (thread function)
+//! \param arg ptr to TextChunk object
+//! \return    NULL
+static void* split_chunk_lines(void* arg) {
+    TextChunk* chunk = (TextChunk*)arg;
+
+    chunk->n_strings = split_lines(chunk->begin, (size_t)(chunk->end - chunk->begin), chunk->strings + chunk->offset,
+                                   chunk->max_strings, chunk->split, &chunk->skiped_str);
+    return NULL;
+}
+
+//! Function runs func for every chunk: first chunk in current thread, others in new threads
+//! \param chunks     ptr to array of chunks
+//! \param chunk_size size of one chunk object
+//! \param n_chunks   number of chunks
+//! \param func       thread function
+static void run_chunks(void* chunks, size_t chunk_size, int n_chunks, void* (*func)(void*)) {
+    pthread_t threads[TEXT_MAX_THREADS] = {};
+    int       started[TEXT_MAX_THREADS] = {};
+
+    for (int i = 1; i < n_chunks; i++) {
+        void* chunk = (char*)chunks + i * chunk_size;
+
+        started[i] = pthread_create(&threads[i], NULL, func, chunk) == 0;
+        if (!started[i]) func(chunk);
+    }
+
+    func(chunks);
+
+    for (int i = 1; i < n_chunks; i++) {
+        if (started[i]) pthread_join(threads[i], NULL);
+    }
+}
+
+//! Function defines number of threads for buffer
+//! \param n_threads wanted number of threads (TEXT_THREADS_AUTO - number of CPUs)
+//! \param size      size of buffer
+//! \return          number of threads (each gets at least TEXT_THREAD_MIN_CHUNK bytes)
+static int text_threads(int n_threads, size_t size) {
+    if (n_threads == TEXT_THREADS_AUTO) n_threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+
+    size_t max_threads = size / TEXT_THREAD_MIN_CHUNK;
+    if ((size_t)n_threads > max_threads) n_threads = (int)max_threads;
+    if (n_threads > TEXT_MAX_THREADS)    n_threads = TEXT_MAX_THREADS;
+
+    return n_threads < 1 ? 1 : n_threads;
+}
+
+//! Function splits buffer to lines by several threads (result is the same as result of serial split)
+//! \param text             ptr to Text object with data, text->text is allocated by function
+//! \param split            ptr to LineSplit object with options
+//! \param replace_newlines flag to replace '\n' by delimiter before split (as get_text_from_file does)
+//! \param n_threads        number of threads (TEXT_THREADS_AUTO - number of CPUs)
+//! \return                 1 if success, else 0
+static int split_text(Text* text, const LineSplit* split, int replace_newlines, int n_threads) {
+    n_threads = text_threads(n_threads, text->data_size);
+
+    TextChunk* chunks = (TextChunk*)calloc(n_threads, sizeof(TextChunk));
+    if (chunks == NULL) return 0;
+
+    char* data = text->data;
+    char* end  = text->data + text->data_size;
+    char  raw_delimiter = replace_newlines ? '\n' : split->delimiter;
+
+    char* begin = data;
+    for (int i = 0; i < n_threads; i++) {
+        char* chunk_end = end;
+        if (i + 1 < n_threads) {
+            chunk_end = data + text->data_size / n_threads * (i + 1);
+            if (chunk_end < begin) chunk_end = begin;
+
+            chunk_end = begin + (scan_find_byte(chunk_end, end, raw_delimiter) - begin);
+            if (chunk_end < end) chunk_end++;
+        }
+
+        chunks[i] = { begin, chunk_end, 0, 0, 0, 0, 0, NULL, split, replace_newlines, n_threads > 1 };
+        begin = chunk_end;
+    }
+
+    run_chunks(chunks, sizeof(TextChunk), n_threads, count_chunk_lines);
+
+    size_t max_strings = 0, extra_delimiters = 0;
+    for (int i = 0; i < n_threads; i++) {
+        chunks[i].offset  = max_strings;
+        max_strings      += chunks[i].max_strings;
+        extra_delimiters += chunks[i].extra_delimiters;
+    }
+
+    text->text  = (String*)calloc(max_strings, sizeof(String));
+    text->lines = 0;
+    if (text->text == NULL) {
+        free(chunks);
+        return 0;
+    }
+
+    if (extra_delimiters > 0) {
+        // '\0' in file: serial split stops by number of '\n', chunks can`t know their parts of it
+        chunks[0] = { data, end, max_strings, 0, 0, 0, 0, NULL, split, 0, 0 };
+        n_threads = 1;
+    }
+
+    for (int i = 0; i < n_threads; i++) chunks[i].strings = text->text;
+    run_chunks(chunks, sizeof(TextChunk), n_threads, split_chunk_lines);
+
+    for (int i = 0; i < n_threads; i++) {
+        if (chunks[i].offset != text->lines) {
+            memmove(text->text + text->lines, text->text + chunks[i].offset, chunks[i].n_strings * sizeof(String));
+        }
+        text->lines += chunks[i].n_strings;
+    }
+
+    free(chunks);
+    return 1;
+}
+// ----------------------------------------------------------------------------
+
+// Parallel number parsing-----------------------------------------------------
+// Buffer is cut to chunks at spaces. Threads count words of their chunks, prefix sums of counts give
+// indexes of first numbers of chunks, sink reserves place for all numbers, then threads parse their
+// chunks by batches and give batches to sink with their indexes.
+
+struct ParseChunk {
+    const char* begin;
+    const char* end;
+
+    size_t n_values;        // Words in chunk
+    size_t offset;          // Index of first number of chunk
+    int    ok;
+
+    const IntSink* sink;
+};
+
+//! Function counts words of chunk (thread function)
+//! \param arg ptr to ParseChunk object
+//! \return    NULL
+static void* count_chunk_numbers(void* arg) {
+    ParseChunk* chunk = (ParseChunk*)arg;
+
+    chunk->n_values = scan_count_words(chunk->begin, chunk->end);
+    return NULL;
+}
+
+//! Function parses numbers of chunk and gives them to sink (thread function)
+//! \param arg ptr to ParseChunk object
+//! \return    NULL
+static void* parse_chunk_numbers(void* arg) {
+    ParseChunk* chunk = (ParseChunk*)arg;
+
+    int values[PARSE_BATCH] = {};
+
+    const char* cur   = chunk->begin;
+    size_t      index = chunk->offset;
+    size_t      left  = chunk->n_values;
+    while (left > 0) {
+        size_t n_parsed = scan_parse_ints(cur, chunk->end, values, left < (size_t)PARSE_BATCH ? left : PARSE_BATCH, &cur);
+        if (n_parsed == 0) return NULL;     // Word isn`t number
+
+        chunk->sink->write(chunk->sink->object, index, values, n_parsed);
+        index += n_parsed;
+        left  -= n_parsed;
+    }
+
+    chunk->ok = 1;
+    return NULL;
+}
+
+//! Function parses decimal int numbers, which are divided by spaces, and gives them to sink
+//! \param data      ptr to buffer
+//! \param size      size of buffer
+//! \param sink      ptr to IntSink object
+//! \param n_threads number of threads (default 1, TEXT_THREADS_AUTO - all CPUs)
+//! \return          1 if success, else 0 (errno is EINVAL if buffer has not a number, ENOMEM if sink can`t reserve place)
+int parse_ints(const char* data, size_t size, const IntSink* sink, int n_threads) {
+    assert((size == 0 || VALID_PTR(data)) && "Invalid data ptr");
+    assert(VALID_PTR(sink)                 && "Invalid sink ptr");
+
+    n_threads = text_threads(n_threads, size);
+
+    ParseChunk* chunks = (ParseChunk*)calloc(n_threads, sizeof(ParseChunk));
+    if (chunks == NULL) {
+        errno = ENOMEM;
+        return 0;
+    }
+
+    const char* end   = data + size;
+    const char* begin = data;
+    for (int i = 0; i < n_threads; i++) {
+        const char* chunk_end = end;
+        if (i + 1 < n_threads) {
+            chunk_end = data + size / n_threads * (i + 1);
+            if (chunk_end < begin) chunk_end = begin;
+
+            chunk_end = scan_find_space(chunk_end, end);
+        }
+
+        chunks[i] = { begin, chunk_end, 0, 0, 0, sink };
+        begin = chunk_end;
+    }
+
+    run_chunks(chunks, sizeof(ParseChunk), n_threads, count_chunk_numbers);
+
+    size_t n_values = 0;
+    for (int i = 0; i < n_threads; i++) {
+        chunks[i].offset = n_values;
+        n_values        += chunks[i].n_values;
+    }
+
+    if (!sink->reserve(sink->object, n_values)) {
+        free(chunks);
+        errno = ENOMEM;
+        return 0;
+    }
+
+    run_chunks(chunks, sizeof(ParseChunk), n_threads, parse_chunk_numbers);
+
+    int ok = 1;
+    for (int i = 0; i < n_threads; i++) ok = ok && chunks[i].ok;
+
+    free(chunks);
+    if (!ok) errno = EINVAL;
+    return ok;
+}
+
+//! Function maps file and parses its numbers (see parse_ints)
+//! \param filename  ptr to string of path to file
+//! \param sink      ptr to IntSink object
+//! \param n_threads number of threads (default 1, TEXT_THREADS_AUTO - all CPUs)
+//! \return          1 if success, else 0
+int parse_file_ints(const char* filename, const IntSink* sink, int n_threads) {
+    assert(VALID_PTR(filename) && "Invalid filename ptr");
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return 0;
+
+    struct stat buff = {};
+    if (fstat(fd, &buff) != 0) {
+        close(fd);
+        return 0;
+    }
+
+    size_t size = (size_t)buff.st_size;
+    if (size == 0) {
+        close(fd);
+        return parse_ints(NULL, 0, sink, n_threads);
+    }
+
+    void* data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return 0;
+
+    madvise(data, size, MADV_SEQUENTIAL);
+
+    int ok    = parse_ints((const char*)data, size, sink, n_threads);
+    int error = errno;
+
+    munmap(data, size);
+    errno = error;
+    return ok;
+}
+// ----------------------------------------------------------------------------
+
 //! Function load pointers of beginnings of strings to an array
 //! \param text                    ptr to Text object, where string will be written
 //! \param skip_empty_strings      flag to skip empty strings in text (default 0)
@@ -109,61 +517,48 @@ int load_string_pointers(Text* text, int skip_empty_strings, int skip_first_last
     assert((0 == skip_empty_strings     || skip_empty_strings     == 1) && "Incorrect skip_empty_strings value");
     assert((0 == skip_first_last_spaces || skip_first_last_spaces == 1) && "Incorrect skip_first_last_spaces value");
 
-    int skiped_str = 0, letters_started = 0, spaces_count = 0;
-    char* start_ptr = (char*)text->data;
+    LineSplit split = {
+            '\0', skip_empty_strings, skip_first_last_spaces,
+            1,      // Last string without '\0' is not a string
+            1       // Spaces after last letter are cut by '\0', string of spaces becomes empty string at its beginning
+    };
 
-    for (int i = 0, str_index = 0; i < (int)text->data_size && str_index < (int)text->lines; i++) {
-        if (text->data[i] == '\0') {
-            char* end_ptr = (char*)&(text->data[i]);
+    size_t skiped_str = 0;
+    split_lines(text->data, text->data_size, text->text, text->lines, &split, &skiped_str);
 
-            if (skip_first_last_spaces) {
-                if (spaces_count) {
-                    text->data[i - spaces_count] = '\0';
-                    end_ptr -= spaces_count;
-                    
-                    spaces_count = 0;
-                }
-
-                if (!letters_started) {
-                    start_ptr    += spaces_count;
-                    spaces_count  = 0;
-                }
-            }
+    text->lines -= skiped_str;
 
-            struct String string = {
-                    start_ptr,
-                    (size_t)(end_ptr - start_ptr)
-            };
+    return 1;
+}
 
-            if (skip_empty_strings && string.len == 0) {
-                skiped_str++;
-            } else {
-                text->text[str_index++] = string;
-            }
+//! Function counts lines in buffer (last line can be not ended by '\n')
+//! \param data ptr to buffer
+//! \param size size of buffer
+//! \return     number of lines
+size_t count_lines(const char* data, size_t size) {
+    assert((size == 0 || VALID_PTR(data)) && "Invalid data ptr");
 
-            start_ptr = (char*)&(text->data[i + 1]);
-            letters_started = 0;
+    if (size == 0) return 0;
 
-            continue;
-        }
+    return scan_count_byte(data, data + size, '\n') + (data[size - 1] != '\n');
+}
 
-        if (skip_first_last_spaces) {
-            if (isspace(text->data[i])) {
-                spaces_count++;
-            }
-            if (!isspace(text->data[i]) && !letters_started) {
-                start_ptr += spaces_count;
-                letters_started = 1;
-            }
-            if (!isspace(text->data[i])) {
-                spaces_count = 0;
-            }
-        }
-    }
+//! Function finds lines in buffer and writes them to strings without changing buffer
+//! (strings are not ended by '\0', use their len)
+//! \param data                    ptr to buffer
+//! \param size                    size of buffer
+//! \param strings                 ptr to array of count_lines(data, size) strings
+//! \param skip_empty_strings      flag to skip empty strings in text (default 0)
+//! \param skip_first_last_spaces  flag to skip spaces before first letter and after last letter (default 0)
+//! \return                        number of written strings
+size_t index_lines(char* data, size_t size, String* strings, int skip_empty_strings, int skip_first_last_spaces) {
+    assert((size == 0 || VALID_PTR(data))    && "Invalid data ptr");
+    assert((size == 0 || VALID_PTR(strings)) && "Invalid strings ptr");
 
-    text->lines -= skiped_str;
+    LineSplit split = { '\n', skip_empty_strings, skip_first_last_spaces, 0, 0 };
 
-    return 1;
+    size_t skiped_str = 0;
+    return split_lines(data, size, strings, SIZE_MAX, &split, &skiped_str);
 }
 
 //! Function convert array of strings to Text
@@ -245,8 +640,9 @@ FILE* open_file(const char* filename, const char mode[]) {
 //! \param filename                ptr to string of path to file
 //! \param skip_empty_strings      flag to skip empty strings in text (default 0)
 //! \param skip_first_last_spaces  flag to skip spaces before first letter and after last letter (default 0)
+//! \param n_threads               number of threads, which split text to lines (default 1, TEXT_THREADS_AUTO - all CPUs)
 //! \return                        object of Text structure
-Text get_text_from_file(const char* filename, int skip_empty_strings, int skip_first_last_spaces) {
+Text get_text_from_file(const char* filename, int skip_empty_strings, int skip_first_last_spaces, int n_threads) {
     assert(VALID_PTR(filename) && "Invalid filename ptr");
     assert((0 == skip_empty_strings     || skip_empty_strings     == 1) && "Incorrect skip_empty_strings value");
     assert((0 == skip_first_last_spaces || skip_first_last_spaces == 1) && "Incorrect skip_first_last_spaces value");
@@ -270,15 +666,155 @@ Text get_text_from_file(const char* filename, int skip_empty_strings, int skip_f
     Text text = {};
     text.data = data;
     text.data_size = f_size;
-    text.lines = replace(data, f_size, '\n', '\0');
 
-    text.text = (String*)calloc(text.lines, sizeof(String));
-    load_string_pointers(&text, skip_empty_strings, skip_first_last_spaces);
+    LineSplit split = { '\0', skip_empty_strings, skip_first_last_spaces, 1, 1 };
+    split_text(&text, &split, 1, n_threads);
 
     fclose(file);
     return text;
 }
 
+//! Function maps file to memory and finds its lines without copying. Text is read-only,
+//! its strings point to mapping and are not ended by '\0' (use their len). Free it by free_text
+//! \param filename                ptr to string of path to file
+//! \param skip_empty_strings      flag to skip empty strings in text (default 0)
+//! \param skip_first_last_spaces  flag to skip spaces before first letter and after last letter (default 0)
+//! \param n_threads               number of threads, which split text to lines (default 1, TEXT_THREADS_AUTO - all CPUs)
+//! \return                        object of Text structure (empty if file can`t be mapped)
+Text get_text_from_file_mapped(const char* filename, int skip_empty_strings, int skip_first_last_spaces, int n_threads) {
+    assert(VALID_PTR(filename) && "Invalid filename ptr");
+    assert((0 == skip_empty_strings     || skip_empty_strings     == 1) && "Incorrect skip_empty_strings value");
+    assert((0 == skip_first_last_spaces || skip_first_last_spaces == 1) && "Incorrect skip_first_last_spaces value");
+
+    Text text = {};
+
+    int fd = open(filename, O_RDONLY);
+    assert(fd >= 0 && "Can`t open file");
+
+    struct stat buff = {};
+    if (fstat(fd, &buff) != 0 || buff.st_size == 0) {
+        close(fd);
+        return text;
+    }
+
+    void* data = mmap(NULL, (size_t)buff.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return text;
+
+    madvise(data, (size_t)buff.st_size, MADV_SEQUENTIAL);
+
+    text.data      = (char*)data;
+    text.data_size = (size_t)buff.st_size;
+    text.is_mapped = 1;
+
+    LineSplit split = { '\n', skip_empty_strings, skip_first_last_spaces, 0, 0 };
+    split_text(&text, &split, 0, n_threads);
+
+    return text;
+}
+
+//! Function opens file for reading by windows (for files, which are bigger than memory)
+//! \param stream                  ptr to TextStream object
+//! \param filename                ptr to string of path to file
+//! \param skip_empty_strings      flag to skip empty strings in text (default 0)
+//! \param skip_first_last_spaces  flag to skip spaces before first letter and after last letter (default 0)
+//! \return                        1 if success, else 0
+int text_stream_open(TextStream* stream, const char* filename, int skip_empty_strings, int skip_first_last_spaces) {
+    assert(VALID_PTR(stream)   && "Invalid stream ptr");
+    assert(VALID_PTR(filename) && "Invalid filename ptr");
+
+    *stream = {};
+    stream->skip_empty_strings     = skip_empty_strings;
+    stream->skip_first_last_spaces = skip_first_last_spaces;
+
+    stream->fd = open(filename, O_RDONLY);
+    if (stream->fd < 0) return 0;
+
+    struct stat buff = {};
+    if (fstat(stream->fd, &buff) != 0) {
+        close(stream->fd);
+        stream->fd = -1;
+        return 0;
+    }
+    stream->file_size = (size_t)buff.st_size;
+
+    return 1;
+}
+
+//! Function maps next window of file and indexes its lines to stream->text
+//! (previous window and its strings become invalid)
+//! \param stream ptr to TextStream object
+//! \return       1 if next window is read, 0 if file is over (or error)
+int text_stream_next(TextStream* stream) {
+    assert(VALID_PTR(stream) && "Invalid stream ptr");
+
+    if (stream->window != NULL) munmap(stream->window, stream->window_size);
+    stream->window      = NULL;
+    stream->window_size = 0;
+    stream->text.lines  = 0;
+
+    if (stream->fd < 0 || stream->offset >= stream->file_size) return 0;
+
+    size_t page_size  = (size_t)sysconf(_SC_PAGESIZE);
+    size_t map_offset = stream->offset & ~(page_size - 1);
+
+    // Window is grown, while it doesn`t contain end of line
+    char*  data = NULL;
+    size_t size = 0;
+    for (size_t want = TEXT_STREAM_WINDOW; ; want *= 2) {
+        size_t map_end = stream->offset + want < stream->file_size ? stream->offset + want : stream->file_size;
+
+        stream->window_size = map_end - map_offset;
+        stream->window      = mmap(NULL, stream->window_size, PROT_READ, MAP_PRIVATE, stream->fd, (off_t)map_offset);
+        if (stream->window == MAP_FAILED) {
+            stream->window = NULL;
+            return 0;
+        }
+        madvise(stream->window, stream->window_size, MADV_SEQUENTIAL);
+
+        data = (char*)stream->window + (stream->offset - map_offset);
+        size = map_end - stream->offset;
+        if (map_end == stream->file_size) break;
+
+        char* last_end = (char*)memrchr(data, '\n', size);
+        if (last_end != NULL) {
+            size = (size_t)(last_end - data) + 1;
+            break;
+        }
+
+        munmap(stream->window, stream->window_size);
+    }
+
+    size_t max_lines = count_lines(data, size);
+    if (max_lines > stream->max_lines) {
+        String* strings = (String*)realloc(stream->text.text, max_lines * sizeof(String));
+        if (strings == NULL) return 0;
+
+        stream->text.text = strings;
+        stream->max_lines = max_lines;
+    }
+
+    stream->text.data      = data;
+    stream->text.data_size = size;
+    stream->text.lines     = index_lines(data, size, stream->text.text, stream->skip_empty_strings, stream->skip_first_last_spaces);
+
+    stream->offset += size;
+    return 1;
+}
+
+//! Function closes stream and frees its memory
+//! \param stream ptr to TextStream object
+void text_stream_close(TextStream* stream) {
+    assert(VALID_PTR(stream) && "Invalid stream ptr");
+
+    if (stream->window != NULL) munmap(stream->window, stream->window_size);
+    if (stream->fd >= 0)        close(stream->fd);
+    free(stream->text.text);
+
+    *stream = {};
+    stream->fd = -1;
+}
+
 //! Function writes strings to file (from Text->text)
 //! \param filename pointer to string of path to file (absolute or relative)
 //! \param mode     mode with which open file
@@ -302,7 +838,7 @@ int write_text_to_file(const char* filename, const char mode[], const Text* data
 
     int n_wr_strings = 0;
     for (n_wr_strings = 0; n_wr_strings < (int)data->lines; n_wr_strings++) {
-        fputs(data->text[n_wr_strings].ptr, file);
+        fwrite(data->text[n_wr_strings].ptr, sizeof(char), data->text[n_wr_strings].len, file);
         if (n_wr_strings + 1 < (int)data->lines) fputs(text_sep, file);
     }
     fputs(text_end, file);
@@ -18,8 +18,44 @@ struct Text {
 
     String* text;
     size_t lines;
+
+    int is_mapped;      // data is read-only mapping of file, strings are not ended by '\0'
+};
+
+const size_t TEXT_STREAM_WINDOW = 64 << 20;    // Part of file, which is mapped at once by TextStream
+
+const int    TEXT_THREADS_AUTO     = 0;         // Split text by all CPUs
+const int    TEXT_MAX_THREADS      = 128;
+const size_t TEXT_THREAD_MIN_CHUNK = 1 << 20;   // Smaller parts of text are not given to own threads
+
+//! Reads big file by windows: each text_stream_next call maps next part of file
+//! (only whole lines) and indexes its lines to text
+struct TextStream {
+    int    fd;
+    size_t file_size;
+    size_t offset;          // Beginning of next window in file
+
+    void*  window;          // Current mapping
+    size_t window_size;
+
+    Text   text;            // Lines of current window (they belong to stream)
+    size_t max_lines;       // Size of text.text array
+
+    int skip_empty_strings;
+    int skip_first_last_spaces;
+};
+
+//! Receiver of numbers, which are parsed by parse_ints. reserve is called once with number of all
+//! numbers, then write is called by several threads with batches of numbers and their indexes
+struct IntSink {
+    void* object;
+
+    int  (*reserve)(void* object, size_t n_values);
+    void (*write)  (void* object, size_t index, const int* values, size_t n_values);
 };
 
+const int PARSE_BATCH = 256;    // Numbers, which are parsed before they are given to sink
+
 int replace(char* string, size_t size, char old_symbol, char new_symbol, int n_replace=-1);
 
 void free_text(Text* data);
@@ -28,14 +64,24 @@ void free_string(String* string);
 void print_text(const Text* data, const char* sep=", ", const char* end="\n");
 void print_strings(const char** array, size_t size, const char* sep=", ", const char* end="\n");
 
-int  load_string_pointers(Text* text, int skip_empty_strings=0, int skip_first_last_spaces=0);
+int    load_string_pointers(Text* text, int skip_empty_strings=0, int skip_first_last_spaces=0);
+size_t count_lines         (const char* data, size_t size);
+size_t index_lines         (char* data,       size_t size, String* strings, int skip_empty_strings=0, int skip_first_last_spaces=0);
 Text convert_to_text(const char** strings, int n_strings);
 
 int  file_size       (const char* filename);
 long file_last_change(const char* filename);
 
 FILE* open_file(const char* filename, const char mode[]);
-Text get_text_from_file(const char* filename, int skip_empty_strings=0, int skip_first_last_spaces=0);
+Text get_text_from_file(const char* filename, int skip_empty_strings=0, int skip_first_last_spaces=0, int n_threads=1);
+Text get_text_from_file_mapped(const char* filename, int skip_empty_strings=0, int skip_first_last_spaces=0, int n_threads=1);
+
+int parse_ints     (const char* data, size_t size, const IntSink* sink, int n_threads=1);
+int parse_file_ints(const char* filename,         const IntSink* sink, int n_threads=1);
+
+int  text_stream_open (TextStream* stream, const char* filename, int skip_empty_strings=0, int skip_first_last_spaces=0);
+int  text_stream_next (TextStream* stream);
+void text_stream_close(TextStream* stream);
 
 int    write_text_to_file(const char* filename, const char mode[], const Text* data, const char* text_sep="\n", const char* text_end="\n");
 int  write_buffer_to_file(const char* filename, const char mode[], const Text* data, const char*  buf_sep="\n", const char*  buf_end="\n");
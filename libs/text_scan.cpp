@@ -0,0 +1,566 @@
+#include <cstdint>
+#include <climits>
+#include <cstring>
+#include <pthread.h>
+
+#if defined(__x86_64__)
+    #include <immintrin.h>
+    #define TEXT_SCAN_X86 1
+#else
+    #define TEXT_SCAN_X86 0
+#endif
+
+#include "text_scan.h"
+
+struct TextScanKernel {
+    const char* name;
+
+    const char* (*find_byte)   (const char* begin, const char* end, char byte);
+    size_t      (*count_byte)  (const char* begin, const char* end, char byte);
+    size_t      (*replace_byte)(char* begin, char* end, char old_byte, char new_byte, size_t limit);
+    const char* (*skip_spaces) (const char* begin, const char* end);
+    const char* (*trim_spaces) (const char* begin, const char* end);
+    void        (*block_masks) (const char* block, char byte, uint64_t* byte_mask, uint64_t* space_mask);
+    size_t      (*parse_ints)  (const char* begin, const char* end, int* values, size_t max_values, const char** stop);
+};
+
+//! Function checks, if symbol is space (like isspace in "C" locale)
+//! \param symbol symbol
+//! \return       1 if symbol is space, else 0
+static inline int is_space(char symbol) {
+    return symbol == ' ' || (unsigned char)(symbol - '\t') <= '\r' - '\t';
+}
+
+//! Function makes int from sign and absolute value
+//! \param negative flag of '-' sign
+//! \param number   absolute value
+//! \param value    ptr to result
+//! \return         1 if number fits int, else 0
+static inline int make_int(int negative, uint64_t number, int* value) {
+    if (number > (uint64_t)INT_MAX + (uint64_t)negative) return 0;
+
+    *value = (int)(negative ? -(int64_t)number : (int64_t)number);
+    return 1;
+}
+
+// Scalar kernel---------------------------------------------------------------
+static const char* find_byte_scalar(const char* begin, const char* end, char byte) {
+    while (begin < end && *begin != byte) begin++;
+    return begin;
+}
+
+static size_t count_byte_scalar(const char* begin, const char* end, char byte) {
+    size_t count = 0;
+    for ( ; begin < end; begin++) {
+        count += *begin == byte;
+    }
+    return count;
+}
+
+static size_t replace_byte_scalar(char* begin, char* end, char old_byte, char new_byte, size_t limit) {
+    size_t count = 0;
+    for ( ; begin < end && count < limit; begin++) {
+        if (*begin == old_byte) {
+            *begin = new_byte;
+            count++;
+        }
+    }
+    return count;
+}
+
+static const char* skip_spaces_scalar(const char* begin, const char* end) {
+    while (begin < end && is_space(*begin)) begin++;
+    return begin;
+}
+
+static const char* trim_spaces_scalar(const char* begin, const char* end) {
+    while (end > begin && is_space(end[-1])) end--;
+    return end;
+}
+
+static void block_masks_scalar(const char* block, char byte, uint64_t* byte_mask, uint64_t* space_mask) {
+    uint64_t bytes = 0, spaces = 0;
+    for (int i = 0; i < TEXT_SCAN_BLOCK; i++) {
+        bytes  |= (uint64_t)(block[i] == byte)      << i;
+        spaces |= (uint64_t)is_space(block[i])      << i;
+    }
+
+    *byte_mask  = bytes;
+    *space_mask = spaces;
+}
+
+//! Function parses one number (optional sign and digits, which are followed by space or end)
+//! \param ptr   ptr to ptr to beginning of number (it is moved after number)
+//! \param end   ptr to end of buffer
+//! \param value ptr to result
+//! \return      1 if success, else 0 (ptr isn`t moved)
+static int parse_int_scalar(const char** ptr, const char* end, int* value) {
+    const char* cur = *ptr;
+
+    int negative = *cur == '-';
+    if (negative || *cur == '+') cur++;
+
+    const char* digits = cur;
+    uint64_t    number = 0;
+    for ( ; cur < end && (unsigned char)(*cur - '0') <= 9; cur++) {
+        number = number * 10 + (uint64_t)(*cur - '0');
+        if (number > (uint64_t)INT_MAX + 1) return 0;
+    }
+
+    if (cur == digits || (cur < end && !is_space(*cur)) || !make_int(negative, number, value)) return 0;
+
+    *ptr = cur;
+    return 1;
+}
+
+static size_t parse_ints_scalar(const char* begin, const char* end, int* values, size_t max_values, const char** stop) {
+    size_t n_values = 0;
+    for ( ; n_values < max_values; n_values++) {
+        begin = skip_spaces_scalar(begin, end);
+        if (begin == end || !parse_int_scalar(&begin, end, &values[n_values])) break;
+    }
+
+    *stop = begin;
+    return n_values;
+}
+// ----------------------------------------------------------------------------
+
+// SWAR helpers (8 digits in uint64_t, first digit in low byte)-----------------
+const uint64_t SWAR_ONES = 0x0101010101010101ULL;
+
+//! Function counts digits at beginning of 8 bytes
+//! \param chunk 8 bytes
+//! \return      number of first bytes, which are digits
+static inline int digits_swar(uint64_t chunk) {
+    // Byte is digit, if its high half is 3 and (byte + 6) has high half 3 too
+    uint64_t not_digits = ((chunk & 0xF0 * SWAR_ONES) | (((chunk + 0x06 * SWAR_ONES) & 0xF0 * SWAR_ONES) >> 4)) ^ 0x33 * SWAR_ONES;
+    uint64_t high_bits  = (((not_digits & 0x7F * SWAR_ONES) + 0x7F * SWAR_ONES) | not_digits) & 0x80 * SWAR_ONES;
+
+    return high_bits == 0 ? 8 : __builtin_ctzll(high_bits) / 8;
+}
+
+//! Function converts first n_digits digits of 8 bytes to number
+//! \param chunk    8 bytes
+//! \param n_digits number of digits (1..8)
+//! \return         number
+static inline uint64_t value_swar(uint64_t chunk, int n_digits) {
+    chunk = (chunk & 0x0F * SWAR_ONES) << (8 * (8 - n_digits));     // Leading zeros in place of missed digits
+
+    chunk = (chunk * 10    + (chunk >> 8))  & 0x00FF00FF00FF00FFULL;
+    chunk = (chunk * 100   + (chunk >> 16)) & 0x0000FFFF0000FFFFULL;
+    chunk = (chunk * 10000 + (chunk >> 32)) & 0x00000000FFFFFFFFULL;
+
+    return chunk;
+}
+
+static inline uint64_t load_swar(const char* ptr) {
+    uint64_t chunk = 0;
+    memcpy(&chunk, ptr, sizeof(chunk));
+
+    return chunk;
+}
+// ----------------------------------------------------------------------------
+
+#if TEXT_SCAN_X86
+// SSE2 kernel (SSE2 is in every x86-64 CPU)-----------------------------------
+//! Function makes mask of space symbols in 16 bytes
+static inline unsigned spaces_mask_sse2(__m128i block) {
+    __m128i is_blank = _mm_cmpeq_epi8(block, _mm_set1_epi8(' '));
+    __m128i shifted  = _mm_sub_epi8(block, _mm_set1_epi8('\t'));
+    __m128i is_ctrl  = _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8('\r' - '\t')), shifted);
+
+    return (unsigned)_mm_movemask_epi8(_mm_or_si128(is_blank, is_ctrl));
+}
+
+static inline __m128i load_sse2(const char* ptr) {
+    return _mm_loadu_si128((const __m128i*)(const void*)ptr);
+}
+
+static const char* find_byte_sse2(const char* begin, const char* end, char byte) {
+    __m128i pattern = _mm_set1_epi8(byte);
+
+    for ( ; end - begin >= 16; begin += 16) {
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(load_sse2(begin), pattern));
+        if (mask != 0) return begin + __builtin_ctz(mask);
+    }
+    return find_byte_scalar(begin, end, byte);
+}
+
+static size_t count_byte_sse2(const char* begin, const char* end, char byte) {
+    __m128i pattern = _mm_set1_epi8(byte);
+
+    size_t count = 0;
+    for ( ; end - begin >= 16; begin += 16) {
+        count += (size_t)__builtin_popcount((unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(load_sse2(begin), pattern)));
+    }
+    return count + count_byte_scalar(begin, end, byte);
+}
+
+static size_t replace_byte_sse2(char* begin, char* end, char old_byte, char new_byte, size_t limit) {
+    __m128i pattern     = _mm_set1_epi8(old_byte);
+    __m128i replacement = _mm_set1_epi8(new_byte);
+
+    size_t count = 0;
+    for ( ; end - begin >= 16; begin += 16) {
+        __m128i  block = load_sse2(begin);
+        __m128i  found = _mm_cmpeq_epi8(block, pattern);
+        unsigned mask  = (unsigned)_mm_movemask_epi8(found);
+        if (mask == 0) continue;
+
+        size_t n_found = (size_t)__builtin_popcount(mask);
+        if (count + n_found > limit) break;     // Rest is replaced one by one till limit
+
+        block = _mm_or_si128(_mm_andnot_si128(found, block), _mm_and_si128(found, replacement));
+        _mm_storeu_si128((__m128i*)(void*)begin, block);
+        count += n_found;
+    }
+    return count + replace_byte_scalar(begin, end, old_byte, new_byte, limit - count);
+}
+
+static const char* skip_spaces_sse2(const char* begin, const char* end) {
+    for ( ; end - begin >= 16; begin += 16) {
+        unsigned mask = ~spaces_mask_sse2(load_sse2(begin)) & 0xFFFFu;
+        if (mask != 0) return begin + __builtin_ctz(mask);
+    }
+    return skip_spaces_scalar(begin, end);
+}
+
+static const char* trim_spaces_sse2(const char* begin, const char* end) {
+    for ( ; end - begin >= 16; end -= 16) {
+        unsigned mask = ~spaces_mask_sse2(load_sse2(end - 16)) & 0xFFFFu;
+        if (mask != 0) return end - 16 + (32 - __builtin_clz(mask));
+    }
+    return trim_spaces_scalar(begin, end);
+}
+
+static void block_masks_sse2(const char* block, char byte, uint64_t* byte_mask, uint64_t* space_mask) {
+    __m128i pattern = _mm_set1_epi8(byte);
+
+    uint64_t bytes = 0, spaces = 0;
+    for (int i = 0; i < TEXT_SCAN_BLOCK; i += 16) {
+        __m128i part = load_sse2(block + i);
+
+        bytes  |= (uint64_t)(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(part, pattern)) << i;
+        spaces |= (uint64_t)spaces_mask_sse2(part) << i;
+    }
+
+    *byte_mask  = bytes;
+    *space_mask = spaces;
+}
+
+//! Function parses one number by 8 digits at once (see parse_int_scalar)
+static int parse_int_sse2(const char** ptr, const char* end, int* value) {
+    const char* cur = *ptr;
+
+    int negative = *cur == '-';
+    if (negative || *cur == '+') cur++;
+
+    if (end - cur < 16) return parse_int_scalar(ptr, end, value);
+
+    int n_digits = digits_swar(load_swar(cur));
+    if (n_digits == 0) return 0;
+
+    uint64_t number = value_swar(load_swar(cur), n_digits);
+    if (n_digits == 8) {
+        int n_second = digits_swar(load_swar(cur + 8));
+        if (n_second == 8) return parse_int_scalar(ptr, end, value);    // Long number (with leading zeros)
+
+        for (int i = 0; i < n_second; i++) number *= 10;
+        if (n_second > 0) number += value_swar(load_swar(cur + 8), n_second);
+        n_digits += n_second;
+    }
+
+    cur += n_digits;
+    if (!is_space(*cur) || !make_int(negative, number, value)) return 0;
+
+    *ptr = cur;
+    return 1;
+}
+
+static size_t parse_ints_sse2(const char* begin, const char* end, int* values, size_t max_values, const char** stop) {
+    size_t n_values = 0;
+    for ( ; n_values < max_values; n_values++) {
+        begin = skip_spaces_scalar(begin, end);     // Numbers are usually divided by one symbol
+        if (begin == end || !parse_int_sse2(&begin, end, &values[n_values])) break;
+    }
+
+    *stop = begin;
+    return n_values;
+}
+// ----------------------------------------------------------------------------
+
+// AVX2 kernel-----------------------------------------------------------------
+#define TEXT_SCAN_AVX2_FUNC __attribute__((target("avx2")))
+
+TEXT_SCAN_AVX2_FUNC static inline unsigned spaces_mask_avx2(__m256i block) {
+    __m256i is_blank = _mm256_cmpeq_epi8(block, _mm256_set1_epi8(' '));
+    __m256i shifted  = _mm256_sub_epi8(block, _mm256_set1_epi8('\t'));
+    __m256i is_ctrl  = _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, _mm256_set1_epi8('\r' - '\t')), shifted);
+
+    return (unsigned)_mm256_movemask_epi8(_mm256_or_si256(is_blank, is_ctrl));
+}
+
+TEXT_SCAN_AVX2_FUNC static inline __m256i load_avx2(const char* ptr) {
+    return _mm256_loadu_si256((const __m256i*)(const void*)ptr);
+}
+
+TEXT_SCAN_AVX2_FUNC static const char* find_byte_avx2(const char* begin, const char* end, char byte) {
+    __m256i pattern = _mm256_set1_epi8(byte);
+
+    for ( ; end - begin >= 32; begin += 32) {
+        unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(load_avx2(begin), pattern));
+        if (mask != 0) return begin + __builtin_ctz(mask);
+    }
+    return find_byte_sse2(begin, end, byte);
+}
+
+TEXT_SCAN_AVX2_FUNC static size_t count_byte_avx2(const char* begin, const char* end, char byte) {
+    __m256i pattern = _mm256_set1_epi8(byte);
+
+    size_t count = 0;
+    for ( ; end - begin >= 32; begin += 32) {
+        count += (size_t)__builtin_popcount((unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(load_avx2(begin), pattern)));
+    }
+    return count + count_byte_sse2(begin, end, byte);
+}
+
+TEXT_SCAN_AVX2_FUNC static size_t replace_byte_avx2(char* begin, char* end, char old_byte, char new_byte, size_t limit) {
+    __m256i pattern     = _mm256_set1_epi8(old_byte);
+    __m256i replacement = _mm256_set1_epi8(new_byte);
+
+    size_t count = 0;
+    for ( ; end - begin >= 32; begin += 32) {
+        __m256i  block = load_avx2(begin);
+        __m256i  found = _mm256_cmpeq_epi8(block, pattern);
+        unsigned mask  = (unsigned)_mm256_movemask_epi8(found);
+        if (mask == 0) continue;
+
+        size_t n_found = (size_t)__builtin_popcount(mask);
+        if (count + n_found > limit) break;
+
+        _mm256_storeu_si256((__m256i*)(void*)begin, _mm256_blendv_epi8(block, replacement, found));
+        count += n_found;
+    }
+    return count + replace_byte_sse2(begin, end, old_byte, new_byte, limit - count);
+}
+
+TEXT_SCAN_AVX2_FUNC static const char* skip_spaces_avx2(const char* begin, const char* end) {
+    for ( ; end - begin >= 32; begin += 32) {
+        unsigned mask = ~spaces_mask_avx2(load_avx2(begin));
+        if (mask != 0) return begin + __builtin_ctz(mask);
+    }
+    return skip_spaces_sse2(begin, end);
+}
+
+TEXT_SCAN_AVX2_FUNC static const char* trim_spaces_avx2(const char* begin, const char* end) {
+    for ( ; end - begin >= 32; end -= 32) {
+        unsigned mask = ~spaces_mask_avx2(load_avx2(end - 32));
+        if (mask != 0) return end - 32 + (32 - __builtin_clz(mask));
+    }
+    return trim_spaces_sse2(begin, end);
+}
+
+TEXT_SCAN_AVX2_FUNC static void block_masks_avx2(const char* block, char byte, uint64_t* byte_mask, uint64_t* space_mask) {
+    __m256i pattern = _mm256_set1_epi8(byte);
+    __m256i low     = load_avx2(block);
+    __m256i high    = load_avx2(block + 32);
+
+    *byte_mask  = (uint64_t)(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(low,  pattern)) |
+                  (uint64_t)(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, pattern)) << 32;
+    *space_mask = (uint64_t)spaces_mask_avx2(low) | (uint64_t)spaces_mask_avx2(high) << 32;
+}
+
+//! Function parses one number by 16 digits at once (see parse_int_scalar): digits are moved to end
+//! of 16 bytes and are multiplied by 10, 100, 10000 in pairs (AVX2 CPUs have SSSE3 and SSE4.1)
+TEXT_SCAN_AVX2_FUNC static int parse_int_avx2(const char** ptr, const char* end, int* value) {
+    const char* cur = *ptr;
+
+    int negative = *cur == '-';
+    if (negative || *cur == '+') cur++;
+
+    if (end - cur < 16) return parse_int_scalar(ptr, end, value);
+
+    __m128i  digits   = _mm_sub_epi8(load_sse2(cur), _mm_set1_epi8('0'));
+    unsigned is_digit = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(digits, _mm_set1_epi8(9)), digits));
+
+    int n_digits = __builtin_ctz(~is_digit);
+    if (n_digits == 0)  return 0;
+    if (n_digits == 16) return parse_int_scalar(ptr, end, value);     // Long number (with leading zeros)
+
+    // Index i - (16 - n_digits) is negative for leading bytes, so shuffle makes them zeros
+    __m128i shift   = _mm_add_epi8(_mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+                                   _mm_set1_epi8((char)(n_digits - 16)));
+    __m128i aligned = _mm_shuffle_epi8(digits, shift);
+
+    __m128i pairs   = _mm_maddubs_epi16(aligned, _mm_set1_epi16(0x010A));        // d0 * 10 + d1
+    __m128i quads   = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00010064));         // p0 * 100 + p1
+    __m128i packed  = _mm_packus_epi32(quads, quads);
+    __m128i octets  = _mm_madd_epi16(packed, _mm_set1_epi32(0x00012710));        // q0 * 10000 + q1
+
+    uint64_t number = (uint64_t)(uint32_t)_mm_cvtsi128_si32(octets) * 100000000 +
+                      (uint64_t)(uint32_t)_mm_extract_epi32(octets, 1);
+
+    cur += n_digits;
+    if (!is_space(*cur) || !make_int(negative, number, value)) return 0;
+
+    *ptr = cur;
+    return 1;
+}
+
+TEXT_SCAN_AVX2_FUNC static size_t parse_ints_avx2(const char* begin, const char* end, int* values, size_t max_values, const char** stop) {
+    size_t n_values = 0;
+    for ( ; n_values < max_values; n_values++) {
+        begin = skip_spaces_scalar(begin, end);
+        if (begin == end || !parse_int_avx2(&begin, end, &values[n_values])) break;
+    }
+
+    *stop = begin;
+    return n_values;
+}
+// ----------------------------------------------------------------------------
+#endif // TEXT_SCAN_X86
+
+static const TextScanKernel TEXT_SCAN_KERNELS[] = {
+    { "scalar", find_byte_scalar, count_byte_scalar, replace_byte_scalar, skip_spaces_scalar, trim_spaces_scalar, block_masks_scalar, parse_ints_scalar },
+#if TEXT_SCAN_X86
+    { "sse2",   find_byte_sse2,   count_byte_sse2,   replace_byte_sse2,   skip_spaces_sse2,   trim_spaces_sse2,   block_masks_sse2,   parse_ints_sse2   },
+    { "avx2",   find_byte_avx2,   count_byte_avx2,   replace_byte_avx2,   skip_spaces_avx2,   trim_spaces_avx2,   block_masks_avx2,   parse_ints_avx2   },
+#endif
+};
+
+static const TextScanKernel* scan_kernel = NULL;
+static pthread_once_t        scan_once   = PTHREAD_ONCE_INIT;
+
+//! Function chooses the best kernel, which CPU supports (called once by first scan)
+static void choose_kernel() {
+    if (scan_kernel == NULL) text_scan_use(TEXT_SCAN_AUTO);
+}
+
+//! Function gets kernel, which is used now
+//! \return ptr to TextScanKernel object
+static inline const TextScanKernel* kernel() {
+    pthread_once(&scan_once, choose_kernel);
+    return scan_kernel;
+}
+
+//! Function sets kernel for all scans (kernels, which CPU doesn`t support, are replaced by best supported)
+//! \param kernel kernel from text_scan_kernels
+//! \return       used kernel
+int text_scan_use(int kernel) {
+    int best = TEXT_SCAN_SCALAR;
+#if TEXT_SCAN_X86
+    __builtin_cpu_init();
+    best = __builtin_cpu_supports("avx2") ? TEXT_SCAN_AVX2 : TEXT_SCAN_SSE2;
+#endif
+
+    if (kernel == TEXT_SCAN_AUTO || kernel > best || kernel < TEXT_SCAN_SCALAR) kernel = best;
+
+    scan_kernel = &TEXT_SCAN_KERNELS[kernel];
+    return kernel;
+}
+
+//! Function gets name of used kernel
+//! \return "scalar", "sse2" or "avx2"
+const char* text_scan_kernel_name() {
+    return kernel()->name;
+}
+
+//! Function finds first byte in buffer
+//! \param begin ptr to beginning of buffer
+//! \param end   ptr to end of buffer
+//! \param byte  searched byte
+//! \return      ptr to found byte (end if there is no byte)
+const char* scan_find_byte(const char* begin, const char* end, char byte) {
+    return kernel()->find_byte(begin, end, byte);
+}
+
+//! Function counts byte in buffer
+//! \param begin ptr to beginning of buffer
+//! \param end   ptr to end of buffer
+//! \param byte  counted byte
+//! \return      number of bytes
+size_t scan_count_byte(const char* begin, const char* end, char byte) {
+    return kernel()->count_byte(begin, end, byte);
+}
+
+//! Function replaces first limit old bytes in buffer by new byte
+//! \param begin    ptr to beginning of buffer
+//! \param end      ptr to end of buffer
+//! \param old_byte replaced byte
+//! \param new_byte new byte
+//! \param limit    maximum number of replacements (SIZE_MAX to replace all)
+//! \return         number of replacements
+size_t scan_replace_byte(char* begin, char* end, char old_byte, char new_byte, size_t limit) {
+    return kernel()->replace_byte(begin, end, old_byte, new_byte, limit);
+}
+
+//! Function skips spaces at beginning of buffer
+//! \param begin ptr to beginning of buffer
+//! \param end   ptr to end of buffer
+//! \return      ptr to first not space symbol (end if there is no one)
+const char* scan_skip_spaces(const char* begin, const char* end) {
+    return kernel()->skip_spaces(begin, end);
+}
+
+//! Function skips spaces at end of buffer
+//! \param begin ptr to beginning of buffer
+//! \param end   ptr to end of buffer
+//! \return      ptr after last not space symbol (begin if there is no one)
+const char* scan_trim_spaces(const char* begin, const char* end) {
+    return kernel()->trim_spaces(begin, end);
+}
+
+//! Function makes masks of TEXT_SCAN_BLOCK bytes: bit i is set, if block[i] is byte (or space)
+//! \param block      ptr to block (TEXT_SCAN_BLOCK bytes)
+//! \param byte       searched byte
+//! \param byte_mask  ptr to mask of byte
+//! \param space_mask ptr to mask of spaces
+void scan_block_masks(const char* block, char byte, uint64_t* byte_mask, uint64_t* space_mask) {
+    kernel()->block_masks(block, byte, byte_mask, space_mask);
+}
+
+//! Function counts words (parts of buffer between spaces)
+//! \param begin ptr to beginning of buffer (word, which is started at it, is counted)
+//! \param end   ptr to end of buffer
+//! \return      number of words
+size_t scan_count_words(const char* begin, const char* end) {
+    const TextScanKernel* scan = kernel();
+
+    size_t   count      = 0;
+    uint64_t prev_space = 1;
+    for ( ; end - begin >= TEXT_SCAN_BLOCK; begin += TEXT_SCAN_BLOCK) {
+        uint64_t bytes = 0, spaces = 0;
+        scan->block_masks(begin, ' ', &bytes, &spaces);
+
+        count     += (size_t)__builtin_popcountll(~spaces & (spaces << 1 | prev_space));
+        prev_space = spaces >> 63;
+    }
+
+    for ( ; begin < end; begin++) {
+        count     += prev_space && !is_space(*begin);
+        prev_space = is_space(*begin);
+    }
+
+    return count;
+}
+
+//! Function finds first space in buffer (it is used for short searches, so it checks bytes one by one)
+//! \param begin ptr to beginning of buffer
+//! \param end   ptr to end of buffer
+//! \return      ptr to found space (end if there is no one)
+const char* scan_find_space(const char* begin, const char* end) {
+    while (begin < end && !is_space(*begin)) begin++;
+    return begin;
+}
+
+//! Function parses decimal int numbers, which are divided by spaces (like "12 -7\n+5")
+//! \param begin      ptr to beginning of buffer
+//! \param end        ptr to end of buffer
+//! \param values     ptr to array for numbers
+//! \param max_values size of values array
+//! \param stop       ptr to ptr, where parsing was stopped (end or wrong number, if less than
+//!                   max_values numbers are parsed and buffer has not only spaces after stop)
+//! \return           number of parsed numbers
+size_t scan_parse_ints(const char* begin, const char* end, int* values, size_t max_values, const char** stop) {
+    return kernel()->parse_ints(begin, end, values, max_values, stop);
+}
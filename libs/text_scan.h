@@ -0,0 +1,38 @@
+#ifndef TEXT_SCAN_H
+#define TEXT_SCAN_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Text scanning kernels-------------------------------------------------------
+// Searching of delimiters and spaces in big buffers. Kernels check 32 (AVX2) or 16 (SSE2) bytes
+// at once, kernel is chosen by CPU on first call. Spaces are ' ', '\t', '\n', '\v', '\f', '\r'
+// (like isspace in "C" locale).
+
+enum text_scan_kernels {
+    TEXT_SCAN_AUTO   = -1,  // The best kernel, which CPU supports
+    TEXT_SCAN_SCALAR =  0,  // Byte by byte
+    TEXT_SCAN_SSE2   =  1,
+    TEXT_SCAN_AVX2   =  2
+};
+
+int         text_scan_use(int kernel);
+const char* text_scan_kernel_name();
+
+const char* scan_find_byte  (const char* begin, const char* end, char byte);
+size_t      scan_count_byte (const char* begin, const char* end, char byte);
+size_t      scan_replace_byte(char* begin, char* end, char old_byte, char new_byte, size_t limit);
+
+const char* scan_skip_spaces(const char* begin, const char* end);
+const char* scan_trim_spaces(const char* begin, const char* end);
+
+const int TEXT_SCAN_BLOCK = 64;     // Size of block for scan_block_masks
+
+void scan_block_masks(const char* block, char byte, uint64_t* byte_mask, uint64_t* space_mask);
+
+size_t      scan_count_words(const char* begin, const char* end);
+const char* scan_find_space (const char* begin, const char* end);
+size_t      scan_parse_ints (const char* begin, const char* end, int* values, size_t max_values, const char** stop);
+// ----------------------------------------------------------------------------
+
+#endif // TEXT_SCAN_H
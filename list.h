@@ -5,35 +5,364 @@
 #ifndef LIST_LISTH
 #define LIST_LISTH
 
+#include "config.h"
+
+#include <cstdio>
+#include <cstring>
+#include <climits>
+#include <pthread.h>
+#include <type_traits>
+
+#include "libs/baselib.h"
+#include "libs/file_funcs.h"
+#include "libs/dot_pool.h"
+
 const int BUFFER_DEFAULT_SIZE = 10;
-const int MAX_NODE_STR_SIZE   = 300;
+const int MAX_VALUE_STR_SIZE  = 64;
+const int LIST_FINGERS        = 4;
+const int LIST_CHUNK_BITS     = 12;
+const int LIST_NEAR_CELLS     = 8;
+const int LIST_CELL_WRITES    = 8;      // Max cells, which push or pop of one element (or compaction step) changes
+const int LIST_DUMP_CONTEXT   = 2;      // Cells around head and tail, which list_dump_window shows
+
+const int UNCHECKED_VALIDATE  = -1;     // List level without any checks (see ListValidation)
+
+const int CONCURRENT_MAX_CHUNKS = 1 << 15;  // Chunk table of ConcurrentList has fixed size, so cells never move
+const int CONCURRENT_SHARDS     = 64;       // Free cells lists of ConcurrentList
+const int CONCURRENT_SPINS      = 64;       // Failed lock attempts before thread yields CPU
+
+const int SHARDED_AUTO       = 0;           // Number of shards is number of CPUs
+const int SHARDED_MAX_SHARDS = 256;
+
+const int JOURNAL_BUFFER_SIZE = 1 << 16;    // Records, which are collected before one write call
+const int JOURNAL_BATCH       = 256;        // Max number of pushes or pops, which replay applies by one bulk call
 
 typedef int List_t;
 
+// Value traits----------------------------------------------------------------
+//! Describes how List handles values of type T. Chosen at compile time:
+//! types without poison values are checked only by links (free cell has prev == UNINITIALIZED_INT)
+template <typename T>
+struct ListValueTraits {
+    static const bool HAS_POISON = false;
+
+    static T uninit()             { T value = { }; return value; }
+    static T freed()              { T value = { }; return value; }
+    static T from_error(int)      { T value = { }; return value; }
+
+    static bool equal(const T& first, const T& second) { return memcmp(&first, &second, sizeof(T)) == 0; }
+
+    static int format(char* buf, size_t size, const T& value) {
+        const unsigned char* bytes = (const unsigned char*)&value;
+
+        int written = 0;
+        for (size_t i = 0; i < sizeof(T) && (size_t)written + 3 <= size; i++) {
+            written += snprintf(buf + written, size - (size_t)written, "%02x", bytes[i]);
+        }
+
+        return written;
+    }
+};
+
+template <>
+struct ListValueTraits<int> {
+    static const bool HAS_POISON = true;
+
+    static int uninit()                 { return poisons::UNINITIALIZED_INT; }
+    static int freed()                  { return poisons::FREED_ELEMENT; }
+    static int from_error(int error)    { return error; }
+
+    static bool equal(int first, int second) { return first == second; }
+
+    static int format(char* buf, size_t size, const int& value) {
+        if (size >= (size_t)INT_STR_SIZE) return format_int(buf, value);
+        return snprintf(buf, size, "%d", value);
+    }
+};
+// ----------------------------------------------------------------------------
+
+// Validation policies---------------------------------------------------------
+//! Validation level of one List type. It is chosen at compile time, so lists with different
+//! levels can live in one program: ASSERT_OK and checks of arguments use LEVEL instead of VALIDATE_LEVEL
+template <int level>
+struct ListValidation {
+    static const int LEVEL = level;
+};
+
+typedef ListValidation<UNCHECKED_VALIDATE> UncheckedValidation;    // No checks: bare index manipulation
+typedef ListValidation<VALIDATE_LEVEL>     CheckedValidation;      // Level from config.h
+typedef ListValidation<HIGHEST_VALIDATE>   DebugValidation;        // All checks, dumps and logs
+// ----------------------------------------------------------------------------
+
 // List structure--------------------------------------------------------------
+template <typename T>
 struct ListElement {
-    List_t value;
-    int    next;
-    int    prev;
+    T   value;
+    int next;
+    int prev;
+};
+
+#include "list_storage.h"
+
+//! Optional index for logical -> physical lookups on unsorted list (see list_rank.h)
+struct ListRankIndex {
+    int* block_of    = NULL;    // Block of each cell
+    int* block_first = NULL;    // First cell of each block
+    int* block_size  = NULL;    // Number of elements in each block
+    int* order       = NULL;    // Blocks in logical order
+
+    int n_blocks    = 0;        // Number of blocks in order
+    int n_ids       = 0;        // Number of used block ids (ids of removed blocks are not reused till rebuild)
+    int block_limit = 0;        // Block is split, when it becomes bigger than 2 * block_limit
+    int max_ids     = 0;        // Number of entries in block_first, block_size and order
+    int size        = 0;        // Number of elements in list
+};
+
+//! Optional bitmap of free cells for locality-preserving allocation (see list_free_map.h)
+struct ListFreeMap {
+    unsigned long long* bits = NULL;    // Bit i is set, if cell i is free
+    int n_words = 0;
 };
 
+//! Cells [from, to), which are written by dump
+struct ListDumpRange {
+    int from;
+    int to;
+};
+
+//! Header of list snapshot file. Cells (array of ListElement) follow it (see list_snapshot.h)
+struct ListFileHeader {
+    char signature[8];
+
+    int version;
+    int header_size;        // Offset of cells from file beginning
+    int element_size;       // sizeof(ListElement<T>)
+    int value_size;         // sizeof(T)
+
+    int capacity;
+    int head;
+    int tail;
+    int size;
+    int first_free;
+    int is_sorted;
+    int sorted_prefix;
+
+    int flags;              // See list_file_flags
+    int checkpoint;         // Number of checkpoint, which saved file (see list_journal.h)
+    int reserved[1];
+};
+
+//! Header of list journal file. Records (array of ListJournalRecord) follow it (see list_journal.h)
+struct ListJournalHeader {
+    char signature[8];
+
+    int version;
+    int header_size;        // Offset of records from file beginning
+    int record_size;        // sizeof(ListJournalRecord<T>)
+    int value_size;         // sizeof(T)
+    int checkpoint;         // Records are changes of snapshot file with the same checkpoint
+
+    int reserved[9];
+};
+
+//! One change of list in journal
+template <typename T>
+struct ListJournalRecord {
+    int op;                 // See journal_ops (0 - end of records)
+    int arg;                // ph_index of push and pop, capacity of resize, budget of compaction, flag of free map
+    int result;             // Physical index of pushed element (replay checks it)
+    T   value;              // Pushed or popped value
+};
+
+//! Append-only journal of list changes (see list_journal.h): records are collected in buffer and
+//! are written by one write call (group commit)
+struct ListJournal {
+    int fd          = -1;
+    int sync        =  0;   // See journal_sync_modes
+    int record_size =  0;
+    int error       =  0;   // errno of first failed write (records after it are lost till checkpoint)
+
+    char*  buffer      = NULL;
+    size_t buffer_size = 0;
+    size_t used        = 0;
+
+    char image_name[FILENAME_MAX] = "";     // Snapshot file, which list_checkpoint writes
+};
+
+//! Remembered pair of logical and physical indexes of element (see list_finger.h)
+struct ListFinger {
+    int log_index;
+    int ph_index;
+};
+
+//! Cell of ConcurrentList: links of cell are changed only while its lock is taken
+template <typename T>
+struct ConcurrentCell {
+    T   value;
+    int next;
+    int prev;
+    int lock;   // 1 while cell is locked
+};
+
+//! Free cells chain of some threads (thread always takes cells from its shard first)
+struct alignas(64) ConcurrentFreeShard {
+    int lock;
+    int first_free;
+    int size;   // Taken cells minus released cells (size of list is sum of shards)
+};
+
+//! List for several threads (see list_concurrent.h): push and pop lock only changed cell and its
+//! neighbours, free cells are taken from shards instead of one first_free. Head and tail are links of cell 0
+template <typename T = List_t>
+struct ConcurrentList {
+    static_assert(std::is_trivially_copyable<T>::value, "List stores values inline, so T should be trivially copyable");
+
+    ConcurrentCell<T>**  chunks   = NULL;  // CONCURRENT_MAX_CHUNKS ptrs to chunks of (1 << LIST_CHUNK_BITS) cells
+    int                  n_chunks = 0;
+    ConcurrentFreeShard* shards   = NULL;  // CONCURRENT_SHARDS shards
+
+    pthread_mutex_t grow_mutex = PTHREAD_MUTEX_INITIALIZER;
+};
+
+//! Bounded work queue (see list_queue.h): producers push_back, one consumer pop_front. Cells are ring of
+//! ListElement: next links ring, prev is turn of cell (position, at which cell can be pushed or popped)
+template <typename T = List_t>
+struct ListQueue {
+    static_assert(std::is_trivially_copyable<T>::value, "List stores values inline, so T should be trivially copyable");
+
+    ListElement<T>* cells     = NULL;
+    int             capacity  = 0;      // Power of 2 (>= 2)
+    int             producers = 0;      // See queue_producers
+
+    alignas(64) unsigned tail = 0;      // Position of next push (changed only by producers)
+    alignas(64) unsigned head = 0;      // Position of next pop  (changed only by consumer)
+};
+
+template <typename T = List_t, template <typename> class Storage = AosStorage, typename Validation = CheckedValidation>
 struct List {
-    ListElement* data = NULL;
+    static_assert(std::is_trivially_copyable<T>::value, "List stores values inline, so T should be trivially copyable");
+
+    typedef T          value_type;
+    typedef Storage<T> storage_type;
+    typedef Validation validation_type;
+
+    Storage<T> data = { };
 
     int head = -1;
     int tail = -1;
 
     int capacity   = -1;
+    int size       = -1;
 
     int is_sorted  = -1;
     int first_free = -1;
+
+    int sorted_prefix  = -1;    // Number of first logical elements, which lie in cells head, head + 1, ...
+    ListRankIndex rank = { };   // Turned on by list_rank_enable
+    ListFreeMap free_map = { }; // Turned on by list_free_map_enable
+
+    ListFinger fingers[LIST_FINGERS] = { };
+    int        next_finger = 0;
+
+    int compact_budget =  0;    // Number of cells list_compact_step checks after each push/pop (0 - no compaction).
+                                // !Note! compaction moves cells, so physical indexes of elements can change. It turns on free map
+
+    ListJournal* journal    = NULL; // Turned on by list_journal_open
+    int          checkpoint = 0;    // Number of last checkpoint (it is saved to snapshot file)
+};
+
+//! Immutable view of List with CowStorage, which was taken by snapshot_take (see list_cow.h).
+//! Snapshot shares chunks with list, list copies chunk before its first change after snapshot
+template <typename T>
+struct ListSnapshot {
+    CowChunk<T>** chunks   = NULL;  // Own chunk table (list can grow after snapshot)
+    int           n_chunks = 0;
+
+    int head          = -1;
+    int tail          = -1;
+    int capacity      = -1;
+    int size          = -1;
+    int is_sorted     = -1;
+    int sorted_prefix = -1;
+
+    const T& value(int index) const { return chunks[index >> LIST_CHUNK_BITS]->cells[index & ((1 << LIST_CHUNK_BITS) - 1)].value; }
+    int       next(int index) const { return chunks[index >> LIST_CHUNK_BITS]->cells[index & ((1 << LIST_CHUNK_BITS) - 1)].next;  }
+    int       prev(int index) const { return chunks[index >> LIST_CHUNK_BITS]->cells[index & ((1 << LIST_CHUNK_BITS) - 1)].prev;  }
+};
+
+//! Shard of ShardedList: list and lock of it (shard is locked only by threads, which got the same shard).
+//! ShardedList checks arguments once by its Validation, so shard list is unchecked: list_error of
+//! each push_back costed more, than push_back itself
+template <typename T, template <typename> class Storage, typename Validation>
+struct alignas(64) ListShard {
+    List<T, Storage, UncheckedValidation> list = { };
+    int lock = 0;
+};
+
+//! Independent lists, one per thread (see list_sharded.h): threads append to their own shards, so they don`t
+//! share tail and first_free. Logical order of elements is shard 0, then shard 1, ...
+template <typename T = List_t, template <typename> class Storage = AosStorage, typename Validation = CheckedValidation>
+struct ShardedList {
+    typedef T          value_type;
+    typedef Validation validation_type;
+
+    ListShard<T, Storage, Validation>* shards = NULL;
+    int n_shards = 0;
+
+    int* prefix       = NULL;   // prefix[i] - number of elements in shards before shard i (n_shards + 1 values)
+    int  prefix_valid = 0;      // Cleared by push, prefix is rebuilt by next get
+};
+
+//! Position of element in ShardedList (ph_index is 0 after last element)
+struct ShardedCursor {
+    int shard;
+    int ph_index;
 };
 // ----------------------------------------------------------------------------
 
+#define LIST_TEMPLATE template <typename T, template <typename> class Storage, typename Validation>
+#define LIST_TYPE     List<T, Storage, Validation>
+#define LIST_VALUE    typename LIST_TYPE::value_type
+
+#define LIST_VALIDATE_LEVEL(obj) (std::remove_pointer<decltype(obj)>::type::validation_type::LEVEL)
+
+#define LIST_LOG_DUMP(obj, reason) {                                                \
+    if (LIST_VALIDATE_LEVEL(obj) >= HIGHEST_VALIDATE) {                             \
+        ASYNC_LOG_CALL(ASYNC_LOG_TXT, list_dump(obj, reason, async_log_file));      \
+    }                                                                               \
+}
+
+#define LIST_ASSERT_IF(obj, cond, text, ret) {                                      \
+    if (LIST_VALIDATE_LEVEL(obj) > UNCHECKED_VALIDATE) ASSERT_IF(cond, text, ret)   \
+}
+
+#define LIST_LOG1(obj, code) {                                                      \
+    if (LIST_VALIDATE_LEVEL(obj) > UNCHECKED_VALIDATE) LOG1(code)                   \
+}
+
+//! Mutators return ret with errno READ_ONLY_LIST, if cells of list can`t be changed (LIST_LOAD_READONLY)
+#define LIST_ASSERT_WRITABLE(obj, ret) {                                            \
+    if (!(obj)->data.writable()) {                                                  \
+        errno = errors::READ_ONLY_LIST;                                             \
+        return ret;                                                                 \
+    }                                                                               \
+}
+
+//! Mutators reserve memory for n_cells changed cells before changes (CowStorage copies chunks, which are
+//! shared with snapshots), so lack of memory is reported, while list is still unchanged
+#define LIST_RESERVE_WRITES(obj, n_cells, ret) {                                    \
+    long long n_writes = (n_cells);                                                 \
+    if (!(obj)->data.reserve(n_writes < INT_MAX ? (int)n_writes : INT_MAX)) {       \
+        errno = errors::NOT_ENOUGH_MEMORY;                                          \
+        return ret;                                                                 \
+    }                                                                               \
+}
+
 #define ASSERT_OK(obj, reason, ret) {                                               \
-    if (VALIDATE_LEVEL >= WEAK_VALIDATE && list_error(obj)) {                       \
+    if (LIST_VALIDATE_LEVEL(obj) == UNCHECKED_VALIDATE) {                           \
+    } else if (LIST_VALIDATE_LEVEL(obj) >= WEAK_VALIDATE && list_error(obj)) {      \
         list_dump(obj, reason);                                                     \
-        LOG_DUMP(obj, reason, list_dump);                                           \
+        LIST_LOG_DUMP(obj, reason);                                                 \
         LOG_DUMP_GRAPH(obj, reason, list_dump_graph)                                \
                                                                                     \
         ASSERT_IF(0, "verify failed", ret);                                         \
@@ -45,15 +374,61 @@ struct List {
 }
 
 #define ERROR_DUMP(obj, reason, ret) {                                              \
-    if (VALIDATE_LEVEL >= WEAK_VALIDATE) {                                          \
+    if (LIST_VALIDATE_LEVEL(obj) >= WEAK_VALIDATE) {                                \
         list_dump(obj, reason);                                                     \
-        LOG_DUMP(obj, reason, list_dump);                                           \
+        LIST_LOG_DUMP(obj, reason);                                                 \
         LOG_DUMP_GRAPH(obj, reason, list_dump_graph)                                \
                                                                                     \
         ASSERT_IF(0, reason, ret);                                                  \
     }                                                                               \
 }
 
+enum list_dump_rows {
+    LIST_DUMP_INDEXES = 0,
+    LIST_DUMP_MARKERS = 1,
+    LIST_DUMP_VALUES  = 2,
+    LIST_DUMP_NEXT    = 3,
+    LIST_DUMP_PREV    = 4
+};
+
+enum list_load_modes {
+    LIST_LOAD_COPY     = 0,     // Cells are read to memory of list
+    LIST_LOAD_PRIVATE  = 1,     // Cells are mapped copy-on-write: list can be changed, file stays the same
+    LIST_LOAD_READONLY = 2      // Cells are mapped read-only: mutators fail with READ_ONLY_LIST
+};
+
+enum concurrent_pop_ends {
+    CONCURRENT_POP_INDEX = 0,   // Element by physical index
+    CONCURRENT_POP_HEAD  = 1,
+    CONCURRENT_POP_TAIL  = 2
+};
+
+enum queue_producers {
+    QUEUE_SPSC = 0,     // One producer: push_back only loads and stores tail
+    QUEUE_MPSC = 1      // Several producers: push_back takes position by CAS on tail
+};
+
+enum journal_ops {
+    JOURNAL_PUSH      = 1,
+    JOURNAL_PUSH_BACK = 2,      // Push by push_back_n (it keeps list sorted, when push_index wouldn`t)
+    JOURNAL_POP       = 3,
+    JOURNAL_RESIZE    = 4,
+    JOURNAL_LINEARIZE = 5,
+    JOURNAL_SORT      = 6,
+    JOURNAL_COMPACT   = 7,
+    JOURNAL_FREE_MAP  = 8       // Free map was turned on or off (it changes choice of free cells)
+};
+
+enum journal_sync_modes {
+    JOURNAL_SYNC_NONE   = 0,    // Commit writes records to file, OS writes them to disk later
+    JOURNAL_SYNC_COMMIT = 1     // Commit waits, till records are on disk (fdatasync)
+};
+
+enum list_file_flags {
+    LIST_FILE_FREE_MAP = 1 << 0,    // Free map was on (free cells chain isn`t kept)
+    LIST_FILE_RANK     = 1 << 1     // Rank index was on
+};
+
 enum errors {
     OK                   =   0,
 
@@ -69,39 +444,218 @@ enum errors {
 
     BAD_PH_INDEX         =  -8,
     BAD_LOG_INDEX        =  -9,
-    NOT_ENOUGH_MEMORY    = -10
+    NOT_ENOUGH_MEMORY    = -10,
+
+    INCORRECT_PREFIX     = -11,
+    INCORRECT_SIZE       = -12,
+
+    BAD_SNAPSHOT         = -13,
+    BAD_NUMBER           = -14,
+
+    QUEUE_FULL           = -15,
+    BAD_JOURNAL          = -16,
+    READ_ONLY_LIST       = -17
 };
 
-int list_ctor(List* lst, int capacity=BUFFER_DEFAULT_SIZE);
-int list_dtor(List* lst);
+LIST_TEMPLATE int list_ctor(LIST_TYPE* lst, int capacity=BUFFER_DEFAULT_SIZE);
+LIST_TEMPLATE int list_dtor(LIST_TYPE* lst);
 
-const char* list_error_desc(int error_code);
-int         list_error(List* lst);
+const char*   list_error_desc(int error_code);
+LIST_TEMPLATE int  list_error(LIST_TYPE* lst);
 
 // Help functions--------------------------------------------------------------
-int       find_free_cell(List* lst);
-int resize_list_capacity(List* lst, int new_size);
-int please_dont_use_sorted_by_next_values_func_because_it_too_slow__also_do_you_really_need_it__i_think_no__so_dont_do_stupid_things_and_better_look_at_memes_about_cats(List* lst);
+LIST_TEMPLATE int       find_free_cell(LIST_TYPE* lst, int target=0);
+LIST_TEMPLATE int  list_take_free_cell(LIST_TYPE* lst, int target);
+LIST_TEMPLATE void   list_release_cell(LIST_TYPE* lst, int ph_index);
+LIST_TEMPLATE int resize_list_capacity(LIST_TYPE* lst, int new_size);
+LIST_TEMPLATE int please_dont_use_sorted_by_next_values_func_because_it_too_slow__also_do_you_really_need_it__i_think_no__so_dont_do_stupid_things_and_better_look_at_memes_about_cats(LIST_TYPE* lst);
+LIST_TEMPLATE int         list_linearize(LIST_TYPE* lst);
+LIST_TEMPLATE int      list_compact_step(LIST_TYPE* lst, int budget, int* tracked=NULL);
+LIST_TEMPLATE int     list_sorted_prefix(LIST_TYPE* lst);
+
+LIST_TEMPLATE void swap_list_cells(LIST_TYPE* lst, int first, int second);
+LIST_TEMPLATE void  move_list_cell(LIST_TYPE* lst, int from,  int to);
+LIST_TEMPLATE void place_list_cell(LIST_TYPE* lst, int from,  int to, int* tracked=NULL);
+LIST_TEMPLATE void unlink_free_cell(LIST_TYPE* lst, int ph_index);
+
+LIST_TEMPLATE int list_cell_is_free(const LIST_TYPE* lst, int ph_index);
+LIST_TEMPLATE int list_value_poison(const LIST_TYPE* lst, int ph_index);
 // ----------------------------------------------------------------------------
 
-List_t get(List* lst, int log_index);
-void fill_list_element(ListElement* el_ptr, List_t value, int next, int prev);
+// Rank index functions--------------------------------------------------------
+int list_rank_alloc   (ListRankIndex* rank, int capacity);
+int list_rank_position(const ListRankIndex* rank, int id);
+
+LIST_TEMPLATE int  list_rank_enable (LIST_TYPE* lst);
+LIST_TEMPLATE int  list_rank_disable(LIST_TYPE* lst);
+LIST_TEMPLATE int  list_rank_build  (LIST_TYPE* lst);
+LIST_TEMPLATE int  list_rank_find   (LIST_TYPE* lst, int log_index);
+
+LIST_TEMPLATE void list_rank_insert (LIST_TYPE* lst, int prev_cell, int cell);
+LIST_TEMPLATE void list_rank_remove (LIST_TYPE* lst, int cell);
+LIST_TEMPLATE void list_rank_split  (LIST_TYPE* lst, int id);
+LIST_TEMPLATE void list_rank_swap   (LIST_TYPE* lst, int first, int second);
+LIST_TEMPLATE void list_rank_move   (LIST_TYPE* lst, int from,  int to);
+// ----------------------------------------------------------------------------
+
+// Free map functions----------------------------------------------------------
+int  list_free_map_alloc  (ListFreeMap* map, int capacity);
+int  list_free_map_nearest(const ListFreeMap* map, int target);
+void list_free_map_set    (ListFreeMap* map, int cell);
+void list_free_map_clear  (ListFreeMap* map, int cell);
+
+LIST_TEMPLATE int list_free_map_enable (LIST_TYPE* lst);
+LIST_TEMPLATE int list_free_map_disable(LIST_TYPE* lst);
+LIST_TEMPLATE int list_free_map_build  (LIST_TYPE* lst);
+LIST_TEMPLATE int list_free_map_take   (LIST_TYPE* lst, int target);
+LIST_TEMPLATE int list_free_map_resize (LIST_TYPE* lst, int capacity, int new_capacity);
+// ----------------------------------------------------------------------------
+
+// Finger functions------------------------------------------------------------
+LIST_TEMPLATE int  list_finger_find  (LIST_TYPE* lst, int log_index);
+LIST_TEMPLATE int  list_finger_log   (LIST_TYPE* lst, int ph_index);
+
+LIST_TEMPLATE void list_fingers_reset(LIST_TYPE* lst);
+LIST_TEMPLATE void list_fingers_shift(LIST_TYPE* lst, int log_index, int delta);
+LIST_TEMPLATE void list_fingers_remap(LIST_TYPE* lst, int first, int second);
+// ----------------------------------------------------------------------------
+
+LIST_TEMPLATE T   get(LIST_TYPE* lst, int log_index);
+LIST_TEMPLATE int find_value(LIST_TYPE* lst, LIST_VALUE value);
+template <typename T> void fill_list_element(ListElement<T>* el_ptr, T value, int next, int prev);
 
 // Push/pop functions----------------------------------------------------------
-int   push_index(List* lst, List_t value, int ph_index);
-List_t pop_index(List* lst, int ph_index);
+LIST_TEMPLATE int push_index(LIST_TYPE* lst, LIST_VALUE value, int ph_index);
+LIST_TEMPLATE T    pop_index(LIST_TYPE* lst, int ph_index);
 
-int    push_back(List* lst, List_t value);
-List_t  pop_back(List* lst);
+LIST_TEMPLATE int  push_back(LIST_TYPE* lst, LIST_VALUE value);
+LIST_TEMPLATE T     pop_back(LIST_TYPE* lst);
 
-int   push_front(List* lst, List_t value);
-List_t pop_front(List* lst);
+LIST_TEMPLATE int push_front(LIST_TYPE* lst, LIST_VALUE value);
+LIST_TEMPLATE T    pop_front(LIST_TYPE* lst);
+
+LIST_TEMPLATE int push_back_n(LIST_TYPE* lst, const LIST_VALUE* values, int n);
+LIST_TEMPLATE int pop_front_n(LIST_TYPE* lst, LIST_VALUE* values,       int n);
 // ----------------------------------------------------------------------------
 
 // Info functions--------------------------------------------------------------
-int      print_list(List* lst, const char* sep=", ", const char* end="\n");
-int       list_dump(List* lst, const char* reason, FILE* log=stdout, const char* sep=", ", const char* end="\n");
-int list_dump_graph(List* lst, const char* reason, FILE* log,        const char* sep=", ", const char* end="\n");
+LIST_TEMPLATE int      print_list(LIST_TYPE* lst, const char* sep=", ", const char* end="\n");
+LIST_TEMPLATE int       list_dump(LIST_TYPE* lst, const char* reason, FILE* log=stdout, const char* sep=", ", const char* end="\n");
+LIST_TEMPLATE int list_dump_graph(LIST_TYPE* lst, const char* reason, FILE* log,        const char* sep=", ", const char* end="\n");
+
+LIST_TEMPLATE int  list_dump_window(LIST_TYPE* lst, const char* reason, int from, int to, FILE* log=stdout,
+                                    const char* sep=", ", const char* end="\n");
+LIST_TEMPLATE int  list_dump_ranges(LIST_TYPE* lst, const char* reason, FILE* log, const ListDumpRange* ranges, int n_ranges,
+                                    const char* sep, const char* end);
+LIST_TEMPLATE void list_dump_row   (LIST_TYPE* lst, DumpBuffer* buf, int row, const ListDumpRange* ranges, int n_ranges,
+                                    const char* sep, FILE* log);
+
+LIST_TEMPLATE double list_locality(LIST_TYPE* lst);
+// ----------------------------------------------------------------------------
+
+// Snapshot functions----------------------------------------------------------
+LIST_TEMPLATE int list_save(LIST_TYPE* lst, const char* filename);
+LIST_TEMPLATE int list_load(LIST_TYPE* lst, const char* filename, int mode=LIST_LOAD_PRIVATE);
+// ----------------------------------------------------------------------------
+
+// Concurrent list functions---------------------------------------------------
+template <typename T> int  list_ctor (ConcurrentList<T>* lst, int capacity=BUFFER_DEFAULT_SIZE);
+template <typename T> int  list_dtor (ConcurrentList<T>* lst);
+template <typename T> int  list_error(ConcurrentList<T>* lst);
+template <typename T> int  list_size (ConcurrentList<T>* lst);
+template <typename T> int  print_list(ConcurrentList<T>* lst, const char* sep=", ", const char* end="\n");
+
+template <typename T> int push_index(ConcurrentList<T>* lst, T value, int ph_index);
+template <typename T> T    pop_index(ConcurrentList<T>* lst, int ph_index);
+template <typename T> int  push_back(ConcurrentList<T>* lst, T value);
+template <typename T> T     pop_back(ConcurrentList<T>* lst);
+template <typename T> int push_front(ConcurrentList<T>* lst, T value);
+template <typename T> T    pop_front(ConcurrentList<T>* lst);
+
+template <typename T> ConcurrentCell<T>* concurrent_cell(ConcurrentList<T>* lst, int ph_index);
+template <typename T> int  concurrent_take_cell   (ConcurrentList<T>* lst);
+template <typename T> void concurrent_release_cell(ConcurrentList<T>* lst, int ph_index);
+template <typename T> int  concurrent_grow        (ConcurrentList<T>* lst, int shard);
+template <typename T> int  concurrent_push        (ConcurrentList<T>* lst, T value, int ph_index, int at_tail);
+template <typename T> T    concurrent_pop         (ConcurrentList<T>* lst, int ph_index, int end);
 // ----------------------------------------------------------------------------
 
+// Queue functions-------------------------------------------------------------
+template <typename T> int  list_ctor (ListQueue<T>* lst, int capacity=BUFFER_DEFAULT_SIZE, int producers=QUEUE_SPSC);
+template <typename T> int  list_dtor (ListQueue<T>* lst);
+template <typename T> int  list_error(ListQueue<T>* lst);
+template <typename T> int  list_size (ListQueue<T>* lst);
+template <typename T> int  print_list(ListQueue<T>* lst, const char* sep=", ", const char* end="\n");
+
+template <typename T> int  push_back(ListQueue<T>* lst, T value);
+template <typename T> T    pop_front(ListQueue<T>* lst);
+// ----------------------------------------------------------------------------
+
+// Sharded list functions------------------------------------------------------
+#define SHARDED_TYPE ShardedList<T, Storage, Validation>
+
+LIST_TEMPLATE int  list_ctor (SHARDED_TYPE* lst, int capacity=BUFFER_DEFAULT_SIZE, int n_shards=SHARDED_AUTO);
+LIST_TEMPLATE int  list_dtor (SHARDED_TYPE* lst);
+LIST_TEMPLATE int  list_error(SHARDED_TYPE* lst);
+LIST_TEMPLATE int  list_size (SHARDED_TYPE* lst);
+LIST_TEMPLATE int  print_list(SHARDED_TYPE* lst, const char* sep=", ", const char* end="\n");
+
+LIST_TEMPLATE int  push_back        (SHARDED_TYPE* lst, LIST_VALUE value);
+LIST_TEMPLATE int  sharded_push_back(SHARDED_TYPE* lst, LIST_VALUE value, int shard);
+LIST_TEMPLATE int  sharded_append   (SHARDED_TYPE* lst, LIST_VALUE value, int shard);
+LIST_TEMPLATE T    get              (SHARDED_TYPE* lst, int log_index);
+
+LIST_TEMPLATE int           sharded_prefix(SHARDED_TYPE* lst);
+LIST_TEMPLATE ShardedCursor sharded_begin (SHARDED_TYPE* lst);
+LIST_TEMPLATE int           sharded_next  (SHARDED_TYPE* lst, ShardedCursor* cursor);
+LIST_TEMPLATE int           merge_shards  (SHARDED_TYPE* lst, LIST_TYPE* merged);
+// ----------------------------------------------------------------------------
+
+// Copy-on-write snapshot functions--------------------------------------------
+template <typename T, typename Validation> int snapshot_take(List<T, CowStorage, Validation>* lst, ListSnapshot<T>* snap);
+template <typename T> int snapshot_release(ListSnapshot<T>* snap);
+
+template <typename T> int  list_error(ListSnapshot<T>* snap);
+template <typename T> int  list_size (ListSnapshot<T>* snap);
+template <typename T> T    get       (ListSnapshot<T>* snap, int log_index);
+template <typename T> int  print_list(ListSnapshot<T>* snap, const char* sep=", ", const char* end="\n");
+// ----------------------------------------------------------------------------
+
+// Journal functions-----------------------------------------------------------
+int journal_write(ListJournal* journal, const void* record);
+int journal_flush(ListJournal* journal);
+int journal_commit(ListJournal* journal);
+int journal_reset(ListJournal* journal, int checkpoint, int value_size);
+
+LIST_TEMPLATE void list_journal_record(LIST_TYPE* lst, int op, int arg, int result, LIST_VALUE value);
+
+LIST_TEMPLATE int list_journal_open  (LIST_TYPE* lst, const char* image_name, const char* journal_name, int sync=JOURNAL_SYNC_NONE);
+LIST_TEMPLATE int list_journal_close (LIST_TYPE* lst);
+LIST_TEMPLATE int list_journal_commit(LIST_TYPE* lst);
+LIST_TEMPLATE int list_checkpoint    (LIST_TYPE* lst);
+LIST_TEMPLATE int list_journal_replay(LIST_TYPE* lst, const char* journal_name);
+LIST_TEMPLATE int list_journal_apply (LIST_TYPE* lst, const ListJournalRecord<T>* records, int n_records);
+// ----------------------------------------------------------------------------
+
+// Ingest functions------------------------------------------------------------
+LIST_TEMPLATE int  list_ingest_reserve(void* object, size_t n_values);
+LIST_TEMPLATE void list_ingest_write  (void* object, size_t index, const int* values, size_t n_values);
+
+LIST_TEMPLATE int list_from_text       (LIST_TYPE* lst, const char* data, size_t size, int n_threads=1);
+LIST_TEMPLATE int list_from_file       (LIST_TYPE* lst, const char* filename,          int n_threads=1);
+LIST_TEMPLATE int list_from_text_finish(LIST_TYPE* lst);
+// ----------------------------------------------------------------------------
+
+#include "list_impl.h"
+#include "list_rank.h"
+#include "list_finger.h"
+#include "list_free_map.h"
+#include "list_snapshot.h"
+#include "list_ingest.h"
+#include "list_concurrent.h"
+#include "list_queue.h"
+#include "list_sharded.h"
+#include "list_cow.h"
+#include "list_journal.h"
+
 #endif // LIST_LISTH
@@ -0,0 +1,518 @@
+//
+//  Created by IvanBrekman on 03.11.2021.
+//
+
+#ifndef LIST_CONCURRENTH
+#define LIST_CONCURRENTH
+
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <sched.h>
+
+// Concurrent list-------------------------------------------------------------
+// Every cell has spin lock. Push locks new cell, cell before it and cell after it, pop locks
+// popped cell and its neighbours, so threads, which work at distinct places of list, don`t wait
+// each other. Only first lock of operation waits, others are tried once: if one of them is taken,
+// operation releases its locks and starts again, so threads can`t deadlock on ring of cells.
+// Cells lie in chunks, which are never moved (chunk table has fixed size), so growth doesn`t stop
+// other threads. Free cells are kept in CONCURRENT_SHARDS chains: thread takes cells from its
+// shard and steals from others only if its shard is empty.
+// !Note! physical index is valid only while its element is in list: pop of popped index can pop
+// other element, which took the same cell.
+
+#define CONCURRENT_CELLS (1 << LIST_CHUNK_BITS)
+
+//! Function loads link, which can be changed by other thread (cells of chunk are seen,
+//! if link to them is seen, so head and tail can be read without lock)
+//! \param link ptr to link
+//! \return     value of link
+inline int concurrent_load(const int* link) {
+    return __atomic_load_n(link, __ATOMIC_ACQUIRE);
+}
+
+//! Function stores link, which can be read by other thread
+//! \param link  ptr to link
+//! \param value new value
+inline void concurrent_store(int* link, int value) {
+    __atomic_store_n(link, value, __ATOMIC_RELEASE);
+}
+
+//! Function waits a bit after failed lock attempt
+//! \param attempt number of failed attempts
+inline void concurrent_backoff(int attempt) {
+    if (attempt < CONCURRENT_SPINS) {
+#if defined(__x86_64__)
+        __builtin_ia32_pause();
+#endif
+    } else {
+        sched_yield();
+    }
+}
+
+//! Function tries to take lock once
+//! \param lock ptr to lock
+//! \return     1 if lock is taken, else 0
+inline int concurrent_try_lock(int* lock) {
+    return __atomic_load_n(lock, __ATOMIC_RELAXED) == 0 && __atomic_exchange_n(lock, 1, __ATOMIC_ACQUIRE) == 0;
+}
+
+//! Function waits till lock is taken
+//! \param lock ptr to lock
+inline void concurrent_lock(int* lock) {
+    for (int attempt = 0; !concurrent_try_lock(lock); attempt++) {
+        concurrent_backoff(attempt);
+    }
+}
+
+//! Function releases lock
+//! \param lock ptr to lock
+inline void concurrent_unlock(int* lock) {
+    __atomic_store_n(lock, 0, __ATOMIC_RELEASE);
+}
+
+//! Function gets free cells shard of current thread (threads get shards in turn)
+//! \return number of shard
+inline int concurrent_shard() {
+    static int next_shard = 0;
+    static thread_local int shard = -1;
+
+    if (shard < 0) shard = __atomic_fetch_add(&next_shard, 1, __ATOMIC_RELAXED) % CONCURRENT_SHARDS;
+    return shard;
+}
+
+//! Function gets cell by physical index
+//! \param lst      ptr to ConcurrentList object
+//! \param ph_index physical index
+//! \return         ptr to cell
+template <typename T> ConcurrentCell<T>* concurrent_cell(ConcurrentList<T>* lst, int ph_index) {
+    return &lst->chunks[ph_index >> LIST_CHUNK_BITS][ph_index & (CONCURRENT_CELLS - 1)];
+}
+
+//! ConcurrentList Constructor
+//! \param lst      ptr to ConcurrentList object
+//! \param capacity start capacity (it is rounded up to chunks, default BUFFER_DEFAULT_SIZE)
+//! \return         1 if success, else 0
+template <typename T> int list_ctor(ConcurrentList<T>* lst, int capacity) {
+    ASSERT_IF(VALID_PTR(lst), "Invalid lst ptr", 0);
+    ASSERT_IF(capacity > 0,   "Incorrect capacity: (<= 0)", 0);
+
+    *lst = { };
+    lst->chunks = (ConcurrentCell<T>**)  calloc(CONCURRENT_MAX_CHUNKS, sizeof(ConcurrentCell<T>*));
+    lst->shards = (ConcurrentFreeShard*) aligned_alloc(alignof(ConcurrentFreeShard), CONCURRENT_SHARDS * sizeof(ConcurrentFreeShard));
+
+    if (lst->chunks == NULL || lst->shards == NULL) {
+        list_dtor(lst);
+
+        errno = errors::NOT_ENOUGH_MEMORY;
+        return 0;
+    }
+    memset(lst->shards, 0, CONCURRENT_SHARDS * sizeof(ConcurrentFreeShard));
+
+    // Cells of start chunks are divided between shards by equal ranges-------
+    int n_chunks = (capacity + CONCURRENT_CELLS - 1) / CONCURRENT_CELLS;
+    if (n_chunks > CONCURRENT_MAX_CHUNKS) n_chunks = CONCURRENT_MAX_CHUNKS;
+
+    for (int i = 0; i < n_chunks; i++) {
+        lst->chunks[i] = (ConcurrentCell<T>*) calloc(CONCURRENT_CELLS, sizeof(ConcurrentCell<T>));
+        if (lst->chunks[i] == NULL) {
+            lst->n_chunks = i;      // Allocated chunks are freed by dtor
+            list_dtor(lst);
+
+            errno = errors::NOT_ENOUGH_MEMORY;
+            return 0;
+        }
+    }
+    lst->n_chunks = n_chunks;
+
+    int n_cells = n_chunks * CONCURRENT_CELLS;
+    for (int i = 0; i < n_cells; i++) {
+        *concurrent_cell(lst, i) = { ListValueTraits<T>::uninit(), i + 1, poisons::UNINITIALIZED_INT, 0 };
+    }
+
+    for (int shard = 0; shard < CONCURRENT_SHARDS; shard++) {
+        int first = 1 + (int)((long long)(n_cells - 1) *  shard      / CONCURRENT_SHARDS);
+        int last  = 1 + (int)((long long)(n_cells - 1) * (shard + 1) / CONCURRENT_SHARDS);
+
+        lst->shards[shard].first_free = first < last ? first : 0;
+        if (first < last) concurrent_cell(lst, last - 1)->next = 0;
+    }
+    // ------------------------------------------------------------------------
+
+    *concurrent_cell(lst, 0) = { ListValueTraits<T>::uninit(), 0, 0, 0 };
+
+    return 1;
+}
+
+//! ConcurrentList Destructor (no thread should use list)
+//! \param lst ptr to ConcurrentList object
+//! \return    1 if success, else 0
+template <typename T> int list_dtor(ConcurrentList<T>* lst) {
+    ASSERT_IF(VALID_PTR(lst), "Invalid lst ptr", 0);
+
+    if (lst->chunks != NULL) {
+        for (int i = 0; i < lst->n_chunks; i++) free(lst->chunks[i]);
+    }
+    free(lst->chunks);
+    free(lst->shards);
+    pthread_mutex_destroy(&lst->grow_mutex);
+
+    lst->chunks   = NULL;
+    lst->shards   = NULL;
+    lst->n_chunks = -1;
+    return 1;
+}
+
+//! Function checks links of list (no thread should change list)
+//! \param lst ptr to ConcurrentList object
+//! \return    error code (0 if all is good)
+template <typename T> int list_error(ConcurrentList<T>* lst) {
+    if (!VALID_PTR(lst)) {
+        return errors::INVALID_LIST_PTR;
+    }
+    if (lst->chunks == NULL || lst->shards == NULL || lst->n_chunks <= 0) {
+        return errors::INCORRECT_CAPACITY;
+    }
+
+    int capacity = lst->n_chunks * CONCURRENT_CELLS;
+    int size     = 0;
+    for (int cell = concurrent_cell(lst, 0)->next, prev = 0; cell != 0; prev = cell, cell = concurrent_cell(lst, cell)->next) {
+        if (cell < 0 || cell >= capacity || concurrent_cell(lst, cell)->prev != prev) {
+            return errors::BAD_PH_INDEX;
+        }
+        if (++size >= capacity) {
+            return errors::INCORRECT_SIZE;
+        }
+    }
+
+    if (size != list_size(lst)) {
+        return errors::INCORRECT_SIZE;
+    }
+
+    return errors::OK;
+}
+
+//! Function gets number of elements (it is exact only if no thread changes list)
+//! \param lst ptr to ConcurrentList object
+//! \return    number of elements
+template <typename T> int list_size(ConcurrentList<T>* lst) {
+    int size = 0;
+    for (int shard = 0; shard < CONCURRENT_SHARDS; shard++) {
+        size += __atomic_load_n(&lst->shards[shard].size, __ATOMIC_RELAXED);
+    }
+
+    return size;
+}
+
+//! Function prints list for user (no thread should change list)
+//! \param lst ptr to ConcurrentList object
+//! \param sep ptr to sep string (default ", ")
+//! \param end ptr to end string (default "\n")
+//! \return    1 if success, else 0
+template <typename T> int print_list(ConcurrentList<T>* lst, const char* sep, const char* end) {
+    ASSERT_IF(list_error(lst) == errors::OK, "Check before print_list func", 0);
+    ASSERT_IF(VALID_PTR(sep), "Invalid sep ptr", 0);
+    ASSERT_IF(VALID_PTR(end), "Invalid end ptr", 0);
+
+    char value_str[MAX_VALUE_STR_SIZE] = "";
+
+    printf("[ ");
+    for (int cell = concurrent_cell(lst, 0)->next; cell != 0; cell = concurrent_cell(lst, cell)->next) {
+        ListValueTraits<T>::format(value_str, MAX_VALUE_STR_SIZE, concurrent_cell(lst, cell)->value);
+        printf("%3s", value_str);
+
+        if (concurrent_cell(lst, cell)->next != 0) printf("%s", sep);
+    }
+    printf(" ]%s", end);
+
+    return 1;
+}
+
+//! Function allocates new chunk and gives its cells to shard
+//! \param lst   ptr to ConcurrentList object
+//! \param shard number of shard
+//! \return      1 if success, else 0
+template <typename T> int concurrent_grow(ConcurrentList<T>* lst, int shard) {
+    pthread_mutex_lock(&lst->grow_mutex);
+
+    int n_chunks = lst->n_chunks;
+    ConcurrentCell<T>* chunk = n_chunks < CONCURRENT_MAX_CHUNKS ?
+                               (ConcurrentCell<T>*) calloc(CONCURRENT_CELLS, sizeof(ConcurrentCell<T>)) : NULL;
+    if (chunk == NULL) {
+        pthread_mutex_unlock(&lst->grow_mutex);
+        return 0;
+    }
+
+    int first = n_chunks * CONCURRENT_CELLS;
+    for (int i = 0; i < CONCURRENT_CELLS; i++) {
+        chunk[i] = { ListValueTraits<T>::uninit(), first + i + 1, poisons::UNINITIALIZED_INT, 0 };
+    }
+
+    lst->chunks[n_chunks] = chunk;
+    __atomic_store_n(&lst->n_chunks, n_chunks + 1, __ATOMIC_RELEASE);
+
+    ConcurrentFreeShard* free_cells = &lst->shards[shard];
+    concurrent_lock(&free_cells->lock);
+
+    chunk[CONCURRENT_CELLS - 1].next = free_cells->first_free;
+    concurrent_store(&free_cells->first_free, first);
+
+    concurrent_unlock(&free_cells->lock);
+    pthread_mutex_unlock(&lst->grow_mutex);
+
+    PRINT_WARNING("!WARNING! ConcurrentList is to small. List capacity has increased.\n"
+                  "          Create List with bigger capacity to speed up list working.\n");
+    return 1;
+}
+
+//! Function takes free cell: from shard of thread, else from other shards, else from new chunk
+//! \param lst ptr to ConcurrentList object
+//! \return    free cell index (0 if there is no memory)
+template <typename T> int concurrent_take_cell(ConcurrentList<T>* lst) {
+    int home = concurrent_shard();
+
+    for ( ; ; ) {
+        for (int i = 0; i < CONCURRENT_SHARDS; i++) {
+            ConcurrentFreeShard* free_cells = &lst->shards[(home + i) % CONCURRENT_SHARDS];
+
+            if (i == 0) {
+                concurrent_lock(&free_cells->lock);
+            } else if (concurrent_load(&free_cells->first_free) == 0 || !concurrent_try_lock(&free_cells->lock)) {
+                continue;
+            }
+
+            int cell = free_cells->first_free;
+            if (cell != 0) {
+                concurrent_store(&free_cells->first_free, concurrent_load(&concurrent_cell(lst, cell)->next));
+                __atomic_store_n(&free_cells->size, free_cells->size + 1, __ATOMIC_RELAXED);
+            }
+            concurrent_unlock(&free_cells->lock);
+
+            if (cell != 0) return cell;
+        }
+
+        if (!concurrent_grow(lst, home)) return 0;
+    }
+}
+
+//! Function gives cell back to shard of thread (cell should be unlinked and locked by caller)
+//! \param lst      ptr to ConcurrentList object
+//! \param ph_index physical index of cell
+template <typename T> void concurrent_release_cell(ConcurrentList<T>* lst, int ph_index) {
+    ConcurrentFreeShard* free_cells = &lst->shards[concurrent_shard()];
+    ConcurrentCell<T>*   cell       = concurrent_cell(lst, ph_index);
+
+    cell->value = ListValueTraits<T>::freed();
+    concurrent_store(&cell->prev, poisons::UNINITIALIZED_INT);
+
+    concurrent_lock(&free_cells->lock);
+
+    concurrent_store(&cell->next, free_cells->first_free);
+    concurrent_store(&free_cells->first_free, ph_index);
+    __atomic_store_n(&free_cells->size, free_cells->size - 1, __ATOMIC_RELAXED);
+
+    concurrent_unlock(&free_cells->lock);
+}
+
+//! Function inserts value after ph_index (or after tail)
+//! \param lst      ptr to ConcurrentList object
+//! \param value    inserted value
+//! \param ph_index physical index of element, after which need to insert (not used with at_tail)
+//! \param at_tail  flag to insert after current tail
+//! \return         physical index of inserted element (< 0 if error)
+template <typename T> int concurrent_push(ConcurrentList<T>* lst, T value, int ph_index, int at_tail) {
+    int new_index = concurrent_take_cell(lst);
+    if (new_index == 0) {
+        errno = errors::NOT_ENOUGH_MEMORY;
+        return  errors::NOT_ENOUGH_MEMORY;
+    }
+
+    ConcurrentCell<T>* new_cell = concurrent_cell(lst, new_index);
+    concurrent_lock(&new_cell->lock);   // Cell can be locked by thread, which has old index of it
+
+    for (int attempt = 0; ; attempt++) {
+        int prev_index = at_tail ? concurrent_load(&concurrent_cell(lst, 0)->prev) : ph_index;
+        ConcurrentCell<T>* prev_cell = concurrent_cell(lst, prev_index);
+
+        if (prev_index == new_index || !concurrent_try_lock(&prev_cell->lock)) {
+            if (prev_index == new_index && !at_tail) break;     // ph_index is free cell
+
+            concurrent_backoff(attempt);
+            continue;
+        }
+
+        int next_index = concurrent_load(&prev_cell->next);
+        if ((prev_index != 0 && concurrent_load(&prev_cell->prev) == poisons::UNINITIALIZED_INT) || (at_tail && next_index != 0)) {
+            concurrent_unlock(&prev_cell->lock);
+            if (!at_tail) break;                                // ph_index is free cell
+
+            concurrent_backoff(attempt);                        // Tail was changed
+            continue;
+        }
+
+        ConcurrentCell<T>* next_cell = concurrent_cell(lst, next_index);
+        if (next_index != prev_index && !concurrent_try_lock(&next_cell->lock)) {
+            concurrent_unlock(&prev_cell->lock);
+
+            concurrent_backoff(attempt);
+            continue;
+        }
+
+        // Linking new element between locked neighbours---------------------------
+        new_cell->value = value;
+        concurrent_store(&new_cell->next, next_index);
+        concurrent_store(&new_cell->prev, prev_index);
+
+        concurrent_store(&prev_cell->next, new_index);
+        concurrent_store(&next_cell->prev, new_index);
+        // ------------------------------------------------------------------------
+
+        if (next_index != prev_index) concurrent_unlock(&next_cell->lock);
+        concurrent_unlock(&prev_cell->lock);
+        concurrent_unlock(&new_cell->lock);
+        return new_index;
+    }
+
+    concurrent_release_cell(lst, new_index);
+    concurrent_unlock(&new_cell->lock);
+
+    errno = errors::BAD_PH_INDEX;
+    return  errors::BAD_PH_INDEX;
+}
+
+//! Function pops element by ph_index (or head, or tail)
+//! \param lst      ptr to ConcurrentList object
+//! \param ph_index physical index of popped element (used only with CONCURRENT_POP_INDEX)
+//! \param end      what element is popped (see concurrent_pop_ends)
+//! \return         popped value
+template <typename T> T concurrent_pop(ConcurrentList<T>* lst, int ph_index, int end) {
+    ConcurrentCell<T>* zero_cell = concurrent_cell(lst, 0);
+
+    for (int attempt = 0; ; attempt++) {
+        if (end == CONCURRENT_POP_HEAD) ph_index = concurrent_load(&zero_cell->next);
+        if (end == CONCURRENT_POP_TAIL) ph_index = concurrent_load(&zero_cell->prev);
+
+        if (ph_index == 0) {
+            errno = errors::LST_EMPTY;
+            return ListValueTraits<T>::from_error(errors::LST_EMPTY);
+        }
+
+        ConcurrentCell<T>* cell = concurrent_cell(lst, ph_index);
+        concurrent_lock(&cell->lock);
+
+        int prev_index = concurrent_load(&cell->prev);
+        int next_index = concurrent_load(&cell->next);
+        if (prev_index == poisons::UNINITIALIZED_INT && end == CONCURRENT_POP_INDEX) {
+            concurrent_unlock(&cell->lock);
+
+            errno = errors::BAD_PH_INDEX;
+            return ListValueTraits<T>::from_error(errors::BAD_PH_INDEX);
+        }
+
+        // Cell was popped or isn`t end already, or neighbours are locked: trying again
+        int moved = prev_index == poisons::UNINITIALIZED_INT || (end == CONCURRENT_POP_HEAD && prev_index != 0) ||
+                                                                (end == CONCURRENT_POP_TAIL && next_index != 0);
+
+        ConcurrentCell<T>* prev_cell = concurrent_cell(lst, moved ? 0 : prev_index);
+        ConcurrentCell<T>* next_cell = concurrent_cell(lst, moved ? 0 : next_index);
+        if (moved || !concurrent_try_lock(&prev_cell->lock)) {
+            concurrent_unlock(&cell->lock);
+
+            concurrent_backoff(attempt);
+            continue;
+        }
+        if (next_index != prev_index && !concurrent_try_lock(&next_cell->lock)) {
+            concurrent_unlock(&prev_cell->lock);
+            concurrent_unlock(&cell->lock);
+
+            concurrent_backoff(attempt);
+            continue;
+        }
+
+        T value = cell->value;
+
+        concurrent_store(&prev_cell->next, next_index);
+        concurrent_store(&next_cell->prev, prev_index);
+
+        if (next_index != prev_index) concurrent_unlock(&next_cell->lock);
+        concurrent_unlock(&prev_cell->lock);
+
+        concurrent_release_cell(lst, ph_index);     // Cell stays locked, so thread with its old index sees it free
+        concurrent_unlock(&cell->lock);
+        return value;
+    }
+}
+
+//! Function inserts value after ph_index (several threads can push and pop at once)
+//! \param lst      ptr to ConcurrentList object
+//! \param value    inserted value
+//! \param ph_index physical index of element, after which need to insert
+//! \return         physical index of inserted element (< 0 if error)
+template <typename T> int push_index(ConcurrentList<T>* lst, T value, int ph_index) {
+    ASSERT_IF(VALID_PTR(lst), "Invalid lst ptr", errors::INVALID_LIST_PTR);
+
+    if (ph_index < 0 || ph_index >= __atomic_load_n(&lst->n_chunks, __ATOMIC_ACQUIRE) * CONCURRENT_CELLS) {
+        errno = errors::BAD_PH_INDEX;
+        return  errors::BAD_PH_INDEX;
+    }
+
+    return concurrent_push(lst, value, ph_index, 0);
+}
+
+//! Function pops element by ph_index (several threads can push and pop at once)
+//! \param lst      ptr to ConcurrentList object
+//! \param ph_index physical index of popped element
+//! \return         popped value
+template <typename T> T pop_index(ConcurrentList<T>* lst, int ph_index) {
+    ASSERT_IF(VALID_PTR(lst), "Invalid lst ptr", ListValueTraits<T>::from_error(errors::INVALID_LIST_PTR));
+
+    if (ph_index <= 0 || ph_index >= __atomic_load_n(&lst->n_chunks, __ATOMIC_ACQUIRE) * CONCURRENT_CELLS) {
+        errno = errors::BAD_PH_INDEX;
+        return ListValueTraits<T>::from_error(errors::BAD_PH_INDEX);
+    }
+
+    return concurrent_pop(lst, ph_index, CONCURRENT_POP_INDEX);
+}
+
+//! Function inserts value after tail
+//! \param lst   ptr to ConcurrentList object
+//! \param value inserted value
+//! \return      index of inserted element
+template <typename T> int push_back(ConcurrentList<T>* lst, T value) {
+    ASSERT_IF(VALID_PTR(lst), "Invalid lst ptr", errors::INVALID_LIST_PTR);
+
+    return concurrent_push(lst, value, 0, 1);
+}
+
+//! Function pops value from tail
+//! \param lst ptr to ConcurrentList object
+//! \return    popped value
+template <typename T> T pop_back(ConcurrentList<T>* lst) {
+    ASSERT_IF(VALID_PTR(lst), "Invalid lst ptr", ListValueTraits<T>::from_error(errors::INVALID_LIST_PTR));
+
+    return concurrent_pop(lst, 0, CONCURRENT_POP_TAIL);
+}
+
+//! Function inserts value before head
+//! \param lst   ptr to ConcurrentList object
+//! \param value inserted value
+//! \return      index of inserted element
+template <typename T> int push_front(ConcurrentList<T>* lst, T value) {
+    ASSERT_IF(VALID_PTR(lst), "Invalid lst ptr", errors::INVALID_LIST_PTR);
+
+    return concurrent_push(lst, value, 0, 0);
+}
+
+//! Function pops value from head
+//! \param lst ptr to ConcurrentList object
+//! \return    popped value
+template <typename T> T pop_front(ConcurrentList<T>* lst) {
+    ASSERT_IF(VALID_PTR(lst), "Invalid lst ptr", ListValueTraits<T>::from_error(errors::INVALID_LIST_PTR));
+
+    return concurrent_pop(lst, 0, CONCURRENT_POP_HEAD);
+}
+
+#undef CONCURRENT_CELLS
+// ----------------------------------------------------------------------------
+
+#endif // LIST_CONCURRENTH
@@ -0,0 +1,155 @@
+//
+//  Created by IvanBrekman on 03.11.2021.
+//
+
+#ifndef LIST_COWH
+#define LIST_COWH
+
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+
+// Copy-on-write snapshots-----------------------------------------------------
+// snapshot_take copies chunk table of list with CowStorage and adds owner to each chunk (O(chunks),
+// cells aren`t copied). After it every chunk is shared: first access of list to chunk through
+// non-const accessor copies chunk, if snapshot still has it, so snapshot stays the same, while list
+// is changed. Readers can walk snapshot in other threads, while one writer changes list.
+// snapshot_take should be called by writer (or while writer waits), so list is not in the middle
+// of push or pop. Read functions (get, print_list, list_save, dumps) use const accessors, so they
+// don`t copy chunks. Mutators reserve copies before changes (see CowStorage::reserve), so lack of
+// memory for copies is reported by NOT_ENOUGH_MEMORY, and list stays unchanged then.
+
+//! Function takes snapshot of list
+//! \param lst  ptr to List object with CowStorage
+//! \param snap ptr to ListSnapshot object (it shouldn`t be taken)
+//! \return     1 if success, else 0
+template <typename T, typename Validation> int snapshot_take(List<T, CowStorage, Validation>* lst, ListSnapshot<T>* snap) {
+    ASSERT_OK(lst, "Check before snapshot_take func", 0);
+    LIST_ASSERT_IF(lst, VALID_PTR(snap), "Invalid snap ptr", 0);
+
+    CowStorage<T>* data = &lst->data;
+
+    *snap = { };
+    snap->chunks = (CowChunk<T>**) calloc(data->n_chunks, sizeof(CowChunk<T>*));
+    if (snap->chunks == NULL) {
+        errno = errors::NOT_ENOUGH_MEMORY;
+        return 0;
+    }
+
+    for (int i = 0; i < data->n_chunks; i++) {
+        __atomic_add_fetch(&data->chunks[i]->refs, 1, __ATOMIC_RELAXED);    // List is owner too, so chunk can`t be freed
+        snap->chunks[i] = data->chunks[i];
+    }
+    data->share();
+
+    snap->n_chunks      = data->n_chunks;
+    snap->head          = lst->head;
+    snap->tail          = lst->tail;
+    snap->capacity      = lst->capacity;
+    snap->size          = lst->size;
+    snap->is_sorted     = lst->is_sorted;
+    snap->sorted_prefix = lst->sorted_prefix;
+
+    return 1;
+}
+
+//! Function releases snapshot (it can be called by reader thread, while writer changes list)
+//! \param snap ptr to ListSnapshot object
+//! \return     1 if success, else 0
+template <typename T> int snapshot_release(ListSnapshot<T>* snap) {
+    ASSERT_IF(VALID_PTR(snap), "Invalid snap ptr", 0);
+
+    for (int i = 0; i < snap->n_chunks; i++) {
+        cow_chunk_unref(snap->chunks[i]);
+    }
+    free(snap->chunks);
+
+    *snap = { };
+    return 1;
+}
+
+//! Function checks fields of snapshot
+//! \param snap ptr to ListSnapshot object
+//! \return     error code (0 if all is good)
+template <typename T> int list_error(ListSnapshot<T>* snap) {
+    if (!VALID_PTR(snap)) {
+        return errors::INVALID_LIST_PTR;
+    }
+    if (snap->chunks == NULL || snap->capacity <= 0 || snap->capacity > snap->n_chunks << LIST_CHUNK_BITS) {
+        return errors::INCORRECT_CAPACITY;
+    }
+    if (0 > snap->head || snap->head >= snap->capacity) {
+        return errors::INCORRECT_HEAD_INDEX;
+    }
+    if (0 > snap->tail || snap->tail >= snap->capacity) {
+        return errors::INCORRECT_TAIL_INDEX;
+    }
+    if (0 > snap->size || snap->size >= snap->capacity) {
+        return errors::INCORRECT_SIZE;
+    }
+
+    return errors::OK;
+}
+
+//! Function gets number of elements of snapshot
+//! \param snap ptr to ListSnapshot object
+//! \return     number of elements
+template <typename T> int list_size(ListSnapshot<T>* snap) {
+    return snap->size;
+}
+
+//! Function gets element of snapshot by logical index
+//! \param snap      ptr to ListSnapshot object
+//! \param log_index logical index
+//! \return          value of element
+template <typename T> T get(ListSnapshot<T>* snap, int log_index) {
+    ASSERT_IF(list_error(snap) == errors::OK, "Check before get func", ListValueTraits<T>::from_error(errors::INVALID_LIST_PTR));
+
+    if (log_index < 0 || log_index >= snap->size) {
+        errno = errors::BAD_LOG_INDEX;
+        return ListValueTraits<T>::from_error(errors::BAD_LOG_INDEX);
+    }
+
+    if (snap->is_sorted || log_index < snap->sorted_prefix) {
+        return snap->value(snap->head + log_index);
+    }
+
+    // Walk from the nearest end
+    int ph_index = 0;
+    if (log_index < snap->size / 2) {
+        ph_index = snap->head;
+        for (int i = 0; i < log_index; i++) ph_index = snap->next(ph_index);
+    } else {
+        ph_index = snap->tail;
+        for (int i = snap->size - 1; i > log_index; i--) ph_index = snap->prev(ph_index);
+    }
+
+    return snap->value(ph_index);
+}
+
+//! Function prints snapshot for user
+//! \param snap ptr to ListSnapshot object
+//! \param sep  ptr to sep string (default ", ")
+//! \param end  ptr to end string (default "\n")
+//! \return     1 if success, else 0
+template <typename T> int print_list(ListSnapshot<T>* snap, const char* sep, const char* end) {
+    ASSERT_IF(list_error(snap) == errors::OK, "Check before print_list func", 0);
+    ASSERT_IF(VALID_PTR(sep), "Invalid sep ptr", 0);
+    ASSERT_IF(VALID_PTR(end), "Invalid end ptr", 0);
+
+    char value_str[MAX_VALUE_STR_SIZE] = "";
+
+    printf("[ ");
+    for (int cell = snap->head; cell != 0; cell = snap->next(cell)) {
+        ListValueTraits<T>::format(value_str, MAX_VALUE_STR_SIZE, snap->value(cell));
+        printf("%3s", value_str);
+
+        if (snap->next(cell) != 0) printf("%s", sep);
+    }
+    printf(" ]%s", end);
+
+    return 1;
+}
+// ----------------------------------------------------------------------------
+
+#endif // LIST_COWH
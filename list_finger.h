@@ -0,0 +1,113 @@
+//
+//  Created by IvanBrekman on 03.11.2021.
+//
+
+#ifndef LIST_FINGERH
+#define LIST_FINGERH
+
+#include <cstdlib>
+
+// Fingers---------------------------------------------------------------------
+// List remembers last resolved (logical, physical) pairs, so get walks from the nearest
+// known element (head, tail or finger) instead of head. Sequential get(i), get(i + 1)
+// calls become O(1). Finger with ph_index == 0 is empty.
+
+//! Function forgets all fingers
+//! \param lst ptr to List object
+LIST_TEMPLATE void list_fingers_reset(LIST_TYPE* lst) {
+    for (int i = 0; i < LIST_FINGERS; i++) {
+        lst->fingers[i] = { };
+    }
+}
+
+//! Function gets logical index of element, if it is known without walking
+//! \param lst      ptr to List object
+//! \param ph_index physical index of element
+//! \return         logical index (-1 if it is unknown)
+LIST_TEMPLATE int list_finger_log(LIST_TYPE* lst, int ph_index) {
+    if (ph_index == lst->head) return 0;
+    if (ph_index == lst->tail) return lst->size - 1;
+
+    for (int i = 0; i < LIST_FINGERS; i++) {
+        if (lst->fingers[i].ph_index == ph_index) return lst->fingers[i].log_index;
+    }
+
+    return -1;
+}
+
+//! Function updates fingers after element was inserted or removed
+//! \param lst       ptr to List object
+//! \param log_index logical index of inserted (or removed) element
+//! \param delta     +1 if element was inserted, -1 if removed
+LIST_TEMPLATE void list_fingers_shift(LIST_TYPE* lst, int log_index, int delta) {
+    for (int i = 0; i < LIST_FINGERS; i++) {
+        ListFinger* finger = &lst->fingers[i];
+        if (finger->ph_index == 0) continue;
+
+        if      (delta < 0 && finger->log_index == log_index) *finger = { };
+        else if (finger->log_index >= log_index)              finger->log_index += delta;
+    }
+}
+
+//! Function updates fingers after cells were swapped (or moved, if second cell was free)
+//! \param lst    ptr to List object
+//! \param first  physical index of first cell
+//! \param second physical index of second cell
+LIST_TEMPLATE void list_fingers_remap(LIST_TYPE* lst, int first, int second) {
+    for (int i = 0; i < LIST_FINGERS; i++) {
+        ListFinger* finger = &lst->fingers[i];
+
+        if      (finger->ph_index == first)  finger->ph_index = second;
+        else if (finger->ph_index == second) finger->ph_index = first;
+    }
+}
+
+//! Function finds physical index of element by walking from the nearest known element
+//! \param lst       ptr to List object
+//! \param log_index logical index (should be (>= 0) and (< size))
+//! \return          physical index
+LIST_TEMPLATE int list_finger_find(LIST_TYPE* lst, int log_index) {
+    int cur_ph   = lst->head;
+    int cur_log  = 0;
+    int distance = log_index;
+    int slot     = -1;
+    const Storage<T>& data = lst->data;
+
+    if (lst->size - 1 - log_index < distance) {
+        cur_ph   = lst->tail;
+        cur_log  = lst->size - 1;
+        distance = cur_log - log_index;
+    }
+
+    for (int i = 0; i < LIST_FINGERS; i++) {
+        ListFinger finger = lst->fingers[i];
+        if (finger.ph_index == 0) continue;
+
+        int finger_distance = abs(finger.log_index - log_index);
+        if (finger_distance < distance) {
+            cur_ph   = finger.ph_index;
+            cur_log  = finger.log_index;
+            distance = finger_distance;
+            slot     = i;
+        }
+    }
+
+    for ( ; cur_log < log_index; cur_log++) cur_ph = data.next(cur_ph);
+    for ( ; cur_log > log_index; cur_log--) cur_ph = data.prev(cur_ph);
+
+    // Moving used finger (or taking the oldest one) to found element----------
+    if (slot < 0) {
+        slot = lst->next_finger;
+        lst->next_finger = (lst->next_finger + 1) % LIST_FINGERS;
+    }
+    lst->fingers[slot] = {
+        .log_index = log_index,
+        .ph_index  = cur_ph
+    };
+    // ------------------------------------------------------------------------
+
+    return cur_ph;
+}
+// ----------------------------------------------------------------------------
+
+#endif // LIST_FINGERH
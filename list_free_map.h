@@ -0,0 +1,186 @@
+//
+//  Created by IvanBrekman on 03.11.2021.
+//
+
+#ifndef LIST_FREE_MAPH
+#define LIST_FREE_MAPH
+
+#include <cstdlib>
+#include <cstring>
+
+// Free map--------------------------------------------------------------------
+// ListFreeMap (see list.h) keeps one bit for each cell: bit is set, if cell is free.
+// While it is on, free cells chain is not used (first_free is 0) and new element takes
+// free cell, which is the nearest to its neighbour, so logical neighbours stay physical
+// neighbours after many pushes and pops.
+
+//! Function allocates free map words for capacity cells (new words are zeroed)
+//! \param map      ptr to ListFreeMap object
+//! \param capacity number of cells
+//! \return         1 if success, else 0
+inline int list_free_map_alloc(ListFreeMap* map, int capacity) {
+    int n_words = (capacity + 63) / 64;
+
+    unsigned long long* new_bits = (unsigned long long*) realloc(map->bits, n_words * sizeof(unsigned long long));
+    if (new_bits == NULL) return 0;
+
+    if (n_words > map->n_words) {
+        memset(new_bits + map->n_words, 0, (n_words - map->n_words) * sizeof(unsigned long long));
+    }
+
+    map->bits    = new_bits;
+    map->n_words = n_words;
+    return 1;
+}
+
+//! Function marks cell as free in free map
+//! \param map  ptr to ListFreeMap object
+//! \param cell physical index of cell
+inline void list_free_map_set(ListFreeMap* map, int cell) {
+    map->bits[cell >> 6] |= 1ULL << (cell & 63);
+}
+
+//! Function marks cell as used in free map
+//! \param map  ptr to ListFreeMap object
+//! \param cell physical index of cell
+inline void list_free_map_clear(ListFreeMap* map, int cell) {
+    map->bits[cell >> 6] &= ~(1ULL << (cell & 63));
+}
+
+//! Function finds free cell, which is the nearest to target cell
+//! \param map    ptr to ListFreeMap object
+//! \param target physical index of desired cell
+//! \return       physical index of free cell (0 if there are no free cells)
+inline int list_free_map_nearest(const ListFreeMap* map, int target) {
+    int word = target >> 6;
+    int bit  = target & 63;
+
+    int after  = -1;
+    int before = -1;
+
+    unsigned long long after_mask  = map->bits[word] & (~0ULL << bit);
+    unsigned long long before_mask = map->bits[word] & ((1ULL << bit) - 1);
+    if (after_mask  != 0) after  = (word << 6) + __builtin_ctzll(after_mask);
+    if (before_mask != 0) before = (word << 6) + 63 - __builtin_clzll(before_mask);
+
+    // Going to both sides word by word. When one side is found, other one can be closer only in next word
+    // (also for side found in word of target: target at bit 0 has cell 63 of previous word at distance 1)
+    int limit = after >= 0 || before >= 0 ? 1 : map->n_words;
+    for (int dist = 1; dist <= limit && (after < 0 || before < 0); dist++) {
+        if (after < 0 && word + dist < map->n_words && map->bits[word + dist] != 0) {
+            after = ((word + dist) << 6) + __builtin_ctzll(map->bits[word + dist]);
+        }
+        if (before < 0 && word - dist >= 0 && map->bits[word - dist] != 0) {
+            before = ((word - dist) << 6) + 63 - __builtin_clzll(map->bits[word - dist]);
+        }
+
+        if ((after >= 0 || before >= 0) && limit > dist + 1) limit = dist + 1;
+    }
+
+    if (after  < 0) return before < 0 ? 0 : before;
+    if (before < 0) return after;
+
+    return after - target <= target - before ? after : before;
+}
+
+//! Function builds free map from cells and drops free cells chain
+//! \param lst ptr to List object
+//! \return    1
+LIST_TEMPLATE int list_free_map_build(LIST_TYPE* lst) {
+    ListFreeMap* map = &lst->free_map;
+    memset(map->bits, 0, map->n_words * sizeof(unsigned long long));
+
+    int capacity = lst->capacity;
+    for (int i = 1; i < capacity; i++) {
+        if (list_cell_is_free(lst, i)) list_free_map_set(map, i);
+    }
+
+    lst->first_free = 0;
+    return 1;
+}
+
+//! Function turns on free map for list
+//! \param lst ptr to List object
+//! \return    1 if success, else 0
+LIST_TEMPLATE int list_free_map_enable(LIST_TYPE* lst) {
+    ASSERT_OK(lst, "Check before list_free_map_enable func", 0);
+
+    if (!list_free_map_alloc(&lst->free_map, lst->capacity)) {
+        free(lst->free_map.bits);
+        lst->free_map = { };
+
+        errno = errors::NOT_ENOUGH_MEMORY;
+        return 0;
+    }
+
+    if (lst->journal != NULL) {
+        list_journal_record(lst, JOURNAL_FREE_MAP, 1, 0, ListValueTraits<T>::uninit());
+    }
+
+    return list_free_map_build(lst);
+}
+
+//! Function turns off free map, frees its memory and rebuilds free cells chain (in increasing order)
+//! \param lst ptr to List object
+//! \return    1 if success, 0 if list is read-only
+LIST_TEMPLATE int list_free_map_disable(LIST_TYPE* lst) {
+    if (lst->free_map.bits == NULL) return 1;
+    if (lst->capacity > 0) LIST_ASSERT_WRITABLE(lst, 0);   // Chain is written to cells (destructed list only frees map)
+    if (lst->capacity > 0) LIST_RESERVE_WRITES(lst, INT_MAX, 0);
+
+    if (lst->journal != NULL) {
+        list_journal_record(lst, JOURNAL_FREE_MAP, 0, 0, ListValueTraits<T>::uninit());
+    }
+
+    free(lst->free_map.bits);
+    lst->free_map = { };
+
+    if (lst->capacity <= 0) return 1;
+
+    int first_free = 0;
+    for (int i = lst->capacity - 1; i > 0; i--) {
+        if (list_cell_is_free(lst, i)) {
+            lst->data.next(i) = first_free;
+            first_free = i;
+        }
+    }
+    lst->first_free = first_free;
+
+    return 1;
+}
+
+//! Function takes free cell, which is the nearest to target cell
+//! \param lst    ptr to List object
+//! \param target physical index of desired cell
+//! \return       physical index of taken cell (0 if list is full)
+LIST_TEMPLATE int list_free_map_take(LIST_TYPE* lst, int target) {
+    if (target < 1)              target = 1;
+    if (target >= lst->capacity) target = lst->capacity - 1;
+
+    int cell = list_free_map_nearest(&lst->free_map, target);
+    if (cell != 0) list_free_map_clear(&lst->free_map, cell);
+
+    return cell;
+}
+
+//! Function adds new cells to free map after capacity growth (lst->capacity should be new_capacity already,
+//! so free cells chain gets new cells, if free map is turned off)
+//! \param lst          ptr to List object
+//! \param capacity     old capacity
+//! \param new_capacity new capacity
+//! \return             1 if success, else 0 (free map is turned off then)
+LIST_TEMPLATE int list_free_map_resize(LIST_TYPE* lst, int capacity, int new_capacity) {
+    if (!list_free_map_alloc(&lst->free_map, new_capacity)) {
+        list_free_map_disable(lst);
+        return 0;
+    }
+
+    for (int i = capacity; i < new_capacity; i++) {
+        list_free_map_set(&lst->free_map, i);
+    }
+
+    return 1;
+}
+// ----------------------------------------------------------------------------
+
+#endif // LIST_FREE_MAPH
@@ -0,0 +1,1326 @@
+//
+//  Created by IvanBrekman on 03.11.2021.
+//
+
+#ifndef LIST_IMPLH
+#define LIST_IMPLH
+
+#include <cstdio>
+#include <cstdlib>
+#include <cassert>
+#include <cerrno>
+#include <ctime>
+
+#define UN poisons::UNINITIALIZED_INT
+#define FR poisons::FREED_ELEMENT
+
+#define UN_VAL ListValueTraits<T>::uninit()
+#define FR_VAL ListValueTraits<T>::freed()
+
+//! List Constructor
+//! \param lst      ptr to List object
+//! \param capacity start List capacity (default BUFFER_DEFAULT_SIZE)
+//! \return         1 if success, ese 0
+LIST_TEMPLATE int list_ctor(LIST_TYPE* lst, int capacity) {
+    LIST_ASSERT_IF(lst, VALID_PTR(lst), "Invalid lst ptr", 0);
+    LIST_ASSERT_IF(lst, capacity > 0,   "Incorrect capacity: (<= 0)", 0);
+
+    if (!lst->data.alloc(capacity)) {
+        errno = errors::NOT_ENOUGH_MEMORY;
+        return 0;
+    }
+
+    lst->head = lst->tail = 0;
+    lst->is_sorted = 1;
+    lst->sorted_prefix = 0;
+    lst->capacity = capacity;
+    lst->size     = 0;
+
+    for (int i = 0; i < capacity; i++) {
+        lst->data.set(i, UN_VAL, i + 1, UN);
+    }
+
+    lst->data.next(0) = 0;
+    lst->data.prev(0) = 0;
+    lst->data.next(capacity - 1) = 0;
+    lst->first_free = 1;
+
+    if (LIST_VALIDATE_LEVEL(lst) >= MEDIUM_VALIDATE) {
+        list_dump(lst, "Check init");
+    }
+
+    ASSERT_OK(lst, "Check corectness of list_ctor", 0);
+    return 1;
+}
+
+//! List Destructor
+//! \param lst      ptr to List object
+//! \return         1 if success, ese 0
+LIST_TEMPLATE int list_dtor(LIST_TYPE* lst) {
+    ASSERT_OK(lst, "Check List before dtor call", 0);
+
+    if (lst->journal != NULL) {
+        list_journal_close(lst);
+    }
+
+    if (LIST_VALIDATE_LEVEL(lst) >= MEDIUM_VALIDATE && lst->data.writable()) {
+        int capacity = lst->capacity;
+        for (int i = 0; i < capacity; i++) {
+            lst->data.set(i, FR_VAL, FR, FR);
+        }
+    }
+
+    lst->capacity = lst->head = lst->tail = -1;
+    lst->size       = -1;
+    lst->is_sorted  = -1;
+    lst->first_free = -1;
+    lst->sorted_prefix = -1;
+
+    if (LIST_VALIDATE_LEVEL(lst) >= MEDIUM_VALIDATE) {
+        list_dump(lst, "Check deinit");
+    }
+
+    list_rank_disable(lst);
+    list_free_map_disable(lst);
+    lst->data.release();
+    return 1;
+}
+
+//! Function to detect errors in list
+//! \param lst pointer to List object
+//! \return    error code (0 if all is good)
+LIST_TEMPLATE int list_error(LIST_TYPE* lst) {
+    if (!VALID_PTR(lst)) {
+        return errors::INVALID_LIST_PTR;
+    }
+
+    if (lst->capacity <= 0) {
+        return errors::INCORRECT_CAPACITY;
+    }
+
+    if (0 > lst->first_free || lst->first_free >= lst->capacity) {
+        return errors::INCORRECT_FIFST_FREE;
+    }
+    if (0 > lst->is_sorted || lst->is_sorted > 1) {
+        return errors::INCORRECT_SORTED_VAL;
+    }
+    if (0 > lst->head || lst->head >= lst->capacity) {
+        return errors::INCORRECT_HEAD_INDEX;
+    }
+    if (0 > lst->tail || lst->tail >= lst->capacity) {
+        return errors::INCORRECT_TAIL_INDEX;
+    }
+    if (0 > lst->sorted_prefix || lst->sorted_prefix >= lst->capacity) {
+        return errors::INCORRECT_PREFIX;
+    }
+    if (0 > lst->size || lst->size >= lst->capacity) {
+        return errors::INCORRECT_SIZE;
+    }
+
+    return errors::OK;
+}
+
+//! Function find free cell
+//! \param lst    ptr to List object
+//! \param target desired cell (used only with free map, default 0)
+//! \return       free cell index (0 if list is full)
+LIST_TEMPLATE int find_free_cell(LIST_TYPE* lst, int target) {
+    ASSERT_OK(lst, "Check before find_free_cell func", -1);
+
+    int free_cell = list_take_free_cell(lst, target);
+
+    ASSERT_OK(lst, "Check before find_free_cell func", -1);
+    return free_cell;
+}
+
+//! Function takes free cell without checks: the nearest to target if free map is on, else first free
+//! \param lst    ptr to List object
+//! \param target desired cell
+//! \return       free cell index (0 if list is full)
+LIST_TEMPLATE int list_take_free_cell(LIST_TYPE* lst, int target) {
+    if (lst->free_map.bits != NULL) {
+        return list_free_map_take(lst, target);
+    }
+
+    int free_cell = lst->first_free;
+    if (free_cell != 0) {
+        lst->first_free = lst->data.next(free_cell);
+    }
+
+    return free_cell;
+}
+
+//! Function marks cell as free and gives it back to free cells chain (or free map)
+//! \param lst      ptr to List object
+//! \param ph_index physical index of cell (should be already unlinked from list)
+LIST_TEMPLATE void list_release_cell(LIST_TYPE* lst, int ph_index) {
+    if (lst->free_map.bits != NULL) {
+        lst->data.set(ph_index, FR_VAL, 0, UN);
+        list_free_map_set(&lst->free_map, ph_index);
+        return;
+    }
+
+    lst->data.set(ph_index, FR_VAL, lst->first_free, UN);
+    lst->first_free = ph_index;     // Making deleting index as first free
+}
+
+//! Function resize capacity of list
+//! \param lst      ptr to List object
+//! \param new_size new capacity value
+//! \return         new capacity (0 if error in func)
+LIST_TEMPLATE int resize_list_capacity(LIST_TYPE* lst, int new_size) {
+    ASSERT_OK(lst, "Check before resize_list_capacity func", 0);
+    LIST_ASSERT_WRITABLE(lst, errors::READ_ONLY_LIST);
+    LIST_ASSERT_IF(lst, new_size > lst->capacity, "Incorrect new_size. Should be (> capacity)", 0);
+
+    // Free map, which can`t grow, is turned off: it writes free cells chain to all free cells
+    LIST_RESERVE_WRITES(lst, lst->free_map.bits != NULL ? INT_MAX : LIST_CELL_WRITES, errors::NOT_ENOUGH_MEMORY);
+
+    PRINT_WARNING("!WARNING! List is to small. List capacity has increased, but it`s to slow.\n"
+                  "          Recreate List with bigger capacity to speed up list working.\n");
+
+    int capacity = lst->capacity;
+    if (!lst->data.grow(capacity, new_size)) {
+        ERROR_DUMP(lst, "Not enough memory", UN);
+
+        errno = errors::NOT_ENOUGH_MEMORY;
+        return errors::NOT_ENOUGH_MEMORY;
+    }
+
+    for (int i = capacity; i < new_size; i++) {
+        lst->data.set(i, UN_VAL, i + 1, UN);
+    }
+    lst->data.next(new_size - 1) = 0;
+    lst->capacity = new_size;
+
+    // New cells are linked after old free cells (resize can be called, while list has free cells)
+    if (lst->free_map.bits != NULL) {
+        list_free_map_resize(lst, capacity, new_size);      // If it fails, free cells chain is built from all cells
+    } else if (lst->first_free == 0) {
+        lst->first_free = capacity;
+    } else {
+        const Storage<T>& data = lst->data;     // Walk reads cells, so shared chunks aren`t copied
+
+        int last_free = lst->first_free;
+        while (data.next(last_free) != 0) last_free = data.next(last_free);
+
+        lst->data.next(last_free) = capacity;
+    }
+
+    if (lst->rank.block_of != NULL) {
+        if (!list_rank_alloc(&lst->rank, new_size)) list_rank_disable(lst);
+        else                                         list_rank_build(lst);
+    }
+    if (lst->journal != NULL) {
+        list_journal_record(lst, JOURNAL_RESIZE, new_size, 0, UN_VAL);
+    }
+
+    ASSERT_OK(lst, "Check after resize_list_capacity func", 0);
+    return lst->capacity;
+}
+
+//! Function sorts list by logical indexes
+//! \param lst ptr to List object
+//! \return    1 if success, else 0
+LIST_TEMPLATE int please_dont_use_sorted_by_next_values_func_because_it_too_slow__also_do_you_really_need_it__i_think_no__so_dont_do_stupid_things_and_better_look_at_memes_about_cats(LIST_TYPE* lst) {
+    ASSERT_OK(lst, "Check before sorting func", 0);
+    LIST_ASSERT_WRITABLE(lst, 0);
+
+    if (lst->head == 0) {       // Empty list: there are no elements to copy
+        lst->is_sorted = 1;
+
+        if (lst->journal != NULL) {
+            list_journal_record(lst, JOURNAL_SORT, 0, 0, UN_VAL);
+        }
+        return 1;
+    }
+
+    int capacity = lst->capacity;
+    Storage<T> sorted_list = { };
+
+    if (!sorted_list.alloc(capacity)) {
+        ERROR_DUMP(lst, "Not enough memory", UN);
+
+        errno = errors::NOT_ENOUGH_MEMORY;
+        return errors::NOT_ENOUGH_MEMORY;
+    }
+
+    // Fill zero index---------------------------------------------------------
+    sorted_list.set(0, UN_VAL, 1, 1);
+    // ------------------------------------------------------------------------
+
+    const Storage<T>& data = lst->data;         // Old cells are only read: they are replaced by new storage
+
+    int head_tmp = lst->head;
+    for (int i = 1; ; head_tmp = data.next(head_tmp), i++) {
+        sorted_list.set(i, data.value(head_tmp), i + 1, i - 1);
+
+        if (data.next(head_tmp) == 0) {
+            for (int index_zero = i + 1; index_zero < capacity; index_zero++) {
+                sorted_list.set(index_zero, UN_VAL, index_zero + 1, UN);
+            }
+
+            sorted_list.next(i) = 0;
+            sorted_list.prev(0) = i;
+            sorted_list.next(capacity - 1) = 0;
+            lst->tail = i;
+            lst->first_free = i + 1 < capacity ? i + 1 : 0;
+            break;
+        };
+    }
+
+    lst->data.release();
+    lst->data = sorted_list;
+
+    lst->head = 1;
+    lst->is_sorted = 1;
+
+    if (lst->rank.block_of != NULL) {
+        list_rank_build(lst);
+    }
+    if (lst->free_map.bits != NULL) {
+        list_free_map_build(lst);
+    }
+    list_fingers_reset(lst);
+
+    if (lst->journal != NULL) {
+        list_journal_record(lst, JOURNAL_SORT, 0, 0, UN_VAL);
+    }
+
+    ASSERT_OK(lst, "Check after sorting func", 0);
+    return 1;
+}
+
+//! Function swaps two used cells of list and fixes links of their neighbours
+//! \param lst     ptr to List object
+//! \param first   physical index of first cell
+//! \param second  physical index of second cell
+//! \note head and tail are not updated, caller should take them from zero cell
+LIST_TEMPLATE void swap_list_cells(LIST_TYPE* lst, int first, int second) {
+    T   value = lst->data.value(first);
+    int next  = lst->data.next (first);
+    int prev  = lst->data.prev (first);
+
+    lst->data.set(first, lst->data.value(second), lst->data.next(second), lst->data.prev(second));
+    lst->data.set(second, value, next, prev);
+
+    // Cells can be neighbours, so links to each other should be swapped too---
+    int cells[] = { first, second };
+    for (int i = 0; i < 2; i++) {
+        int* links[] = { &lst->data.next(cells[i]), &lst->data.prev(cells[i]) };
+
+        for (int j = 0; j < 2; j++) {
+            if      (*links[j] == first)  *links[j] = second;
+            else if (*links[j] == second) *links[j] = first;
+        }
+    }
+    // ------------------------------------------------------------------------
+
+    for (int i = 0; i < 2; i++) {
+        lst->data.next(lst->data.prev(cells[i])) = cells[i];
+        lst->data.prev(lst->data.next(cells[i])) = cells[i];
+    }
+
+    if (lst->rank.block_of != NULL) {
+        list_rank_swap(lst, first, second);
+    }
+    list_fingers_remap(lst, first, second);
+}
+
+//! Function moves used cell to free cell and fixes links of its neighbours
+//! \param lst  ptr to List object
+//! \param from physical index of used cell
+//! \param to   physical index of free cell
+//! \note from cell becomes free, but isn`t added to free cells chain
+LIST_TEMPLATE void move_list_cell(LIST_TYPE* lst, int from, int to) {
+    int next = lst->data.next(from);
+    int prev = lst->data.prev(from);
+
+    lst->data.set(to, lst->data.value(from), next, prev);
+    lst->data.next(prev) = to;
+    lst->data.prev(next) = to;
+
+    lst->data.set(from, FR_VAL, 0, UN);
+
+    if (lst->rank.block_of != NULL) {
+        list_rank_move(lst, from, to);
+    }
+    list_fingers_remap(lst, from, to);
+}
+
+//! Function reorders cells by logical indexes in place (without extra buffer)
+//! \param lst ptr to List object
+//! \return    1 if success, else 0
+//! \note logical element i goes to cell i + 1 by swaps along next links: O(n) time and O(1) memory.
+//!       Use it instead of please_dont_use_sorted_by_next_values_func_... on big lists
+LIST_TEMPLATE int list_linearize(LIST_TYPE* lst) {
+    ASSERT_OK(lst, "Check before list_linearize func", 0);
+    LIST_ASSERT_WRITABLE(lst, 0);
+    LIST_RESERVE_WRITES(lst, INT_MAX, 0);
+
+    int target = 1;
+    for (int cur = lst->head; cur != 0; cur = lst->data.next(target), target++) {
+        if (cur == target) continue;
+
+        if (list_cell_is_free(lst, target)) move_list_cell(lst, cur, target);
+        else                                swap_list_cells(lst, cur, target);
+    }
+
+    int size     = target - 1;
+    int capacity = lst->capacity;
+
+    lst->size = size;
+
+    // Rebuilding head, tail and zero cell-------------------------------------
+    lst->head = size > 0 ? 1 : 0;
+    lst->tail = size;
+
+    lst->data.next(0) = lst->head;
+    lst->data.prev(0) = lst->tail;
+    // ------------------------------------------------------------------------
+
+    // Rebuilding free cells chain (in increasing order)-----------------------
+    for (int i = size + 1; i < capacity; i++) {
+        lst->data.next(i) = i + 1;
+        lst->data.prev(i) = UN;
+    }
+    if (size + 1 < capacity) {
+        lst->data.next(capacity - 1) = 0;
+    }
+    lst->first_free = size + 1 < capacity ? size + 1 : 0;
+
+    if (lst->free_map.bits != NULL) {
+        list_free_map_build(lst);
+    }
+    // ------------------------------------------------------------------------
+
+    lst->is_sorted = 1;
+
+    if (lst->journal != NULL) {
+        list_journal_record(lst, JOURNAL_LINEARIZE, 0, 0, UN_VAL);
+    }
+
+    ASSERT_OK(lst, "Check after list_linearize func", 0);
+    return 1;
+}
+
+//! Function removes free cell from free cells chain
+//! \param lst      ptr to List object
+//! \param ph_index physical index of free cell
+//! \note chain is singly linked, so removing not first cell walks the chain (list_compact_step turns on free map)
+LIST_TEMPLATE void unlink_free_cell(LIST_TYPE* lst, int ph_index) {
+    if (lst->free_map.bits != NULL) {
+        list_free_map_clear(&lst->free_map, ph_index);
+        return;
+    }
+
+    if (lst->first_free == ph_index) {
+        lst->first_free = lst->data.next(ph_index);
+        return;
+    }
+
+    const Storage<T>& data = lst->data;
+    for (int i = lst->first_free; i != 0; i = data.next(i)) {
+        if (data.next(i) == ph_index) {
+            lst->data.next(i) = data.next(ph_index);
+            return;
+        }
+    }
+}
+
+//! Function puts used cell to another place (swaps with used cell or moves to free one)
+//! \param lst     ptr to List object
+//! \param from    physical index of used cell
+//! \param to      physical index of new place
+//! \param tracked ptr to physical index, which is updated if its cell moves (default NULL)
+//! \note head, tail and free cells chain stay correct
+LIST_TEMPLATE void place_list_cell(LIST_TYPE* lst, int from, int to, int* tracked) {
+    if (list_cell_is_free(lst, to)) {
+        unlink_free_cell(lst, to);
+        move_list_cell(lst, from, to);
+
+        list_release_cell(lst, from);
+    } else {
+        swap_list_cells(lst, from, to);
+    }
+
+    if      (lst->head == from) lst->head = to;
+    else if (lst->head == to)   lst->head = from;
+
+    if      (lst->tail == from) lst->tail = to;
+    else if (lst->tail == to)   lst->tail = from;
+
+    if (tracked != NULL) {
+        if      (*tracked == from) *tracked = to;
+        else if (*tracked == to)   *tracked = from;
+    }
+}
+
+//! Function gets number of first logical elements, which lie in cells head, head + 1, ...
+//! \param lst ptr to List object
+//! \return    length of sorted prefix
+LIST_TEMPLATE int list_sorted_prefix(LIST_TYPE* lst) {
+    if (lst->is_sorted) {
+        return lst->head == 0 ? 0 : lst->tail - lst->head + 1;
+    }
+
+    return lst->sorted_prefix;
+}
+
+//! Function makes a bounded step of list compaction: moves elements after sorted prefix to its end
+//! \param lst    ptr to List object
+//! \param budget  max number of checked cells
+//! \param tracked ptr to physical index, which is updated if its cell moves (default NULL)
+//! \return        number of moved cells
+//! \note get works in O(1) for elements inside sorted prefix, when prefix covers all list is_sorted becomes 1
+LIST_TEMPLATE int list_compact_step(LIST_TYPE* lst, int budget, int* tracked) {
+    ASSERT_OK(lst, "Check before list_compact_step func", 0);
+    LIST_ASSERT_IF(lst, budget > 0, "Incorrect budget. Should be (> 0)", 0);
+    LIST_ASSERT_WRITABLE(lst, 0);
+    LIST_RESERVE_WRITES(lst, (long long)LIST_CELL_WRITES * budget, 0);
+
+    // Compaction takes exact free cells: free map unlinks them in O(1), free cells chain would be walked
+    if (!lst->is_sorted && lst->free_map.bits == NULL && !list_free_map_enable(lst)) {
+        return 0;
+    }
+
+    if (lst->journal != NULL) {     // Step is recorded before changes: replay repeats the same step
+        list_journal_record(lst, JOURNAL_COMPACT, budget, 0, UN_VAL);
+    }
+
+    if (lst->is_sorted) {
+        return 0;
+    }
+    if (lst->head == 0) {
+        lst->sorted_prefix = 0;
+        lst->is_sorted     = 1;
+        return 0;
+    }
+
+    int moved = 0;
+    for ( ; budget > 0; budget--) {
+        int prefix = lst->sorted_prefix;
+
+        if (prefix > 0 && lst->data.next(lst->head + prefix - 1) == 0) {
+            lst->is_sorted = 1;
+            break;
+        }
+
+        // Starting prefix from first cell, if it can`t grow from head---------
+        if (prefix == 0 || (lst->head + prefix >= lst->capacity && lst->head != 1)) {
+            if (lst->head != 1) {
+                place_list_cell(lst, lst->head, 1, tracked);
+                moved++;
+            }
+
+            lst->sorted_prefix = 1;
+            continue;
+        }
+        // --------------------------------------------------------------------
+
+        int last = lst->head + prefix - 1;
+        int next = lst->data.next(last);
+
+        if (next != last + 1) {
+            place_list_cell(lst, next, last + 1, tracked);
+            moved++;
+        }
+
+        lst->sorted_prefix = prefix + 1;
+    }
+
+    ASSERT_OK(lst, "Check after list_compact_step func", 0);
+    return moved;
+}
+
+//! Function checks if cell is not used by list
+//! \param lst      ptr to List object
+//! \param ph_index physical index of cell
+//! \return         1 if cell is free, else 0
+//! \note free cell is detected by prev link, so it works for any value type
+LIST_TEMPLATE int list_cell_is_free(const LIST_TYPE* lst, int ph_index) {
+    int prev = lst->data.prev(ph_index);
+
+    return prev == UN || prev == FR;
+}
+
+//! Function defines, if value of cell is poisoned (used by dumps)
+//! \param lst      ptr to List object
+//! \param ph_index physical index of cell
+//! \return         UNINITIALIZED_INT or FREED_ELEMENT if value is poisoned, else 0
+//! \note types without poison values (see ListValueTraits) are checked by links
+LIST_TEMPLATE int list_value_poison(const LIST_TYPE* lst, int ph_index) {
+    if constexpr (ListValueTraits<T>::HAS_POISON) {
+        T value = lst->data.value(ph_index);
+
+        if (value == UN_VAL) return UN;
+        if (value == FR_VAL) return FR;
+        return 0;
+    } else {
+        if (ph_index == 0) return UN;
+
+        return list_cell_is_free(lst, ph_index) ? FR : 0;
+    }
+}
+
+//! Function gets element by logical_index
+//! \param lst       ptr to List object
+//! \param log_index logical index
+//! \return          element by logical index (poisons::UNINITIALIZED_INT if error in func)
+LIST_TEMPLATE T get(LIST_TYPE* lst, int log_index) {
+    ASSERT_OK(lst, "Check before get func", UN_VAL);
+    LIST_ASSERT_IF(lst, 0 <= log_index && log_index < lst->capacity - 1, "Incorrect logical index. Should be (> 0) and (< capacity)", UN_VAL);
+
+    const Storage<T>& data = lst->data;     // Const accessors: reads don`t copy chunks shared with snapshots
+
+    if (lst->is_sorted || log_index < lst->sorted_prefix) {
+        LIST_LOG1(lst, printf("Quick get\n"););
+        int ph_index = (lst->head) + log_index;
+
+        if (lst->head == 0 || ph_index >= lst->capacity || list_cell_is_free(lst, ph_index)) {
+            ERROR_DUMP(lst, "List index out of range", UN_VAL);
+
+            errno = errors::BAD_LOG_INDEX;
+            return ListValueTraits<T>::from_error(errors::BAD_LOG_INDEX);
+        }
+
+        return data.value(ph_index);
+    }
+
+    if (lst->rank.block_of != NULL) {
+        LIST_LOG1(lst, printf("Rank get\n"););
+        int ph_index = list_rank_find(lst, log_index);
+
+        if (ph_index == 0) {
+            ERROR_DUMP(lst, "List index out of range", UN_VAL);
+
+            errno = errors::BAD_LOG_INDEX;
+            return ListValueTraits<T>::from_error(errors::BAD_LOG_INDEX);
+        }
+
+        return data.value(ph_index);
+    }
+
+    if (log_index >= lst->size) {
+        ERROR_DUMP(lst, "List index out of range", UN_VAL);
+
+        errno = errors::BAD_LOG_INDEX;
+        return ListValueTraits<T>::from_error(errors::BAD_LOG_INDEX);
+    }
+
+    LIST_LOG1(lst, printf("Long get\n"););
+    return data.value(list_finger_find(lst, log_index));
+}
+
+//! Function finds element with value
+//! \param lst   ptr to List object
+//! \param value searched value
+//! \return      physical index of found element (0 if there is no such element)
+//! \note scan goes through cells in physical order (first match in logical order if list is sorted),
+//!       so with SoaStorage it reads only dense values array
+LIST_TEMPLATE int find_value(LIST_TYPE* lst, LIST_VALUE value) {
+    ASSERT_OK(lst, "Check before find_value func", 0);
+
+    const Storage<T>& data = lst->data;
+
+    int capacity = lst->capacity;
+    for (int i = 1; i < capacity; i++) {
+        if (ListValueTraits<T>::equal(data.value(i), value) && !list_cell_is_free(lst, i)) {
+            return i;
+        }
+    }
+
+    return 0;
+}
+
+//! Function inserts value after ph_index
+//! \param lst      ptr to List object
+//! \param value    inserted value
+//! \param ph_index physical index of element, after which need to insert
+//! \return         physical index of inserted element
+LIST_TEMPLATE int push_index(LIST_TYPE* lst, LIST_VALUE value, int ph_index) {
+    ASSERT_OK(lst, "Check before push_index func", 0);
+    LIST_ASSERT_IF(lst, 0 <= ph_index && ph_index < lst->capacity, "Incorrect ph_index. Index should be (>= 0) and (< capacity)", 0);
+    LIST_ASSERT_WRITABLE(lst, errors::READ_ONLY_LIST);
+    LIST_RESERVE_WRITES(lst, (long long)LIST_CELL_WRITES * (1 + lst->compact_budget), errors::NOT_ENOUGH_MEMORY);
+
+    if (lst->data.prev(ph_index) == UN) {
+        ERROR_DUMP(lst, "Push after invalid element. Incorrect physical index", 0);
+
+        errno = errors::BAD_PH_INDEX;
+        return  errors::BAD_PH_INDEX;
+    }
+
+    // Find next_index where insert (free map takes the nearest cell to neighbour).
+    // It goes before other changes: list stays the same, if there is no memory for bigger capacity
+    int target     = ph_index == 0 ? lst->head - 1 : ph_index + 1;
+    int next_index = find_free_cell(lst, target);
+
+    if (next_index == 0 && resize_list_capacity(lst, lst->capacity * 2) > 0) {
+        next_index = find_free_cell(lst, target);
+    }
+    if (next_index <= 0) {
+        ERROR_DUMP(lst, "Not enough memory", 0);
+
+        errno = errors::NOT_ENOUGH_MEMORY;
+        return  errors::NOT_ENOUGH_MEMORY;
+    }
+    LIST_ASSERT_IF(lst, 0 < next_index && next_index < lst->capacity, "Incorrect next index", 0);
+    // ------------------------------------------------------------------------
+
+    // Elements after ph_index move, so they leave sorted prefix---------------
+    int prefix = list_sorted_prefix(lst);
+    if (ph_index == 0) {
+        prefix = 0;
+    } else if (lst->head <= ph_index && ph_index < lst->head + prefix) {
+        prefix = ph_index - lst->head + 1;
+    }
+
+    int ph_log = ph_index == 0 ? -1 : list_finger_log(lst, ph_index);
+    if (ph_index == 0 || ph_log >= 0) list_fingers_shift(lst, ph_log + 1, +1);
+    else                              list_fingers_reset(lst);
+    // ------------------------------------------------------------------------
+
+    // Adding new element data-------------------------------------------------
+    lst->data.set(next_index, value, lst->data.next(ph_index), ph_index);
+    // ------------------------------------------------------------------------
+
+    lst->data.prev(lst->data.next(ph_index)) = next_index;  // Changing prev value for element, before which inserted element
+    lst->data.next(ph_index) = next_index;                  // Changing next value for element, after which we insert
+
+    if (lst->rank.block_of != NULL) {
+        list_rank_insert(lst, ph_index, next_index);
+    }
+
+    // Updating head and tail index (if it need)-------------------------------
+    if (ph_index == 0) {
+        lst->head = next_index;
+    }
+    if (lst->tail == ph_index) {
+        lst->tail = next_index;
+    }
+    lst->is_sorted     = 0;
+    lst->sorted_prefix = prefix;
+    lst->size++;
+    // ------------------------------------------------------------------------
+
+    if (lst->journal != NULL) {     // Recorded before compaction, which records its own step
+        list_journal_record(lst, JOURNAL_PUSH, ph_index, next_index, value);
+    }
+
+    if (lst->compact_budget > 0) {
+        list_compact_step(lst, lst->compact_budget, &next_index);
+    }
+
+    ASSERT_OK(lst, "Check after push_index func", 0);
+    return next_index;
+}
+
+//! Function pops element by ph_index
+//! \param lst      ptr to List object
+//! \param ph_index physical index of popped element
+//! \return         popped value
+LIST_TEMPLATE T pop_index(LIST_TYPE* lst, int ph_index) {
+    ASSERT_OK(lst, "Check before pop_index func", UN_VAL);
+    LIST_ASSERT_IF(lst, 0 < ph_index && ph_index < lst->capacity, "Incorrect ph_index. Index should be (> 0) and (< capacity)", UN_VAL);
+    LIST_ASSERT_WRITABLE(lst, ListValueTraits<T>::from_error(errors::READ_ONLY_LIST));
+    LIST_RESERVE_WRITES(lst, (long long)LIST_CELL_WRITES * (1 + lst->compact_budget), ListValueTraits<T>::from_error(errors::NOT_ENOUGH_MEMORY));
+
+    if (lst->head == lst->tail && lst->tail == 0) {
+        ERROR_DUMP(lst, "Cannot pop from empty lst", UN_VAL);
+
+        errno = errors::LST_EMPTY;
+        return ListValueTraits<T>::from_error(errors::LST_EMPTY);
+    }
+    if (lst->data.prev(ph_index) == UN) {
+        ERROR_DUMP(lst, "Pop invalid element. Incorrect physical index", UN_VAL);
+
+        errno = errors::BAD_PH_INDEX;
+        return ListValueTraits<T>::from_error(errors::BAD_PH_INDEX);
+    }
+
+    T   pop_val    = lst->data.value(ph_index);
+    int next_index = lst->data.next(ph_index);
+    int prev_index = lst->data.prev(ph_index);
+
+    // Elements after ph_index move, so they leave sorted prefix---------------
+    int prefix = list_sorted_prefix(lst);
+    if (lst->head <= ph_index && ph_index < lst->head + prefix) {
+        prefix = ph_index == lst->head ? prefix - 1 : ph_index - lst->head;
+    }
+
+    int ph_log = list_finger_log(lst, ph_index);
+    if (ph_log >= 0) list_fingers_shift(lst, ph_log, -1);
+    else             list_fingers_reset(lst);
+    // ------------------------------------------------------------------------
+
+    // Updating head and tail index (if it need)-------------------------------
+    lst->is_sorted = lst->is_sorted && (ph_index == lst->head || ph_index == lst->tail);   // Popping from ends keeps list sorted
+
+    if (ph_index == lst->head) {
+        lst->head = next_index;
+    }
+    if (ph_index == lst->tail) {
+        lst->tail = prev_index;
+    }
+    lst->sorted_prefix = prefix;
+    lst->size--;
+    // ------------------------------------------------------------------------
+
+    lst->data.next(prev_index) = next_index;    // Changing next value for element, after which we delete
+    lst->data.prev(next_index) = prev_index;    // Changing prev value for element, before which deleted element
+
+    if (lst->rank.block_of != NULL) {           // Index can be rebuilt inside, so it is called after unlinking
+        list_rank_remove(lst, ph_index);
+    }
+
+    list_release_cell(lst, ph_index);           // Deleting element data and updating first_free index
+
+    if (lst->journal != NULL) {
+        list_journal_record(lst, JOURNAL_POP, ph_index, 0, pop_val);
+    }
+
+    if (lst->compact_budget > 0) {
+        list_compact_step(lst, lst->compact_budget);
+    }
+
+    ASSERT_OK(lst, "Check after pop_index func", UN_VAL);
+    return pop_val;
+}
+
+//! Function inserts value after tail
+//! \param lst   ptr to List object
+//! \param value inserted value
+//! \return      index of inserted element
+LIST_TEMPLATE int push_back(LIST_TYPE* lst, LIST_VALUE value) {
+    ASSERT_OK(lst, "Check before push_back func", 0);
+
+    return push_index(lst, value, lst->tail);
+}
+
+//! Function pops vaue by tail index
+//! \param lst ptr to List object
+//! \return    popped value
+LIST_TEMPLATE T pop_back(LIST_TYPE* lst) {
+    ASSERT_OK(lst, "Check before pop_back func", UN_VAL);
+
+    return pop_index(lst, lst->tail);
+}
+
+// Function inserts before head index
+//! \param lst   ptr to List object
+//! \param value inserted value
+//! \return      index of inserted element
+LIST_TEMPLATE int push_front(LIST_TYPE* lst, LIST_VALUE value) {
+    ASSERT_OK(lst, "Check before push_front func", 0);
+
+    return push_index(lst, value, 0);
+}
+
+//! Function pops element by head index
+//! \param lst ptr to List object
+//! \return    popped value
+LIST_TEMPLATE T pop_front(LIST_TYPE* lst) {
+    ASSERT_OK(lst, "Check before pop_front func", UN_VAL);
+
+    return pop_index(lst, lst->head);
+}
+
+//! Function inserts n values from array after tail. Growth is reserved once and cells are linked
+//! in one pass, list stays sorted if taken free cells continue tail
+//! \param lst    ptr to List object
+//! \param values ptr to array of inserted values
+//! \param n      number of inserted values
+//! \return       1 if success, else 0
+LIST_TEMPLATE int push_back_n(LIST_TYPE* lst, const LIST_VALUE* values, int n) {
+    ASSERT_OK(lst, "Check before push_back_n func", 0);
+    LIST_ASSERT_IF(lst, n >= 0, "Incorrect n. Should be (>= 0)", 0);
+    LIST_ASSERT_IF(lst, n == 0 || VALID_PTR(values), "Invalid values ptr", 0);
+    LIST_ASSERT_WRITABLE(lst, 0);
+    LIST_RESERVE_WRITES(lst, (long long)LIST_CELL_WRITES * (1 + n + lst->compact_budget), 0);
+
+    int size = lst->size;
+    if (lst->capacity - 1 - size < n) {
+        int new_capacity = lst->capacity * 2;
+        if (new_capacity < size + n + 1) new_capacity = size + n + 1;
+
+        if (resize_list_capacity(lst, new_capacity) != new_capacity) return 0;
+    }
+
+    int prefix = list_sorted_prefix(lst);
+    int last   = lst->tail;
+
+    for (int i = 0; i < n; i++) {
+        int cell = list_take_free_cell(lst, last + 1);
+
+        lst->data.set(cell, values[i], 0, last);
+        lst->data.next(last) = cell;
+
+        // Whole list lies in cells head, head + 1, ..., so new element can continue it--------
+        if (prefix == size + i && (size + i == 0 || cell == last + 1)) {
+            prefix++;
+        }
+
+        if (lst->rank.block_of != NULL) {
+            list_rank_insert(lst, last, cell);
+        }
+        if (lst->journal != NULL) {
+            list_journal_record(lst, JOURNAL_PUSH_BACK, last, cell, values[i]);
+        }
+        last = cell;
+    }
+
+    // Updating head, tail and zero cell---------------------------------------
+    lst->data.prev(0) = last;
+
+    lst->head = lst->data.next(0);
+    lst->tail = last;
+    lst->size = size + n;
+
+    lst->is_sorted     = prefix == lst->size;
+    lst->sorted_prefix = prefix;
+    // ------------------------------------------------------------------------
+
+    if (lst->compact_budget > 0) {
+        list_compact_step(lst, lst->compact_budget);
+    }
+
+    ASSERT_OK(lst, "Check after push_back_n func", 0);
+    return 1;
+}
+
+//! Function pops n elements from head
+//! \param lst    ptr to List object
+//! \param values ptr to array for popped values (can be NULL)
+//! \param n      number of popped elements
+//! \return       1 if success, else 0
+LIST_TEMPLATE int pop_front_n(LIST_TYPE* lst, LIST_VALUE* values, int n) {
+    ASSERT_OK(lst, "Check before pop_front_n func", 0);
+    LIST_ASSERT_IF(lst, n >= 0, "Incorrect n. Should be (>= 0)", 0);
+    LIST_ASSERT_WRITABLE(lst, 0);
+
+    if (n > lst->size) {
+        ERROR_DUMP(lst, "Cannot pop more elements, than list has", 0);
+
+        errno = errors::LST_EMPTY;
+        return 0;
+    }
+    LIST_RESERVE_WRITES(lst, (long long)LIST_CELL_WRITES * (1 + n + lst->compact_budget), 0);
+
+    int prefix = list_sorted_prefix(lst);
+    lst->sorted_prefix = prefix > n ? prefix - n : 0;   // Popping from head keeps list sorted
+
+    for (int i = 0; i < n; i++) {
+        int cell = lst->head;
+        int next = lst->data.next(cell);
+
+        if (values != NULL) values[i] = lst->data.value(cell);
+
+        // Unlinking head------------------------------------------------------
+        lst->data.next(0)    = next;
+        lst->data.prev(next) = 0;
+
+        lst->head = next;
+        if (next == 0) lst->tail = 0;
+        lst->size--;
+        // --------------------------------------------------------------------
+
+        if (lst->rank.block_of != NULL) {
+            list_rank_remove(lst, cell);
+        }
+        list_fingers_shift(lst, 0, -1);
+
+        if (lst->journal != NULL) {
+            list_journal_record(lst, JOURNAL_POP, cell, 0, lst->data.value(cell));
+        }
+        list_release_cell(lst, cell);
+    }
+
+    if (lst->compact_budget > 0) {
+        list_compact_step(lst, lst->compact_budget);
+    }
+
+    ASSERT_OK(lst, "Check after pop_front_n func", 0);
+    return 1;
+}
+
+//! Function prints list for user
+//! \param lst ptr to List object
+//! \param sep ptr to sep string (default ", ")
+//! \param end ptr to end string (default "\n")
+//! \return    1 if success, else 0
+LIST_TEMPLATE int print_list(LIST_TYPE* lst, const char* sep, const char* end) {
+    ASSERT_OK(lst, "Check before print_list func", 0);
+    ASSERT_IF(VALID_PTR(sep), "Invalid sep ptr", 0);
+    ASSERT_IF(VALID_PTR(end), "Invalid end ptr", 0);
+
+    const Storage<T>& data = lst->data;
+
+    if (lst->head == lst->tail) {
+        printf("[  ]%s", end);
+        return 1;
+    }
+
+    int  head_tmp = lst->head;
+    char value_str[MAX_VALUE_STR_SIZE] = "";
+
+    printf("[ ");
+    for ( ; ; head_tmp = data.next(head_tmp)) {
+        ListValueTraits<T>::format(value_str, MAX_VALUE_STR_SIZE, data.value(head_tmp));
+        printf("%3s", value_str);
+
+        if (data.next(head_tmp) == 0) break;
+        else printf("%s", sep);
+    }
+    printf(" ]%s", end);
+
+    return 1;
+}
+
+//! Function measures physical locality of list: share of logical neighbours, which lie
+//! not farther than LIST_NEAR_CELLS cells from each other
+//! \param lst ptr to List object
+//! \return    value from 0 (all links jump far) to 1 (all links are near)
+LIST_TEMPLATE double list_locality(LIST_TYPE* lst) {
+    ASSERT_OK(lst, "Check before list_locality func", 0);
+
+    const Storage<T>& data = lst->data;
+
+    if (lst->size < 2) return 1;
+
+    int near_links = 0;
+    for (int cell = lst->head; data.next(cell) != 0; cell = data.next(cell)) {
+        if (abs(data.next(cell) - cell) <= LIST_NEAR_CELLS) near_links++;
+    }
+
+    return (double)near_links / (lst->size - 1);
+}
+
+//! Function dumps list info
+//! \param lst    ptr to List object
+//! \param reason ptr to reason string
+//! \param log    ptr to log file (default stdout)
+//! \param sep    ptr to sep string (default ", ")
+//! \param end    ptr to end string (default "\n")
+//! \return       1 if success, else 0
+LIST_TEMPLATE int list_dump(LIST_TYPE* lst, const char* reason, FILE* log, const char* sep, const char* end) {
+    ASSERT_IF(VALID_PTR(lst),    "Invalid lst ptr", 0);
+
+    ListDumpRange all_cells = { 0, lst->capacity };
+    return list_dump_ranges(lst, reason, log, &all_cells, 1, sep, end);
+}
+
+//! Function dumps list info, but writes only cells [from, to) and LIST_DUMP_CONTEXT cells
+//! around head and tail (skipped cells are shown as "...")
+//! \param lst    ptr to List object
+//! \param reason ptr to reason string
+//! \param from   first dumped cell
+//! \param to     cell after last dumped cell
+//! \param log    ptr to log file (default stdout)
+//! \param sep    ptr to sep string (default ", ")
+//! \param end    ptr to end string (default "\n")
+//! \return       1 if success, else 0
+LIST_TEMPLATE int list_dump_window(LIST_TYPE* lst, const char* reason, int from, int to, FILE* log, const char* sep, const char* end) {
+    ASSERT_IF(VALID_PTR(lst),    "Invalid lst ptr", 0);
+
+    int capacity = lst->capacity > 0 ? lst->capacity : 0;
+    ListDumpRange ranges[3] = {
+        { lst->head - LIST_DUMP_CONTEXT, lst->head + LIST_DUMP_CONTEXT + 1 },
+        { from,                          to                                },
+        { lst->tail - LIST_DUMP_CONTEXT, lst->tail + LIST_DUMP_CONTEXT + 1 }
+    };
+
+    // Cutting ranges by capacity, sorting them and merging overlapping ones
+    for (int i = 0; i < 3; i++) {
+        if (ranges[i].from < 0)        ranges[i].from = 0;
+        if (ranges[i].to   > capacity) ranges[i].to   = capacity;
+        if (ranges[i].to   < ranges[i].from) ranges[i].to = ranges[i].from;
+    }
+    for (int i = 1; i < 3; i++) {
+        for (int j = i; j > 0 && ranges[j].from < ranges[j - 1].from; j--) {
+            ListDumpRange tmp = ranges[j];
+            ranges[j]     = ranges[j - 1];
+            ranges[j - 1] = tmp;
+        }
+    }
+
+    int n_ranges = 0;
+    for (int i = 0; i < 3; i++) {
+        if (ranges[i].from == ranges[i].to) continue;
+
+        if (n_ranges > 0 && ranges[i].from <= ranges[n_ranges - 1].to) {
+            if (ranges[i].to > ranges[n_ranges - 1].to) ranges[n_ranges - 1].to = ranges[i].to;
+        } else {
+            ranges[n_ranges++] = ranges[i];
+        }
+    }
+
+    return list_dump_ranges(lst, reason, log, ranges, n_ranges, sep, end);
+}
+
+//! Function dumps list info with cells from given ranges
+//! \param lst      ptr to List object
+//! \param reason   ptr to reason string
+//! \param log      ptr to log file
+//! \param ranges   ptr to array of sorted not overlapping ranges of cells
+//! \param n_ranges number of ranges
+//! \param sep      ptr to sep string
+//! \param end      ptr to end string
+//! \return         1 if success, else 0
+LIST_TEMPLATE int list_dump_ranges(LIST_TYPE* lst, const char* reason, FILE* log, const ListDumpRange* ranges, int n_ranges,
+                                   const char* sep, const char* end) {
+    ASSERT_IF(VALID_PTR(lst),    "Invalid lst ptr", 0);
+    ASSERT_IF(VALID_PTR(log),    "Invalid log ptr", 0);
+
+    ASSERT_IF(VALID_PTR(reason), "Invalid reason ptr", 0);
+    ASSERT_IF(VALID_PTR(sep),    "Invalid sep ptr", 0);
+    ASSERT_IF(VALID_PTR(end),    "Invalid end ptr", 0);
+    ASSERT_IF(n_ranges == 0 || VALID_PTR(ranges), "Invalid ranges ptr", 0);
+
+    fprintf(log, COLORED_OUTPUT("|-------------------------          List  Dump          -------------------------|\n", ORANGE, log));
+    FPRINT_DATE(log);
+    fprintf(log, COLORED_OUTPUT("%s\n", BLUE, log), reason);
+    int err = list_error(lst);
+    int capacity = lst->capacity;
+
+    fprintf(log, "    List state: %d ", err);
+    if (err != 0) fprintf(log, COLORED_OUTPUT("(%s)\n\n", RED,   log), list_error_desc(err));
+    else          fprintf(log, COLORED_OUTPUT("(%s)\n\n", GREEN, log), list_error_desc(err));
+
+    char is_sorted_str[INT_STR_SIZE] = "";
+    format_int(is_sorted_str, lst->is_sorted);
+
+    fprintf(log, "    Is_sorted: %s %s\n"
+                 "Sorted prefix: %d %s\n"
+                 "         Head: %d %s\n"
+                 "         Tail: %d %s\n"
+                 "         Size: %d %s\n"
+                 "     Capacity: %d %s\n\n",
+            lst->is_sorted == 0 ? COLORED_OUTPUT("no", PURPLE, log) : lst->is_sorted == 1 ? COLORED_OUTPUT("yes", BLUE, log) : is_sorted_str,
+                            (0 > lst->is_sorted || lst->is_sorted > 1)    ? COLORED_OUTPUT("(BAD)", RED, log) : "",
+            lst->sorted_prefix, (0 > lst->sorted_prefix || lst->sorted_prefix >= capacity) ? COLORED_OUTPUT("(BAD)", RED, log) : "",
+            lst->head,      (0 > lst->head || lst->head >= capacity) ?      COLORED_OUTPUT("(BAD)", RED, log) : "",
+            lst->tail,      (0 > lst->tail || lst->tail >= capacity) ?      COLORED_OUTPUT("(BAD)", RED, log) : "",
+            lst->size,      (0 > lst->size || lst->size >= capacity) ?      COLORED_OUTPUT("(BAD)", RED, log) : "",
+            capacity,              (capacity <= 0)        ?                 COLORED_OUTPUT("(BAD)", RED, log) : ""
+    );
+
+    // Rows of cells are collected in buffer on stack, so dump of big list makes no allocations
+    DumpBuffer buf = { };
+    dump_buffer_open(&buf, log);
+
+    dump_buffer_puts(&buf, "             ");
+    list_dump_row   (lst, &buf, LIST_DUMP_INDEXES, ranges, n_ranges, sep, log);
+    dump_buffer_puts(&buf, "\n");
+
+    dump_buffer_puts(&buf, "              ");
+    list_dump_row   (lst, &buf, LIST_DUMP_MARKERS, ranges, n_ranges, sep, log);
+    dump_buffer_puts(&buf, "\n");
+
+    dump_buffer_puts(&buf, "    Buffer: [ ");
+    list_dump_row   (lst, &buf, LIST_DUMP_VALUES, ranges, n_ranges, sep, log);
+    dump_buffer_puts(&buf, " ]");
+    dump_buffer_puts(&buf, end);
+
+    dump_buffer_puts(&buf, "    Next:   [ ");
+    list_dump_row   (lst, &buf, LIST_DUMP_NEXT, ranges, n_ranges, sep, log);
+    dump_buffer_puts(&buf, " ] ");
+    dump_buffer_puts(&buf, end);
+
+    dump_buffer_puts(&buf, "    Prev:   [ ");
+    list_dump_row   (lst, &buf, LIST_DUMP_PREV, ranges, n_ranges, sep, log);
+    dump_buffer_puts(&buf, " ] ");
+    dump_buffer_puts(&buf, end);
+    dump_buffer_puts(&buf, "\n");
+
+    dump_buffer_flush(&buf);
+
+    fprintf(log, "    First_free: %d %s\n", lst->first_free, lst->first_free >= 0 && lst->first_free < capacity ? "" : COLORED_OUTPUT("(BAD)", RED, log));
+
+    fprintf(log, COLORED_OUTPUT("|---------------------Compilation  Date %s %s---------------------|", ORANGE, log),
+            __DATE__, __TIME__);
+    fprintf(log, "\n\n");
+
+    return 1;
+}
+
+//! Function writes one row of cells table to dump buffer
+//! \param lst      ptr to List object
+//! \param buf      ptr to DumpBuffer object
+//! \param row      kind of row (see list_dump_rows)
+//! \param ranges   ptr to array of sorted not overlapping ranges of cells
+//! \param n_ranges number of ranges
+//! \param sep      ptr to sep string (it splits columns of value and link rows)
+//! \param log      ptr to log file (it is used only to choose colors)
+LIST_TEMPLATE void list_dump_row(LIST_TYPE* lst, DumpBuffer* buf, int row, const ListDumpRange* ranges, int n_ranges,
+                                 const char* sep, FILE* log) {
+    const Storage<T>& data = lst->data;
+
+    // Marks are chosen once for row, not for each cell
+    const char* un_mark   = row == LIST_DUMP_VALUES ? (COLORED_OUTPUT(" un", CYAN, log)) : (COLORED_OUTPUT(" un", ORANGE, log));
+    const char* fr_mark   = COLORED_OUTPUT(" fr", RED,    log);
+    const char* both_mark = COLORED_OUTPUT(" B ", PURPLE, log);
+    const char* head_mark = COLORED_OUTPUT(" H ", BLUE,   log);
+    const char* tail_mark = COLORED_OUTPUT(" T ", GREEN,  log);
+
+    int  is_table = row == LIST_DUMP_INDEXES || row == LIST_DUMP_MARKERS;    // Columns are split by spaces, not by sep
+    int  sep_len  = (int)strlen(sep);
+    char value_str[MAX_VALUE_STR_SIZE] = "";
+
+    for (int r = 0; r < n_ranges; r++) {
+        // Column before range is "...", if some cells are skipped
+        int skipped = r > 0 && ranges[r].from > ranges[r - 1].to;
+
+        for (int i = ranges[r].from - skipped; i < ranges[r].to; i++) {
+            if (!is_table && (r > 0 || i > ranges[r].from)) dump_buffer_write(buf, sep, sep_len);
+
+            int link = row == LIST_DUMP_NEXT ? data.next(i) : row == LIST_DUMP_PREV ? data.prev(i) : 0;
+            int poison = 0;
+
+            if (i < ranges[r].from) {
+                dump_buffer_puts(buf, row == LIST_DUMP_MARKERS ? "   " : "...");
+            } else switch (row) {
+                case LIST_DUMP_INDEXES:
+                    dump_buffer_int(buf, i, 3);
+                    break;
+                case LIST_DUMP_MARKERS:
+                    if      (i == lst->head && i == lst->tail)  dump_buffer_puts(buf, both_mark);
+                    else if (i == lst->head)                    dump_buffer_puts(buf, head_mark);
+                    else if (i == lst->tail)                    dump_buffer_puts(buf, tail_mark);
+                    else                                        dump_buffer_puts(buf, "   ");
+                    break;
+                case LIST_DUMP_VALUES:
+                    poison = list_value_poison(lst, i);
+
+                    if      (poison == UN)  dump_buffer_puts(buf, un_mark);
+                    else if (poison == FR)  dump_buffer_puts(buf, fr_mark);
+                    else {
+                        ListValueTraits<T>::format(value_str, MAX_VALUE_STR_SIZE, data.value(i));
+                        dump_buffer_padded(buf, value_str, 3);
+                    }
+                    break;
+                default:
+                    if      (link == UN)    dump_buffer_puts(buf, un_mark);
+                    else if (link == FR)    dump_buffer_puts(buf, fr_mark);
+                    else                    dump_buffer_int (buf, link, 3);
+                    break;
+            }
+
+            if (is_table) dump_buffer_puts(buf, "  ");
+        }
+    }
+}
+
+//! Function make graph dump of list info. Only image is rendered in background (see libs/dot_pool.h):
+//! dump text and <img> tag are written to log by caller (LOG_DUMP_GRAPH gives memory stream,
+//! which is appended to log.html by async log thread). If image is dropped, <img> tag isn`t written
+//! \param lst    ptr to List object
+//! \param reason ptr to reason string
+//! \param log    ptr to log file
+//! \param sep    ptr to sep string (default ", ")
+//! \param end    ptr to end string (default "\n")
+//! \return       number of graph image (>= 1, -1 if image won`t be rendered), 0 if error
+LIST_TEMPLATE int list_dump_graph(LIST_TYPE* lst, const char* reason, FILE* log, const char* sep, const char* end) {
+    ASSERT_IF(VALID_PTR(lst),    "Invalid lst ptr", 0);
+    ASSERT_IF(VALID_PTR(log),    "Invalid log ptr", 0);
+
+    ASSERT_IF(VALID_PTR(reason), "Invalid reason ptr", 0);
+    ASSERT_IF(VALID_PTR(sep),    "Invalid sep ptr", 0);
+    ASSERT_IF(VALID_PTR(end),    "Invalid end ptr", 0);
+
+    const Storage<T>& data = lst->data;
+
+    // DOT text is written to memory, rendering is done by workers (see libs/dot_pool.h)
+    char*  dot_text = NULL;
+    size_t dot_size = 0;
+    FILE*  dot_file = open_memstream(&dot_text, &dot_size);
+    if (dot_file == NULL) return -1;
+
+    fputs("digraph structs {\n", dot_file);
+    fputs("    rankdir=LR\n"
+          "    label=\"", dot_file);
+    fputs(reason, dot_file);
+    fputs("\"\n\n", dot_file);
+
+    int capacity = lst->capacity;
+    fprintf(dot_file, "    cell_head [ shape=component label=\"head | %d\" color=\"%s\" ]\n"
+                      "    cell_tail [ shape=component label=\"tail | %d\" color=\"%s\" ]\n"
+                      "    cell_capacity [ shape=component label=\"capacity | %d\" color=\"%s\" ]\n"
+                      "    cell_head -> cell_tail -> cell_capacity[arrowhead=\"none\"]\n\n",
+            lst->head, 0 < lst->head && lst->head < capacity ? "blue"  : "red",
+            lst->tail, 0 < lst->tail && lst->tail < capacity ? "green" : "red",
+            capacity, capacity > 0 ? "black" : "red"
+    );
+
+    char value_str[MAX_VALUE_STR_SIZE] = "";
+    char next_str [INT_STR_SIZE]       = "";
+    char prev_str [INT_STR_SIZE]       = "";
+    for (int i = 0; i < capacity; i++) {
+        int next   = data.next(i);
+        int prev   = data.prev(i);
+        int poison = list_value_poison(lst, i);
+        ListValueTraits<T>::format(value_str, MAX_VALUE_STR_SIZE, data.value(i));
+        format_int(next_str, next);
+        format_int(prev_str, prev);
+
+        fprintf(dot_file, "    cell_%d [ shape=record, label=< %d<br/><br/>"
+                    " value =<font color=\"%s\">%s</font><br/>"
+                    "  next =<font color=\"%s\">%s</font><br/>"
+                    "  prev =<font color=\"%s\">%s</font>"
+                    "> color = \"%s\" %s ]\n",
+                i, i,
+                poison  == UN ? "blue" : poison == FR ? "red" : "black", poison == UN ? "un" : poison == FR ? "fr" : value_str,
+                next == UN ? "orange" : next == FR ? "red": "black", next == UN ? "un" : next == FR ? "fr" : next_str,
+                prev == UN ? "orange" : prev == FR ? "red": "black", prev == UN ? "un" : prev == FR ? "fr" : prev_str,
+                i == lst->head && i == lst->tail ? "purple" : i == lst->head ? "blue" : i == lst->tail ? "green" : "black",
+                data.prev(i) == UN ? "style=\"filled\" fillcolor=\"lightgreen\"" : ""
+        );
+
+        if (i != 0) {
+            if (next != UN && next != FR && next != 0) {
+                fprintf(dot_file, "    cell_%d -> cell_%d\n", i, next);
+            }
+            if (prev != UN && prev != FR) {
+                fprintf(dot_file, "    cell_%d -> cell_%d\n", i, prev);
+            }
+            fprintf(dot_file, "    cell_%d -> cell_%d[style=\"invis\"]\n", i - 1, i);
+        }
+        fputs("\n", dot_file);
+    }
+
+    int  err = list_error(lst);
+    char is_sorted_str[INT_STR_SIZE] = "";
+    format_int(is_sorted_str, lst->is_sorted);
+
+    fprintf(dot_file, "    cell_free [ shape=component label=\"first free | %d\" color=\"%s\" ]\n\n"
+                      "    cell_is_sorted [shape=component label=\"is_sorted | %s\" color=\"%s\" ]\n"
+                      "    cell_state [ shape=component label=\"state | %d (%s)\" color=\"%s\" ]\n"
+                      "    cell_state -> cell_is_sorted[arrowhead=\"none\"]\n"
+                      "    cell_free  -> cell_%d[arrowhead=\"icurve\"]",
+            lst->first_free, 0 <= lst->first_free && lst->first_free < capacity ? "black" : "red",
+            lst->is_sorted == 0 ? "no" : lst->is_sorted == 1 ? "yes" : is_sorted_str, 0 <= lst->is_sorted && lst->is_sorted <= 1 ? "black" : "red",
+            err, list_error_desc(err), err == 0 ? "green" : "red", lst->first_free
+    );
+
+    fputs("}\n", dot_file);
+    fclose(dot_file);
+
+    char image_path[DOT_POOL_PATH_SIZE] = "";
+    int  graph_number = dot_pool_submit(dot_text, dot_size, image_path, sizeof(image_path));
+
+    fputs("<h1 align=\"center\">Dump List</h1>\n<pre>\n", log);
+    list_dump(lst, reason, log, sep, end);
+    fputs("</pre>\n", log);
+
+    if (graph_number >= 0) fprintf(log, "<img src=\"%s\">\n", image_path);
+    fputs("\n", log);
+
+    return graph_number;
+}
+
+#undef UN
+#undef FR
+#undef UN_VAL
+#undef FR_VAL
+
+#endif // LIST_IMPLH
@@ -0,0 +1,126 @@
+//
+//  Created by IvanBrekman on 03.11.2021.
+//
+
+#ifndef LIST_INGESTH
+#define LIST_INGESTH
+
+#include <cerrno>
+#include <climits>
+#include <type_traits>
+
+// Ingest----------------------------------------------------------------------
+// list_from_text parses numbers of text (see parse_ints) straight to cells of list: list is
+// allocated once by number of words and number i gets cell i + 1 with links to neighbour cells,
+// so list is linearized (is_sorted = 1) without push calls. Chunks of text are parsed by
+// several threads, their cells follow each other, so merge of chunks is free.
+
+//! Function allocates cells for all parsed numbers (IntSink reserve callback)
+//! \param object   ptr to List object
+//! \param n_values number of numbers
+//! \return         1 if success, else 0
+LIST_TEMPLATE int list_ingest_reserve(void* object, size_t n_values) {
+    LIST_TYPE* lst = (LIST_TYPE*)object;
+
+    if (n_values >= (size_t)INT_MAX) return 0;
+
+    int capacity = (int)n_values + 1;
+    if (!lst->data.alloc(capacity)) return 0;
+
+    lst->capacity = capacity;
+    lst->size     = (int)n_values;
+    lst->data.set(0, ListValueTraits<T>::uninit(), n_values > 0, (int)n_values);
+
+    return 1;
+}
+
+//! Function writes batch of numbers to their cells (IntSink write callback, called by several threads)
+//! \param object   ptr to List object
+//! \param index    index of first number of batch
+//! \param values   ptr to array of numbers
+//! \param n_values number of numbers
+LIST_TEMPLATE void list_ingest_write(void* object, size_t index, const int* values, size_t n_values) {
+    LIST_TYPE* lst = (LIST_TYPE*)object;
+
+    int capacity = lst->capacity;
+    int cell     = (int)index + 1;
+    for (size_t i = 0; i < n_values; i++, cell++) {
+        lst->data.set(cell, (T)values[i], cell + 1 < capacity ? cell + 1 : 0, cell - 1);
+    }
+}
+
+//! Function makes list from numbers of text
+//! \param lst       ptr to List object (it shouldn`t be constructed)
+//! \param data      ptr to text with decimal int numbers, which are divided by spaces
+//! \param size      size of text
+//! \param n_threads number of threads (default 1, TEXT_THREADS_AUTO - all CPUs)
+//! \return          1 if success, else 0 (errno is BAD_NUMBER, if text has not a number)
+LIST_TEMPLATE int list_from_text(LIST_TYPE* lst, const char* data, size_t size, int n_threads) {
+    static_assert(std::is_arithmetic<T>::value, "list_from_text makes list of numbers");
+
+    LIST_ASSERT_IF(lst, VALID_PTR(lst),                  "Invalid lst ptr", 0);
+    LIST_ASSERT_IF(lst, size == 0 || VALID_PTR(data),    "Invalid data ptr", 0);
+
+    *lst = { };
+
+    IntSink sink = { lst, list_ingest_reserve<T, Storage, Validation>, list_ingest_write<T, Storage, Validation> };
+    if (!parse_ints(data, size, &sink, n_threads)) {
+        int error = errno == ENOMEM ? errors::NOT_ENOUGH_MEMORY : errors::BAD_NUMBER;
+
+        if (lst->capacity > 0) lst->data.release();
+        *lst = { };
+
+        errno = error;
+        return 0;
+    }
+
+    return list_from_text_finish(lst);
+}
+
+//! Function makes list from numbers of file (file is mapped, not copied)
+//! \param lst       ptr to List object (it shouldn`t be constructed)
+//! \param filename  ptr to path of file
+//! \param n_threads number of threads (default 1, TEXT_THREADS_AUTO - all CPUs)
+//! \return          1 if success, else 0 (errno is BAD_NUMBER, if file has not a number)
+LIST_TEMPLATE int list_from_file(LIST_TYPE* lst, const char* filename, int n_threads) {
+    static_assert(std::is_arithmetic<T>::value, "list_from_file makes list of numbers");
+
+    LIST_ASSERT_IF(lst, VALID_PTR(lst),      "Invalid lst ptr", 0);
+    LIST_ASSERT_IF(lst, VALID_PTR(filename), "Invalid filename ptr", 0);
+
+    *lst = { };
+
+    IntSink sink = { lst, list_ingest_reserve<T, Storage, Validation>, list_ingest_write<T, Storage, Validation> };
+    if (!parse_file_ints(filename, &sink, n_threads)) {
+        int error = errno;
+        if (error == ENOMEM) error = errors::NOT_ENOUGH_MEMORY;
+        if (error == EINVAL) error = errors::BAD_NUMBER;
+
+        if (lst->capacity > 0) lst->data.release();
+        *lst = { };
+
+        errno = error;
+        return 0;
+    }
+
+    return list_from_text_finish(lst);
+}
+
+//! Function sets fields of list, which cells were written by list_ingest_write
+//! \param lst ptr to List object
+//! \return    1 if success, else 0
+LIST_TEMPLATE int list_from_text_finish(LIST_TYPE* lst) {
+    int size = lst->size;
+
+    lst->head          = size > 0;
+    lst->tail          = size;
+    lst->first_free    = 0;     // All cells are used
+    lst->is_sorted     = 1;
+    lst->sorted_prefix = size;
+
+    ASSERT_OK(lst, "Check after list_from_text func", 0);
+    return 1;
+}
+// ----------------------------------------------------------------------------
+
+#endif // LIST_INGESTH
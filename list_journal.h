@@ -0,0 +1,426 @@
+//
+//  Created by IvanBrekman on 03.11.2021.
+//
+
+#ifndef LIST_JOURNALH
+#define LIST_JOURNALH
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Journal---------------------------------------------------------------------
+// Push, pop, resize, linearize, sort, compaction step and free map switch append record with
+// physical indexes to journal buffer. list_journal_commit writes all collected records by one
+// write call (and waits for disk with JOURNAL_SYNC_COMMIT), so many changes share one commit.
+// list_checkpoint saves list to snapshot file (see list_snapshot.h) and truncates journal.
+// Recovery: list_load of snapshot file, then list_journal_replay, which repeats records: runs of
+// pushes after tail and pops from head are applied by push_back_n and pop_front_n. Replay checks
+// cells of pushes and values of pops: record, which doesn`t match list, fails with BAD_JOURNAL.
+// Snapshot file and journal keep number of checkpoint: if program stops after snapshot file is
+// saved, but before journal is truncated, replay sees old number and skips records, which are in
+// snapshot file already. Records after last commit can be lost, torn last record is ignored.
+// !Note! rank index, free map and compaction are replayed by their records, but changes of cells
+// through list.data bypass journal.
+
+const char LIST_JOURNAL_SIGNATURE[8] = { 'L', 'I', 'S', 'T', 'J', 'R', 'N', 'L' };
+const int  LIST_JOURNAL_VERSION      = 1;
+
+static_assert(sizeof(ListJournalHeader) == 64, "ListJournalHeader should keep records aligned by 64 bytes");
+
+//! Function appends record to journal buffer (buffer is written to file, when it is full)
+//! \param journal ptr to ListJournal object
+//! \param record  ptr to record of journal->record_size bytes
+//! \return        1 if success, else 0
+inline int journal_write(ListJournal* journal, const void* record) {
+    if (journal->used + journal->record_size > journal->buffer_size && !journal_flush(journal)) {
+        return 0;
+    }
+
+    memcpy(journal->buffer + journal->used, record, journal->record_size);
+    journal->used += journal->record_size;
+
+    return 1;
+}
+
+//! Function writes collected records to file
+//! \param journal ptr to ListJournal object
+//! \return        1 if success, else 0 (errno of write is kept in journal->error)
+inline int journal_flush(ListJournal* journal) {
+    size_t written = 0;
+    while (written < journal->used && journal->error == 0) {
+        ssize_t part = write(journal->fd, journal->buffer + written, journal->used - written);
+
+        if (part > 0)                        written += (size_t)part;
+        else if (part < 0 && errno != EINTR) journal->error = errno;
+    }
+    journal->used = 0;
+
+    if (journal->error != 0) {
+        errno = journal->error;
+        return 0;
+    }
+    return 1;
+}
+
+//! Function writes collected records to file and waits for disk, if journal->sync is JOURNAL_SYNC_COMMIT
+//! \param journal ptr to ListJournal object
+//! \return        1 if success, else 0
+inline int journal_commit(ListJournal* journal) {
+    if (!journal_flush(journal)) return 0;
+
+    if (journal->sync == JOURNAL_SYNC_COMMIT && fdatasync(journal->fd) != 0) {
+        journal->error = errno;
+        return 0;
+    }
+    return 1;
+}
+
+//! Function removes all records from journal file and writes new header
+//! \param journal    ptr to ListJournal object
+//! \param checkpoint number of checkpoint of snapshot file, which records will change
+//! \param value_size sizeof(T)
+//! \return           1 if success, else 0
+inline int journal_reset(ListJournal* journal, int checkpoint, int value_size) {
+    ListJournalHeader header = { };
+    memcpy(header.signature, LIST_JOURNAL_SIGNATURE, sizeof(header.signature));
+
+    header.version     = LIST_JOURNAL_VERSION;
+    header.header_size = (int)sizeof(ListJournalHeader);
+    header.record_size = journal->record_size;
+    header.value_size  = value_size;
+    header.checkpoint  = checkpoint;
+
+    journal->used  = 0;
+    journal->error = 0;
+
+    if (ftruncate(journal->fd, 0) != 0 || lseek(journal->fd, 0, SEEK_SET) != 0 ||
+        write(journal->fd, &header, sizeof(header)) != (ssize_t)sizeof(header)) {
+        journal->error = errno;
+        return 0;
+    }
+
+    if (journal->sync == JOURNAL_SYNC_COMMIT && fdatasync(journal->fd) != 0) {
+        journal->error = errno;
+        return 0;
+    }
+    return 1;
+}
+
+//! Function appends change of list to journal (called by changing functions, if journal is on).
+//! Error of write is kept in journal and is returned by next commit
+//! \param lst    ptr to List object
+//! \param op     type of change (see journal_ops)
+//! \param arg    argument of change (see ListJournalRecord)
+//! \param result physical index of pushed element
+//! \param value  pushed or popped value
+LIST_TEMPLATE void list_journal_record(LIST_TYPE* lst, int op, int arg, int result, LIST_VALUE value) {
+    ListJournalRecord<T> record = { };
+
+    record.op     = op;
+    record.arg    = arg;
+    record.result = result;
+    record.value  = value;
+
+    journal_write(lst->journal, &record);
+}
+
+//! Function turns on journal: list is saved to snapshot file (checkpoint) and journal file gets no records
+//! \param lst          ptr to List object
+//! \param image_name   ptr to path of snapshot file, which checkpoints write
+//! \param journal_name ptr to path of journal file
+//! \param sync         when records are written to disk (see journal_sync_modes, default JOURNAL_SYNC_NONE)
+//! \return             1 if success, else 0
+LIST_TEMPLATE int list_journal_open(LIST_TYPE* lst, const char* image_name, const char* journal_name, int sync) {
+    ASSERT_OK(lst, "Check before list_journal_open func", 0);
+    LIST_ASSERT_IF(lst, lst->journal == NULL,     "Journal is already open", 0);
+    LIST_ASSERT_IF(lst, VALID_PTR(image_name),    "Invalid image_name ptr", 0);
+    LIST_ASSERT_IF(lst, VALID_PTR(journal_name),  "Invalid journal_name ptr", 0);
+    LIST_ASSERT_IF(lst, sync == JOURNAL_SYNC_NONE || sync == JOURNAL_SYNC_COMMIT, "Incorrect sync mode", 0);
+
+    ListJournal* journal = (ListJournal*) calloc(1, sizeof(ListJournal));
+    if (journal == NULL) {
+        errno = errors::NOT_ENOUGH_MEMORY;
+        return 0;
+    }
+    *journal = { };
+
+    if (snprintf(journal->image_name, sizeof(journal->image_name), "%s", image_name) >= (int)sizeof(journal->image_name)) {
+        free(journal);
+
+        errno = ENAMETOOLONG;
+        return 0;
+    }
+
+    journal->sync        = sync;
+    journal->record_size = (int)sizeof(ListJournalRecord<T>);
+    journal->buffer_size = (size_t)(JOURNAL_BUFFER_SIZE / journal->record_size + 1) * journal->record_size;
+    journal->buffer      = (char*) calloc(journal->buffer_size, sizeof(char));
+    journal->fd          = open(journal_name, O_WRONLY | O_CREAT, 0644);
+
+    if (journal->buffer == NULL || journal->fd < 0) {
+        int error = journal->buffer == NULL ? errors::NOT_ENOUGH_MEMORY : errno;
+
+        if (journal->fd >= 0) close(journal->fd);
+        free(journal->buffer);
+        free(journal);
+
+        errno = error;
+        return 0;
+    }
+
+    lst->journal = journal;
+    if (!list_checkpoint(lst)) {
+        int error = errno;
+        list_journal_close(lst);
+
+        errno = error;
+        return 0;
+    }
+
+    return 1;
+}
+
+//! Function commits records and turns off journal (journal file stays for recovery)
+//! \param lst ptr to List object
+//! \return    1 if all records were written, else 0
+LIST_TEMPLATE int list_journal_close(LIST_TYPE* lst) {
+    LIST_ASSERT_IF(lst, VALID_PTR(lst),        "Invalid lst ptr", 0);
+    LIST_ASSERT_IF(lst, lst->journal != NULL,  "Journal is not open", 0);
+
+    ListJournal* journal = lst->journal;
+    lst->journal = NULL;
+
+    int ok = journal_commit(journal);
+    int error = errno;
+
+    close(journal->fd);
+    free(journal->buffer);
+    free(journal);
+
+    errno = error;
+    return ok;
+}
+
+//! Function writes collected records to journal file by one write call (group commit)
+//! \param lst ptr to List object
+//! \return    1 if success, else 0 (changes after failed write can be lost, checkpoint is needed)
+LIST_TEMPLATE int list_journal_commit(LIST_TYPE* lst) {
+    LIST_ASSERT_IF(lst, VALID_PTR(lst),        "Invalid lst ptr", 0);
+    LIST_ASSERT_IF(lst, lst->journal != NULL,  "Journal is not open", 0);
+
+    return journal_commit(lst->journal);
+}
+
+//! Function saves list to snapshot file of journal and truncates journal
+//! \param lst ptr to List object
+//! \return    1 if success, else 0
+LIST_TEMPLATE int list_checkpoint(LIST_TYPE* lst) {
+    ASSERT_OK(lst, "Check before list_checkpoint func", 0);
+    LIST_ASSERT_IF(lst, lst->journal != NULL, "Journal is not open", 0);
+
+    ListJournal* journal = lst->journal;
+    journal_commit(journal);    // Error is forgotten: snapshot file will have all changes
+
+    lst->checkpoint++;
+    if (!list_save(lst, journal->image_name)) {
+        lst->checkpoint--;
+        return 0;
+    }
+
+    if (journal->sync == JOURNAL_SYNC_COMMIT) {
+        int image = open(journal->image_name, O_RDONLY);
+        if (image < 0 || fsync(image) != 0) {
+            if (image >= 0) close(image);
+            return 0;
+        }
+        close(image);
+    }
+
+    return journal_reset(journal, lst->checkpoint, (int)sizeof(T));
+}
+
+//! Function repeats records of journal on list
+//! \param lst       ptr to List object
+//! \param records   ptr to array of records
+//! \param n_records number of records
+//! \return          1 if success, else 0
+LIST_TEMPLATE int list_journal_apply(LIST_TYPE* lst, const ListJournalRecord<T>* records, int n_records) {
+    LIST_VALUE values[JOURNAL_BATCH];
+    const Storage<T>& data = lst->data;
+
+    for (int i = 0; i < n_records; ) {
+        const ListJournalRecord<T>* record = &records[i];
+
+        int arg = record->arg;
+        int ok  = 1;
+        int run = 1;
+
+        switch (record->op) {
+            case JOURNAL_PUSH:
+            case JOURNAL_PUSH_BACK: {
+                if (arg < 0 || arg >= lst->capacity || list_cell_is_free(lst, arg)) {
+                    ok = 0;
+                    break;
+                }
+                if (record->op == JOURNAL_PUSH && (arg != lst->tail || arg == 0)) {    // push_index takes cell before head for push to front
+                    ok = push_index(lst, record->value, arg) == record->result;
+                    break;
+                }
+                if (arg != lst->tail) {
+                    ok = 0;
+                    break;
+                }
+
+                // Pushes after tail: each one is after result of previous one--------
+                values[0] = record->value;
+                while (run < JOURNAL_BATCH && i + run < n_records && records[i + run].op == record->op &&
+                       records[i + run].arg == records[i + run - 1].result) {
+                    values[run] = records[i + run].value;
+                    run++;
+                }
+
+                // push_index keeps prefix till ph_index, so next records find the same cells
+                int prefix = list_sorted_prefix(lst);
+                if (lst->head <= arg && arg < lst->head + prefix) prefix = arg - lst->head + 1;
+
+                if (!push_back_n(lst, values, run)) {
+                    ok = 0;
+                    break;
+                }
+                if (record->op == JOURNAL_PUSH) {
+                    lst->is_sorted     = 0;
+                    lst->sorted_prefix = prefix;
+                }
+
+                for (int j = 0, cell = data.next(arg); j < run && ok; j++, cell = data.next(cell)) {
+                    ok = cell == records[i + j].result;
+                }
+                // --------------------------------------------------------------------
+                break;
+            }
+            case JOURNAL_POP: {
+                if (arg <= 0 || arg >= lst->capacity || list_cell_is_free(lst, arg)) {
+                    ok = 0;
+                    break;
+                }
+                if (arg != lst->head) {
+                    int size = lst->size;
+                    T   value = pop_index(lst, arg);
+
+                    ok = lst->size == size - 1 && ListValueTraits<T>::equal(value, record->value);
+                    break;
+                }
+
+                // Pops from head: each one pops next element of previous one---------
+                for (int cell = data.next(arg); run < JOURNAL_BATCH && i + run < n_records &&
+                     records[i + run].op == JOURNAL_POP && records[i + run].arg == cell && cell != 0; run++) {
+                    cell = data.next(cell);
+                }
+
+                ok = pop_front_n(lst, values, run);
+                for (int j = 0; j < run && ok; j++) {
+                    ok = ListValueTraits<T>::equal(values[j], records[i + j].value);
+                }
+                // --------------------------------------------------------------------
+                break;
+            }
+            case JOURNAL_RESIZE:
+                ok = arg > lst->capacity && resize_list_capacity(lst, arg) == arg;
+                break;
+            case JOURNAL_LINEARIZE:
+                ok = list_linearize(lst);
+                break;
+            case JOURNAL_SORT:
+                ok = please_dont_use_sorted_by_next_values_func_because_it_too_slow__also_do_you_really_need_it__i_think_no__so_dont_do_stupid_things_and_better_look_at_memes_about_cats(lst) == 1;
+                break;
+            case JOURNAL_COMPACT:
+                ok = arg > 0;
+                if (ok) list_compact_step(lst, arg);
+                break;
+            case JOURNAL_FREE_MAP:
+                ok = arg ? list_free_map_enable(lst) : list_free_map_disable(lst);
+                break;
+            default:
+                ok = 0;
+                break;
+        }
+
+        if (!ok) {
+            errno = errors::BAD_JOURNAL;
+            return 0;
+        }
+        i += run;
+    }
+
+    return 1;
+}
+
+//! Function repeats journal on list, which was loaded from snapshot file of last checkpoint
+//! \param lst          ptr to List object (journal of it should be off)
+//! \param journal_name ptr to path of journal file
+//! \return             1 if success (also if journal is older than snapshot file), else 0
+LIST_TEMPLATE int list_journal_replay(LIST_TYPE* lst, const char* journal_name) {
+    ASSERT_OK(lst, "Check before list_journal_replay func", 0);
+    LIST_ASSERT_IF(lst, lst->journal == NULL,    "Replay to list with open journal", 0);
+    LIST_ASSERT_IF(lst, VALID_PTR(journal_name), "Invalid journal_name ptr", 0);
+
+    int fd = open(journal_name, O_RDONLY);
+    if (fd < 0) return 0;
+
+    struct stat file_stat = { };
+    if (fstat(fd, &file_stat) != 0) {
+        close(fd);
+        return 0;
+    }
+    if ((size_t)file_stat.st_size < sizeof(ListJournalHeader)) {   // Journal was truncated by checkpoint
+        close(fd);
+        return 1;
+    }
+
+    void* file = mmap(NULL, (size_t)file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (file == MAP_FAILED) return 0;
+
+    const ListJournalHeader* header = (const ListJournalHeader*)file;
+    if (memcmp(header->signature, LIST_JOURNAL_SIGNATURE, sizeof(header->signature)) != 0 ||
+        header->version     != LIST_JOURNAL_VERSION                 ||
+        header->header_size <  (int)sizeof(ListJournalHeader)       ||
+        header->header_size %  (int)alignof(ListJournalRecord<T>)   ||
+        header->record_size != (int)sizeof(ListJournalRecord<T>)   ||
+        header->value_size  != (int)sizeof(T)                       ||
+        header->header_size >  file_stat.st_size                    ||
+        header->checkpoint  >  lst->checkpoint) {
+        munmap(file, (size_t)file_stat.st_size);
+
+        errno = errors::BAD_JOURNAL;
+        return 0;
+    }
+
+    int ok = 1;
+    if (header->checkpoint == lst->checkpoint) {    // Older journal is in snapshot file already
+        const ListJournalRecord<T>* records = (const ListJournalRecord<T>*)(const void*)((const char*)file + header->header_size);
+
+        int n_records = (int)(((size_t)file_stat.st_size - (size_t)header->header_size) / sizeof(ListJournalRecord<T>));
+        while (n_records > 0 && records[n_records - 1].op == 0) n_records--;     // File was extended by zeros
+
+        int compact_budget = lst->compact_budget;
+        lst->compact_budget = 0;    // Compaction steps have their own records
+
+        ok = list_journal_apply(lst, records, n_records);
+        lst->compact_budget = compact_budget;
+    }
+
+    munmap(file, (size_t)file_stat.st_size);
+
+    if (ok) ASSERT_OK(lst, "Check after list_journal_replay func", 0);
+    return ok;
+}
+// ----------------------------------------------------------------------------
+
+#endif // LIST_JOURNALH
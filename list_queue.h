@@ -0,0 +1,197 @@
+//
+//  Created by IvanBrekman on 03.11.2021.
+//
+
+#ifndef LIST_QUEUEH
+#define LIST_QUEUEH
+
+#include <cstdlib>
+#include <cerrno>
+
+// Queue-----------------------------------------------------------------------
+// Cells of ListQueue are ring of ListElement (next of cell i is i + 1 modulo capacity). Positions
+// head and tail only grow, cell of position is (position & (capacity - 1)). prev of cell keeps its turn:
+// cell is free for push at position pos, if turn == pos, and has value for pop, if turn == pos + 1.
+// Pop gives cell back to producers by turn pos + capacity, so free part of ring is free cells list
+// and no lock is needed: producer and consumer meet only at turn of cell. With one producer
+// (QUEUE_SPSC) push_back only loads and stores tail, with several (QUEUE_MPSC) producer takes
+// position by CAS on tail. Consumer is always one thread. Ring has at least 2 cells: in ring of one
+// cell turn pos + 1 means both "has value of pos" and "free for pos + 1", so push overwrites value.
+
+//! Function gets difference of turn of cell and position (turns and positions wrap around)
+//! \param turn     turn of cell
+//! \param position position
+//! \return         turn - position
+inline int queue_turn_diff(int turn, unsigned position) {
+    return (int)((unsigned)turn - position);
+}
+
+//! ListQueue Constructor
+//! \param lst       ptr to ListQueue object
+//! \param capacity  max number of elements (it is rounded up to power of 2 >= 2, default BUFFER_DEFAULT_SIZE)
+//! \param producers number of producer threads (see queue_producers, default QUEUE_SPSC)
+//! \return          1 if success, else 0
+template <typename T> int list_ctor(ListQueue<T>* lst, int capacity, int producers) {
+    ASSERT_IF(VALID_PTR(lst),                     "Invalid lst ptr", 0);
+    ASSERT_IF(0 < capacity && capacity <= 1 << 30, "Incorrect capacity: (<= 0) or (> 2^30)", 0);
+    ASSERT_IF(producers == QUEUE_SPSC || producers == QUEUE_MPSC, "Incorrect producers", 0);
+
+    int ring = 2;
+    while (ring < capacity) ring *= 2;
+
+    *lst = { };
+    lst->cells = (ListElement<T>*) calloc((size_t)ring, sizeof(ListElement<T>));
+    if (lst->cells == NULL) {
+        errno = errors::NOT_ENOUGH_MEMORY;
+        return 0;
+    }
+
+    for (int i = 0; i < ring; i++) {
+        lst->cells[i] = { ListValueTraits<T>::uninit(), (i + 1) & (ring - 1), i };
+    }
+
+    lst->capacity  = ring;
+    lst->producers = producers;
+
+    return 1;
+}
+
+//! ListQueue Destructor (no thread should use queue)
+//! \param lst ptr to ListQueue object
+//! \return    1 if success, else 0
+template <typename T> int list_dtor(ListQueue<T>* lst) {
+    ASSERT_IF(VALID_PTR(lst), "Invalid lst ptr", 0);
+
+    free(lst->cells);
+
+    lst->cells    = NULL;
+    lst->capacity = -1;
+    return 1;
+}
+
+//! Function checks ring and turns of cells (no thread should change queue)
+//! \param lst ptr to ListQueue object
+//! \return    error code (0 if all is good)
+template <typename T> int list_error(ListQueue<T>* lst) {
+    if (!VALID_PTR(lst)) {
+        return errors::INVALID_LIST_PTR;
+    }
+    if (lst->cells == NULL || lst->capacity < 2 || (lst->capacity & (lst->capacity - 1)) != 0) {
+        return errors::INCORRECT_CAPACITY;
+    }
+    if (lst->tail - lst->head > (unsigned)lst->capacity) {
+        return errors::INCORRECT_SIZE;
+    }
+
+    unsigned mask = (unsigned)lst->capacity - 1;
+    for (unsigned pos = lst->head; pos != lst->head + (unsigned)lst->capacity; pos++) {
+        const ListElement<T>* cell = &lst->cells[pos & mask];
+
+        if (cell->next != (int)((pos + 1) & mask)) {
+            return errors::BAD_PH_INDEX;
+        }
+        if (queue_turn_diff(cell->prev, pos) != (pos - lst->head < lst->tail - lst->head ? 1 : 0)) {
+            return errors::INCORRECT_SIZE;
+        }
+    }
+
+    return errors::OK;
+}
+
+//! Function gets number of elements (it is exact only if no thread changes queue)
+//! \param lst ptr to ListQueue object
+//! \return    number of elements
+template <typename T> int list_size(ListQueue<T>* lst) {
+    unsigned head = __atomic_load_n(&lst->head, __ATOMIC_RELAXED);
+    unsigned tail = __atomic_load_n(&lst->tail, __ATOMIC_RELAXED);
+
+    return tail - head <= (unsigned)lst->capacity ? (int)(tail - head) : 0;
+}
+
+//! Function prints queue from head to tail for user (no thread should change queue)
+//! \param lst ptr to ListQueue object
+//! \param sep ptr to sep string (default ", ")
+//! \param end ptr to end string (default "\n")
+//! \return    1 if success, else 0
+template <typename T> int print_list(ListQueue<T>* lst, const char* sep, const char* end) {
+    ASSERT_IF(list_error(lst) == errors::OK, "Check before print_list func", 0);
+    ASSERT_IF(VALID_PTR(sep), "Invalid sep ptr", 0);
+    ASSERT_IF(VALID_PTR(end), "Invalid end ptr", 0);
+
+    char value_str[MAX_VALUE_STR_SIZE] = "";
+
+    printf("[ ");
+    int size = list_size(lst);
+    for (int i = 0, cell = (int)(lst->head & ((unsigned)lst->capacity - 1)); i < size; i++, cell = lst->cells[cell].next) {
+        ListValueTraits<T>::format(value_str, MAX_VALUE_STR_SIZE, lst->cells[cell].value);
+        printf("%3s", value_str);
+
+        if (i + 1 < size) printf("%s", sep);
+    }
+    printf(" ]%s", end);
+
+    return 1;
+}
+
+//! Function inserts value after tail (producers can push, while consumer pops)
+//! \param lst   ptr to ListQueue object
+//! \param value inserted value
+//! \return      physical index of inserted element (< 0 if error)
+template <typename T> int push_back(ListQueue<T>* lst, T value) {
+    ASSERT_IF(VALID_PTR(lst), "Invalid lst ptr", errors::INVALID_LIST_PTR);
+
+    unsigned mask = (unsigned)lst->capacity - 1;
+    unsigned pos  = __atomic_load_n(&lst->tail, __ATOMIC_RELAXED);
+
+    ListElement<T>* cell = NULL;
+    for ( ; ; ) {
+        cell = &lst->cells[pos & mask];
+
+        int diff = queue_turn_diff(__atomic_load_n(&cell->prev, __ATOMIC_ACQUIRE), pos);
+        if (diff < 0) {
+            errno = errors::QUEUE_FULL;    // Cell wasn`t popped since previous round
+            return  errors::QUEUE_FULL;
+        }
+
+        if (lst->producers == QUEUE_SPSC) {
+            __atomic_store_n(&lst->tail, pos + 1, __ATOMIC_RELAXED);
+            break;
+        }
+
+        if (diff == 0 && __atomic_compare_exchange_n(&lst->tail, &pos, pos + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            break;
+        }
+        if (diff != 0) pos = __atomic_load_n(&lst->tail, __ATOMIC_RELAXED);     // Other producer took pos
+    }
+
+    cell->value = value;
+    __atomic_store_n(&cell->prev, (int)(pos + 1), __ATOMIC_RELEASE);
+
+    return (int)(pos & mask);
+}
+
+//! Function pops value from head (only one thread can pop)
+//! \param lst ptr to ListQueue object
+//! \return    popped value (LST_EMPTY error, if queue is empty or head element is still being written)
+template <typename T> T pop_front(ListQueue<T>* lst) {
+    ASSERT_IF(VALID_PTR(lst), "Invalid lst ptr", ListValueTraits<T>::from_error(errors::INVALID_LIST_PTR));
+
+    unsigned pos  = lst->head;
+    ListElement<T>* cell = &lst->cells[pos & ((unsigned)lst->capacity - 1)];
+
+    if (queue_turn_diff(__atomic_load_n(&cell->prev, __ATOMIC_ACQUIRE), pos) != 1) {
+        errno = errors::LST_EMPTY;
+        return ListValueTraits<T>::from_error(errors::LST_EMPTY);
+    }
+
+    T value = cell->value;
+    cell->value = ListValueTraits<T>::freed();
+
+    __atomic_store_n(&cell->prev, (int)(pos + (unsigned)lst->capacity), __ATOMIC_RELEASE);
+    __atomic_store_n(&lst->head, pos + 1, __ATOMIC_RELAXED);
+
+    return value;
+}
+// ----------------------------------------------------------------------------
+
+#endif // LIST_QUEUEH
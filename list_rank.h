@@ -0,0 +1,261 @@
+//
+//  Created by IvanBrekman on 03.11.2021.
+//
+
+#ifndef LIST_RANKH
+#define LIST_RANKH
+
+#include <cstdlib>
+#include <cstring>
+
+// Rank index------------------------------------------------------------------
+// ListRankIndex (see list.h) splits elements into blocks of neighbour (in logical order) elements.
+// Every block knows its first cell and size, every cell knows its block. Lookup walks blocks
+// and then cells inside one block, so with block_limit ~ sqrt(capacity) it is O(sqrt(n)).
+
+//! Function builds rank index from list links
+//! \param lst ptr to List object
+//! \return    1
+LIST_TEMPLATE int list_rank_build(LIST_TYPE* lst) {
+    ListRankIndex* rank = &lst->rank;
+    int limit = rank->block_limit;
+    const Storage<T>& data = lst->data;
+
+    rank->n_blocks    = 0;
+    rank->n_ids       = 0;
+    rank->size        = 0;
+
+    for (int cell = lst->head; cell != 0; cell = data.next(cell), rank->size++) {
+        if (rank->size % limit == 0) {
+            rank->block_first[rank->n_ids] = cell;
+            rank->block_size [rank->n_ids] = 0;
+            rank->order[rank->n_blocks++]  = rank->n_ids++;
+        }
+
+        rank->block_of[cell] = rank->n_ids - 1;
+        rank->block_size[rank->n_ids - 1]++;
+    }
+
+    return 1;
+}
+
+//! Function allocates rank index arrays for capacity cells: block_of has entry for each cell,
+//! block arrays have entry for each block id (rebuild gives ids to capacity / block_limit + 1 blocks,
+//! splits take other ids till rebuild)
+//! \param rank     ptr to ListRankIndex object
+//! \param capacity number of cells
+//! \return         1 if success, else 0
+inline int list_rank_alloc(ListRankIndex* rank, int capacity) {
+    int limit = 16;
+    while (limit * limit < capacity) limit *= 2;
+
+    int max_ids = 2 * (capacity / limit + 1);
+
+    int*  block_of = (int*) realloc(rank->block_of, capacity * sizeof(int));
+    if (block_of == NULL) return 0;
+    rank->block_of = block_of;
+
+    int** arrays[] = { &rank->block_first, &rank->block_size, &rank->order };
+    for (int i = 0; i < 3; i++) {
+        int* new_array = (int*) realloc(*arrays[i], max_ids * sizeof(int));
+        if (new_array == NULL) return 0;
+
+        *arrays[i] = new_array;
+    }
+
+    rank->block_limit = limit;
+    rank->max_ids     = max_ids;
+    return 1;
+}
+
+//! Function turns on rank index for list
+//! \param lst ptr to List object
+//! \return    1 if success, else 0
+LIST_TEMPLATE int list_rank_enable(LIST_TYPE* lst) {
+    ASSERT_OK(lst, "Check before list_rank_enable func", 0);
+
+    if (!list_rank_alloc(&lst->rank, lst->capacity)) {
+        list_rank_disable(lst);
+
+        errno = errors::NOT_ENOUGH_MEMORY;
+        return 0;
+    }
+
+    return list_rank_build(lst);
+}
+
+//! Function turns off rank index for list and frees its memory
+//! \param lst ptr to List object
+//! \return    1
+LIST_TEMPLATE int list_rank_disable(LIST_TYPE* lst) {
+    ListRankIndex* rank = &lst->rank;
+
+    free(rank->block_of);
+    free(rank->block_first);
+    free(rank->block_size);
+    free(rank->order);
+
+    *rank = { };
+    return 1;
+}
+
+//! Function finds position of block in logical order
+//! \param rank ptr to ListRankIndex object
+//! \param id   block id
+//! \return     position of block (-1 if there is no such block)
+inline int list_rank_position(const ListRankIndex* rank, int id) {
+    for (int i = 0; i < rank->n_blocks; i++) {
+        if (rank->order[i] == id) return i;
+    }
+
+    return -1;
+}
+
+//! Function splits too big block into two
+//! \param lst ptr to List object
+//! \param id  block id
+LIST_TEMPLATE void list_rank_split(LIST_TYPE* lst, int id) {
+    ListRankIndex* rank = &lst->rank;
+
+    if (rank->n_ids >= rank->max_ids) {
+        list_rank_build(lst);
+        return;
+    }
+
+    const Storage<T>& data = lst->data;     // Rank index only reads cells, so shared chunks aren`t copied
+
+    int cell = rank->block_first[id];
+    for (int i = 0; i < rank->block_limit; i++) {
+        cell = data.next(cell);
+    }
+
+    int new_id = rank->n_ids++;
+    rank->block_first[new_id] = cell;
+    rank->block_size [new_id] = rank->block_size[id] - rank->block_limit;
+    rank->block_size [id]     = rank->block_limit;
+
+    for (int i = 0; i < rank->block_size[new_id]; i++, cell = data.next(cell)) {
+        rank->block_of[cell] = new_id;
+    }
+
+    int pos = list_rank_position(rank, id);
+    memmove(&rank->order[pos + 2], &rank->order[pos + 1], (rank->n_blocks - pos - 1) * sizeof(int));
+    rank->order[pos + 1] = new_id;
+    rank->n_blocks++;
+}
+
+//! Function adds inserted element to rank index
+//! \param lst       ptr to List object
+//! \param prev_cell physical index of element, after which element was inserted (0 if it is new head)
+//! \param cell      physical index of inserted element
+LIST_TEMPLATE void list_rank_insert(LIST_TYPE* lst, int prev_cell, int cell) {
+    ListRankIndex* rank = &lst->rank;
+
+    int id = 0;
+    if (rank->n_blocks == 0) {
+        rank->n_ids = 0;
+
+        id = rank->n_ids++;
+        rank->block_first[id] = cell;
+        rank->block_size [id] = 0;
+        rank->order[rank->n_blocks++] = id;
+    } else if (prev_cell == 0) {
+        id = rank->order[0];
+        rank->block_first[id] = cell;
+    } else {
+        id = rank->block_of[prev_cell];
+    }
+
+    rank->block_of[cell] = id;
+    rank->block_size[id]++;
+    rank->size++;
+
+    if (rank->block_size[id] > 2 * rank->block_limit) {
+        list_rank_split(lst, id);
+    }
+}
+
+//! Function removes element from rank index
+//! \param lst  ptr to List object
+//! \param cell physical index of removed element (should be called after element is unlinked)
+LIST_TEMPLATE void list_rank_remove(LIST_TYPE* lst, int cell) {
+    ListRankIndex* rank = &lst->rank;
+    const Storage<T>& data = lst->data;
+
+    int id = rank->block_of[cell];
+    rank->block_size[id]--;
+    rank->size--;
+
+    if (rank->block_size[id] == 0) {
+        int pos = list_rank_position(rank, id);
+        memmove(&rank->order[pos], &rank->order[pos + 1], (rank->n_blocks - pos - 1) * sizeof(int));
+        rank->n_blocks--;
+    } else if (rank->block_first[id] == cell) {
+        rank->block_first[id] = data.next(cell);
+    }
+
+    // Too many small blocks make lookup slow, so index is rebuilt------------
+    if (rank->n_blocks > 4 * (rank->size / rank->block_limit + 1)) {
+        list_rank_build(lst);
+    }
+}
+
+//! Function updates rank index after two used cells were swapped
+//! \param lst    ptr to List object
+//! \param first  physical index of first cell
+//! \param second physical index of second cell
+LIST_TEMPLATE void list_rank_swap(LIST_TYPE* lst, int first, int second) {
+    ListRankIndex* rank = &lst->rank;
+
+    int first_id  = rank->block_of[first];
+    int second_id = rank->block_of[second];
+    int first_is_head  = rank->block_first[first_id]  == first;
+    int second_is_head = rank->block_first[second_id] == second;
+
+    rank->block_of[first]  = second_id;
+    rank->block_of[second] = first_id;
+
+    if (first_is_head)  rank->block_first[first_id]  = second;
+    if (second_is_head) rank->block_first[second_id] = first;
+}
+
+//! Function updates rank index after used cell was moved to free cell
+//! \param lst  ptr to List object
+//! \param from physical index of old cell
+//! \param to   physical index of new cell
+LIST_TEMPLATE void list_rank_move(LIST_TYPE* lst, int from, int to) {
+    ListRankIndex* rank = &lst->rank;
+
+    int id = rank->block_of[from];
+    rank->block_of[to] = id;
+
+    if (rank->block_first[id] == from) rank->block_first[id] = to;
+}
+
+//! Function finds physical index of element by logical index
+//! \param lst       ptr to List object
+//! \param log_index logical index
+//! \return          physical index (0 if there is no element with such logical index)
+LIST_TEMPLATE int list_rank_find(LIST_TYPE* lst, int log_index) {
+    ListRankIndex* rank = &lst->rank;
+    const Storage<T>& data = lst->data;
+
+    for (int i = 0; i < rank->n_blocks; i++) {
+        int id = rank->order[i];
+
+        if (log_index < rank->block_size[id]) {
+            int cell = rank->block_first[id];
+            for ( ; log_index > 0; log_index--) {
+                cell = data.next(cell);
+            }
+
+            return cell;
+        }
+        log_index -= rank->block_size[id];
+    }
+
+    return 0;
+}
+// ----------------------------------------------------------------------------
+
+#endif // LIST_RANKH
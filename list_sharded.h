@@ -0,0 +1,282 @@
+//
+//  Created by IvanBrekman on 03.11.2021.
+//
+
+#ifndef LIST_SHARDEDH
+#define LIST_SHARDEDH
+
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <unistd.h>
+
+// Sharded list----------------------------------------------------------------
+// ShardedList keeps n_shards independent List objects with their own cells, tail and first_free.
+// Thread appends to its shard (threads get shards in turn, like free shards of ConcurrentList), so
+// threads don`t touch memory of each other, while there are not more threads than shards. Shard has
+// lock for threads, which got the same shard, it is never waited for, if thread has its own shard.
+// Shard lists are unchecked (see ListShard): arguments are checked once by sharded functions.
+// Logical view is shard 0, then shard 1, ...: get finds shard by binary search in prefix sums of
+// shard sizes, sharded_begin/sharded_next walk all elements, merge_shards makes one linearized List.
+// !Note! logical view functions can be called, only if no thread changes list
+
+//! ShardedList Constructor
+//! \param lst      ptr to ShardedList object
+//! \param capacity start capacity of each shard (default BUFFER_DEFAULT_SIZE)
+//! \param n_shards number of shards (default SHARDED_AUTO - number of CPUs)
+//! \return         1 if success, else 0
+LIST_TEMPLATE int list_ctor(SHARDED_TYPE* lst, int capacity, int n_shards) {
+    ASSERT_IF(VALID_PTR(lst), "Invalid lst ptr", 0);
+    ASSERT_IF(capacity > 0,   "Incorrect capacity: (<= 0)", 0);
+    ASSERT_IF(SHARDED_AUTO <= n_shards && n_shards <= SHARDED_MAX_SHARDS, "Incorrect number of shards", 0);
+
+    if (n_shards == SHARDED_AUTO) n_shards = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (n_shards < 1)                  n_shards = 1;
+    if (n_shards > SHARDED_MAX_SHARDS) n_shards = SHARDED_MAX_SHARDS;
+
+    *lst = { };
+    lst->shards = (ListShard<T, Storage, Validation>*) aligned_alloc(alignof(ListShard<T, Storage, Validation>),
+                                                                     n_shards * sizeof(ListShard<T, Storage, Validation>));
+    lst->prefix = (int*) calloc(n_shards + 1, sizeof(int));
+
+    if (lst->shards == NULL || lst->prefix == NULL) {
+        free(lst->shards);
+        free(lst->prefix);
+        *lst = { };
+
+        errno = errors::NOT_ENOUGH_MEMORY;
+        return 0;
+    }
+
+    for (int i = 0; i < n_shards; i++) {
+        lst->shards[i] = { };
+
+        if (!list_ctor(&lst->shards[i].list, capacity)) {
+            lst->n_shards = i;
+            list_dtor(lst);
+
+            errno = errors::NOT_ENOUGH_MEMORY;
+            return 0;
+        }
+    }
+    lst->n_shards     = n_shards;
+    lst->prefix_valid = 1;
+
+    return 1;
+}
+
+//! ShardedList Destructor (no thread should use list)
+//! \param lst ptr to ShardedList object
+//! \return    1 if success, else 0
+LIST_TEMPLATE int list_dtor(SHARDED_TYPE* lst) {
+    ASSERT_IF(VALID_PTR(lst), "Invalid lst ptr", 0);
+
+    for (int i = 0; i < lst->n_shards; i++) {
+        list_dtor(&lst->shards[i].list);
+    }
+    free(lst->shards);
+    free(lst->prefix);
+
+    lst->shards   = NULL;
+    lst->prefix   = NULL;
+    lst->n_shards = -1;
+    return 1;
+}
+
+//! Function checks all shards (no thread should change list)
+//! \param lst ptr to ShardedList object
+//! \return    error code of first bad shard (0 if all is good)
+LIST_TEMPLATE int list_error(SHARDED_TYPE* lst) {
+    if (!VALID_PTR(lst)) {
+        return errors::INVALID_LIST_PTR;
+    }
+    if (lst->shards == NULL || lst->prefix == NULL || lst->n_shards <= 0) {
+        return errors::INCORRECT_CAPACITY;
+    }
+
+    for (int i = 0; i < lst->n_shards; i++) {
+        int error = list_error(&lst->shards[i].list);
+        if (error != errors::OK) return error;
+    }
+
+    return errors::OK;
+}
+
+//! Function gets number of elements (it is exact only if no thread changes list)
+//! \param lst ptr to ShardedList object
+//! \return    number of elements
+LIST_TEMPLATE int list_size(SHARDED_TYPE* lst) {
+    int size = 0;
+    for (int i = 0; i < lst->n_shards; i++) {
+        size += __atomic_load_n(&lst->shards[i].list.size, __ATOMIC_RELAXED);
+    }
+
+    return size;
+}
+
+//! Function prints all elements in logical order for user (no thread should change list)
+//! \param lst ptr to ShardedList object
+//! \param sep ptr to sep string (default ", ")
+//! \param end ptr to end string (default "\n")
+//! \return    1 if success, else 0
+LIST_TEMPLATE int print_list(SHARDED_TYPE* lst, const char* sep, const char* end) {
+    ASSERT_IF(list_error(lst) == errors::OK, "Check before print_list func", 0);
+    ASSERT_IF(VALID_PTR(sep), "Invalid sep ptr", 0);
+    ASSERT_IF(VALID_PTR(end), "Invalid end ptr", 0);
+
+    char value_str[MAX_VALUE_STR_SIZE] = "";
+
+    printf("[ ");
+    for (ShardedCursor cursor = sharded_begin(lst); cursor.ph_index != 0; ) {
+        ListValueTraits<T>::format(value_str, MAX_VALUE_STR_SIZE, lst->shards[cursor.shard].list.data.value(cursor.ph_index));
+        printf("%3s", value_str);
+
+        if (sharded_next(lst, &cursor)) printf("%s", sep);
+    }
+    printf(" ]%s", end);
+
+    return 1;
+}
+
+//! Function inserts value after tail of shard without checks of arguments (and of shard list)
+//! \param lst   ptr to ShardedList object
+//! \param value inserted value
+//! \param shard number of shard
+//! \return      physical index of inserted element in shard (< 0 if error)
+LIST_TEMPLATE int sharded_append(SHARDED_TYPE* lst, LIST_VALUE value, int shard) {
+    ListShard<T, Storage, Validation>* list_shard = &lst->shards[shard];
+
+    concurrent_lock(&list_shard->lock);
+    int ph_index = push_back(&list_shard->list, value);
+    concurrent_unlock(&list_shard->lock);
+
+    if (__atomic_load_n(&lst->prefix_valid, __ATOMIC_RELAXED)) {    // Shared line is written only once after get
+        __atomic_store_n(&lst->prefix_valid, 0, __ATOMIC_RELAXED);
+    }
+
+    return ph_index;
+}
+
+//! Function inserts value after tail of shard (several threads can push at once)
+//! \param lst   ptr to ShardedList object
+//! \param value inserted value
+//! \param shard number of shard
+//! \return      physical index of inserted element in shard (< 0 if error)
+LIST_TEMPLATE int sharded_push_back(SHARDED_TYPE* lst, LIST_VALUE value, int shard) {
+    LIST_ASSERT_IF(lst, VALID_PTR(lst), "Invalid lst ptr", errors::INVALID_LIST_PTR);
+    LIST_ASSERT_IF(lst, 0 <= shard && shard < lst->n_shards, "Incorrect shard", errors::BAD_PH_INDEX);
+
+    return sharded_append(lst, value, shard);
+}
+
+//! Function inserts value after tail of shard of current thread (several threads can push at once)
+//! \param lst   ptr to ShardedList object
+//! \param value inserted value
+//! \return      physical index of inserted element in shard (< 0 if error)
+LIST_TEMPLATE int push_back(SHARDED_TYPE* lst, LIST_VALUE value) {
+    LIST_ASSERT_IF(lst, VALID_PTR(lst), "Invalid lst ptr", errors::INVALID_LIST_PTR);
+
+    return sharded_append(lst, value, concurrent_shard() % lst->n_shards);
+}
+
+//! Function rebuilds prefix sums of shard sizes (no thread should change list)
+//! \param lst ptr to ShardedList object
+//! \return    number of elements
+LIST_TEMPLATE int sharded_prefix(SHARDED_TYPE* lst) {
+    ASSERT_IF(VALID_PTR(lst), "Invalid lst ptr", 0);
+
+    lst->prefix[0] = 0;
+    for (int i = 0; i < lst->n_shards; i++) {
+        lst->prefix[i + 1] = lst->prefix[i] + lst->shards[i].list.size;
+    }
+    lst->prefix_valid = 1;
+
+    return lst->prefix[lst->n_shards];
+}
+
+//! Function gets element by logical index of merged view (no thread should change list)
+//! \param lst       ptr to ShardedList object
+//! \param log_index logical index
+//! \return          value of element
+LIST_TEMPLATE T get(SHARDED_TYPE* lst, int log_index) {
+    LIST_ASSERT_IF(lst, VALID_PTR(lst), "Invalid lst ptr", ListValueTraits<T>::from_error(errors::INVALID_LIST_PTR));
+
+    if (!lst->prefix_valid) sharded_prefix(lst);
+
+    if (log_index < 0 || log_index >= lst->prefix[lst->n_shards]) {
+        errno = errors::BAD_LOG_INDEX;
+        return ListValueTraits<T>::from_error(errors::BAD_LOG_INDEX);
+    }
+
+    // Last shard, which begins not after log_index (empty shards are skipped)
+    int left  = 0;
+    int right = lst->n_shards;
+    while (right - left > 1) {
+        int middle = (left + right) / 2;
+
+        if (lst->prefix[middle] <= log_index) left  = middle;
+        else                                  right = middle;
+    }
+
+    return get(&lst->shards[left].list, log_index - lst->prefix[left]);
+}
+
+//! Function gets position of first element (no thread should change list)
+//! \param lst ptr to ShardedList object
+//! \return    cursor (ph_index is 0, if list is empty)
+LIST_TEMPLATE ShardedCursor sharded_begin(SHARDED_TYPE* lst) {
+    ShardedCursor cursor = { 0, 0 };
+    ASSERT_IF(VALID_PTR(lst), "Invalid lst ptr", cursor);
+
+    while (cursor.shard < lst->n_shards && lst->shards[cursor.shard].list.head == 0) cursor.shard++;
+    if (cursor.shard < lst->n_shards) cursor.ph_index = lst->shards[cursor.shard].list.head;
+
+    return cursor;
+}
+
+//! Function moves cursor to next element of merged view (no thread should change list). Function is
+//! called for each element, so ptrs aren`t checked (as by storage accessors)
+//! \param lst    ptr to ShardedList object
+//! \param cursor ptr to cursor, which is at element
+//! \return       1 if cursor is at element, else 0 (end of list)
+LIST_TEMPLATE int sharded_next(SHARDED_TYPE* lst, ShardedCursor* cursor) {
+    cursor->ph_index = lst->shards[cursor->shard].list.data.next(cursor->ph_index);
+
+    while (cursor->ph_index == 0 && ++cursor->shard < lst->n_shards) {
+        cursor->ph_index = lst->shards[cursor->shard].list.head;
+    }
+
+    return cursor->ph_index != 0;
+}
+
+//! Function concatenates shards to one linearized list: element i gets cell i + 1, as after
+//! list_from_text (shards are not changed, no thread should change them)
+//! \param lst    ptr to ShardedList object
+//! \param merged ptr to List object (it shouldn`t be constructed)
+//! \return       1 if success, else 0
+LIST_TEMPLATE int merge_shards(SHARDED_TYPE* lst, LIST_TYPE* merged) {
+    ASSERT_IF(list_error(lst) == errors::OK, "Check before merge_shards func", 0);
+    ASSERT_IF(VALID_PTR(merged), "Invalid merged ptr", 0);
+
+    *merged = { };
+
+    int size = sharded_prefix(lst);
+    if (!list_ingest_reserve<T, Storage, Validation>(merged, (size_t)size)) {
+        *merged = { };
+
+        errno = errors::NOT_ENOUGH_MEMORY;
+        return 0;
+    }
+
+    int capacity = merged->capacity;
+    int cell     = 1;
+    for (ShardedCursor cursor = sharded_begin(lst); cursor.ph_index != 0; sharded_next(lst, &cursor), cell++) {
+        merged->data.set(cell, lst->shards[cursor.shard].list.data.value(cursor.ph_index),
+                         cell + 1 < capacity ? cell + 1 : 0, cell - 1);
+    }
+
+    return list_from_text_finish(merged);
+}
+// ----------------------------------------------------------------------------
+
+#endif // LIST_SHARDEDH
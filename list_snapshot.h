@@ -0,0 +1,247 @@
+//
+//  Created by IvanBrekman on 03.11.2021.
+//
+
+#ifndef LIST_SNAPSHOTH
+#define LIST_SNAPSHOTH
+
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Snapshot--------------------------------------------------------------------
+// list_save writes ListFileHeader and raw array of ListElement (in native byte order).
+// list_load checks header and either reads cells to memory (O(n)) or maps file and uses
+// it as cells of list (O(1): pages are read only when they are touched). Free map and
+// rank index are not saved, they are rebuilt on load, if they were on.
+// Load, which copies cells (LIST_LOAD_COPY, storages, which can`t map cells, or failed mmap), also
+// checks links of elements and free cells chains. Mapped load checks only header and fields (to
+// stay O(1)): links of mapped file are trusted.
+
+const char LIST_FILE_SIGNATURE[8] = { 'L', 'I', 'S', 'T', 'S', 'N', 'A', 'P' };
+const int  LIST_FILE_VERSION      = 1;
+const int  LIST_FILE_PART_SIZE    = 4096;   // Size of part, which is read at once by copying load
+
+static_assert(sizeof(ListFileHeader) == 64, "ListFileHeader should keep cells aligned by 64 bytes");
+
+//! Function reads cells of snapshot to memory of list
+//! \param lst    ptr to List object with allocated storage
+//! \param fd     descriptor of snapshot file
+//! \param offset offset of cells in file
+//! \return       1 if success, else 0
+LIST_TEMPLATE int list_load_cells(LIST_TYPE* lst, int fd, off_t offset) {
+    const int PART_CELLS = sizeof(ListElement<T>) < (size_t)LIST_FILE_PART_SIZE ?
+                           LIST_FILE_PART_SIZE / (int)sizeof(ListElement<T>) : 1;
+
+    ListElement<T> part[PART_CELLS];
+
+    int capacity = lst->capacity;
+    for (int first = 0; first < capacity; first += PART_CELLS) {
+        int    n_cells = capacity - first < PART_CELLS ? capacity - first : PART_CELLS;
+        size_t size    = n_cells * sizeof(ListElement<T>);
+
+        if (pread(fd, part, size, offset + (off_t)(first * sizeof(ListElement<T>))) != (ssize_t)size) return 0;
+
+        for (int i = 0; i < n_cells; i++) {
+            lst->data.set(first + i, part[i].value, part[i].next, part[i].prev);
+        }
+    }
+
+    return 1;
+}
+
+//! Function checks links of loaded cells: elements chain goes from head to tail through size used
+//! cells with matching prev links, free cells chain (if it is kept) goes through free cells only
+//! \param lst       ptr to List object with loaded cells and fields
+//! \param has_chain 0 if free cells chain isn`t kept (free map was on)
+//! \return          1 if links are consistent, else 0
+LIST_TEMPLATE int list_load_check_links(LIST_TYPE* lst, int has_chain) {
+    int capacity = lst->capacity;
+    int size     = lst->size;
+
+    int count = 0;
+    int prev  = 0;
+    for (int cell = lst->head; cell != 0; prev = cell, cell = lst->data.next(cell), count++) {
+        if (count == size || cell <= 0 || cell >= capacity) return 0;
+        if (list_cell_is_free(lst, cell) || lst->data.prev(cell) != prev) return 0;
+    }
+    if (count != size || lst->tail != prev) return 0;
+
+    if (!has_chain) return 1;
+
+    count = 0;
+    for (int cell = lst->first_free; cell != 0; cell = lst->data.next(cell), count++) {
+        if (count == capacity - 1 - size || cell <= 0 || cell >= capacity) return 0;
+        if (!list_cell_is_free(lst, cell)) return 0;
+    }
+
+    return 1;
+}
+
+//! Function saves list to binary snapshot file. File is written to <filename>.tmp and then renamed,
+//! so list, which cells are mapped from the same file, can be saved too
+//! \param lst      ptr to List object
+//! \param filename ptr to path of file
+//! \return         1 if success, else 0
+LIST_TEMPLATE int list_save(LIST_TYPE* lst, const char* filename) {
+    ASSERT_OK(lst, "Check before list_save func", 0);
+    LIST_ASSERT_IF(lst, VALID_PTR(filename), "Invalid filename ptr", 0);
+
+    const Storage<T>& data = lst->data;     // Const accessors: saving doesn`t copy chunks shared with snapshots
+
+    ListFileHeader header = { };
+    memcpy(header.signature, LIST_FILE_SIGNATURE, sizeof(header.signature));
+
+    header.version       = LIST_FILE_VERSION;
+    header.header_size   = (int)sizeof(ListFileHeader);
+    header.element_size  = (int)sizeof(ListElement<T>);
+    header.value_size    = (int)sizeof(T);
+
+    header.capacity      = lst->capacity;
+    header.head          = lst->head;
+    header.tail          = lst->tail;
+    header.size          = lst->size;
+    header.first_free    = lst->first_free;
+    header.is_sorted     = lst->is_sorted;
+    header.sorted_prefix = lst->sorted_prefix;
+    header.checkpoint    = lst->checkpoint;
+
+    if (lst->free_map.bits   != NULL) header.flags |= LIST_FILE_FREE_MAP;
+    if (lst->rank.block_of   != NULL) header.flags |= LIST_FILE_RANK;
+
+    char tmp_name[FILENAME_MAX] = "";
+    if (snprintf(tmp_name, sizeof(tmp_name), "%s.tmp", filename) >= (int)sizeof(tmp_name)) {
+        errno = ENAMETOOLONG;
+        return 0;
+    }
+
+    FILE* file = fopen(tmp_name, "wb");
+    if (file == NULL) return 0;
+
+    int ok = fwrite(&header, sizeof(header), 1, file) == 1;
+
+    int capacity = lst->capacity;
+    if constexpr (Storage<T>::MAPPABLE) {
+        ok = ok && fwrite(data.cells, sizeof(ListElement<T>), capacity, file) == (size_t)capacity;
+    } else {
+        for (int i = 0; i < capacity && ok; i++) {
+            ListElement<T> cell = { data.value(i), data.next(i), data.prev(i) };
+            ok = fwrite(&cell, sizeof(cell), 1, file) == 1;
+        }
+    }
+
+    ok = (fclose(file) == 0) && ok;
+    if (!ok || rename(tmp_name, filename) != 0) {
+        int error = errno;
+        unlink(tmp_name);
+
+        errno = error;
+        return 0;
+    }
+
+    return 1;
+}
+
+//! Function loads list from snapshot file, which was saved by list_save
+//! \param lst      ptr to List object (it shouldn`t be constructed)
+//! \param filename ptr to path of file
+//! \param mode     how cells are loaded (see list_load_modes, default LIST_LOAD_PRIVATE).
+//!                 Storages, which can`t keep mapped cells, always copy them
+//! \return         1 if success, else 0
+LIST_TEMPLATE int list_load(LIST_TYPE* lst, const char* filename, int mode) {
+    LIST_ASSERT_IF(lst, VALID_PTR(lst),      "Invalid lst ptr", 0);
+    LIST_ASSERT_IF(lst, VALID_PTR(filename), "Invalid filename ptr", 0);
+    LIST_ASSERT_IF(lst, LIST_LOAD_COPY <= mode && mode <= LIST_LOAD_READONLY, "Incorrect mode", 0);
+
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) return 0;
+
+    struct stat file_stat = { };
+    ListFileHeader header = { };
+
+    if (fstat(fd, &file_stat) != 0 || pread(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header)) {
+        close(fd);
+        errno = errors::BAD_SNAPSHOT;
+        return 0;
+    }
+
+    if (memcmp(header.signature, LIST_FILE_SIGNATURE, sizeof(header.signature)) != 0 ||
+        header.version      != LIST_FILE_VERSION                ||
+        header.header_size  <  (int)sizeof(ListFileHeader)      ||
+        header.element_size != (int)sizeof(ListElement<T>)     ||
+        header.value_size   != (int)sizeof(T)                   ||
+        header.capacity     <= 0                                ||
+        (long long)file_stat.st_size < header.header_size + (long long)header.capacity * header.element_size) {
+        close(fd);
+        errno = errors::BAD_SNAPSHOT;
+        return 0;
+    }
+
+    *lst = { };
+    lst->capacity = header.capacity;
+
+    int loaded = 0;
+    int mapped = 0;     // Cells are mapped from file, else they are copied by list_load_cells
+    if (Storage<T>::MAPPABLE && mode != LIST_LOAD_COPY && header.header_size % alignof(ListElement<T>) == 0) {
+        int   prot = mode == LIST_LOAD_READONLY ? PROT_READ : PROT_READ | PROT_WRITE;
+        void* file = mmap(NULL, (size_t)file_stat.st_size, prot, MAP_PRIVATE, fd, 0);
+
+        if (file != MAP_FAILED) {
+            if constexpr (Storage<T>::MAPPABLE) {
+                loaded = mapped = lst->data.map(file, (size_t)file_stat.st_size, (size_t)header.header_size, mode == LIST_LOAD_READONLY);
+            }
+        }
+    }
+    if (!loaded) {
+        if (!lst->data.alloc(header.capacity)) {
+            close(fd);
+            *lst = { };
+
+            errno = errors::NOT_ENOUGH_MEMORY;
+            return 0;
+        }
+
+        loaded = list_load_cells(lst, fd, header.header_size);
+    }
+    close(fd);
+
+    if (!loaded) {
+        lst->data.release();
+        *lst = { };
+
+        errno = errors::BAD_SNAPSHOT;
+        return 0;
+    }
+
+    lst->head          = header.head;
+    lst->tail          = header.tail;
+    lst->size          = header.size;
+    lst->first_free    = header.first_free;
+    lst->is_sorted     = header.is_sorted;
+    lst->sorted_prefix = header.sorted_prefix;
+    lst->checkpoint    = header.checkpoint;
+
+    // Copied cells (any mode, if storage can`t map them or mmap failed) are read anyway, so links are
+    // checked too. Mapped load stays O(1) and trusts links of file, which header is correct
+    if (list_error(lst) != errors::OK ||
+        (!mapped && !list_load_check_links(lst, !(header.flags & LIST_FILE_FREE_MAP)))) {
+        lst->data.release();
+        *lst = { };
+
+        errno = errors::BAD_SNAPSHOT;
+        return 0;
+    }
+
+    if (header.flags & LIST_FILE_FREE_MAP) list_free_map_enable(lst);
+    if (header.flags & LIST_FILE_RANK)     list_rank_enable(lst);
+
+    ASSERT_OK(lst, "Check after list_load func", 0);
+    return 1;
+}
+// ----------------------------------------------------------------------------
+
+#endif // LIST_SNAPSHOTH
@@ -0,0 +1,393 @@
+//
+//  Created by IvanBrekman on 03.11.2021.
+//
+
+#ifndef LIST_STORAGEH
+#define LIST_STORAGEH
+
+#include <cstdlib>
+#include <cstring>
+#include <sys/mman.h>
+
+// Storage policies------------------------------------------------------------
+// List cells are accessed only through storage policy: value(i), next(i), prev(i), set(...)
+// alloc(capacity), grow(capacity, new_capacity) and release(). Storage doesn`t know anything
+// about list logic, it just keeps cells. Storages with MAPPABLE == 1 can also keep cells
+// right in mapped snapshot file (see list_snapshot.h). CowStorage can share its cells with
+// in-memory snapshots (see list_cow.h). reserve(n_writes) prepares memory for n_writes changed
+// cells: mutators call it before changes, so accessors never need memory, which can be absent.
+
+//! Array of structures: value, next and prev of one cell lie together
+template <typename T>
+struct AosStorage {
+    static const int MAPPABLE = 1;
+
+    ListElement<T>* cells = NULL;
+
+    void*  mapping      = NULL;     // Mapped snapshot file, if cells lie in it
+    size_t mapping_size = 0;
+    int    read_only    = 0;        // Mapping can`t be changed
+
+    T&         value(int index)       { return cells[index].value; }
+    const T&   value(int index) const { return cells[index].value; }
+    int&        next(int index)       { return cells[index].next;  }
+    int         next(int index) const { return cells[index].next;  }
+    int&        prev(int index)       { return cells[index].prev;  }
+    int         prev(int index) const { return cells[index].prev;  }
+
+    void set(int index, const T& value, int next, int prev) {
+        cells[index] = {
+            .value = value,
+            .next  = next,
+            .prev  = prev
+        };
+    }
+
+    int alloc(int capacity) {
+        cells = (ListElement<T>*) calloc(capacity, sizeof(ListElement<T>));
+
+        return cells != NULL;
+    }
+    int map(void* file, size_t file_size, size_t offset, int is_read_only) {
+        mapping      = file;
+        mapping_size = file_size;
+        read_only    = is_read_only;
+
+        cells = (ListElement<T>*)(void*)((char*)file + offset);
+        return 1;
+    }
+    int grow(int capacity, int new_capacity) {
+        if (mapping != NULL) {
+            // Mapped cells can`t be reallocated, so they are moved to heap
+            ListElement<T>* new_cells = (ListElement<T>*) calloc(new_capacity, sizeof(ListElement<T>));
+            if (new_cells == NULL) return 0;
+
+            memcpy(new_cells, cells, capacity * sizeof(ListElement<T>));
+            release();
+
+            cells = new_cells;
+            return 1;
+        }
+
+        ListElement<T>* new_cells = (ListElement<T>*) realloc(cells, new_capacity * sizeof(ListElement<T>));
+        if (new_cells == NULL) return 0;
+
+        cells = new_cells;
+        return 1;
+    }
+    int writable() const {
+        return mapping == NULL || !read_only;
+    }
+    int reserve(int) {
+        return 1;
+    }
+    void release() {
+        if (mapping != NULL) {
+            munmap(mapping, mapping_size);
+            mapping      = NULL;
+            mapping_size = 0;
+            read_only    = 0;
+
+            cells = NULL;
+            return;
+        }
+
+        FREE_PTR(cells, ListElement<T>);
+    }
+};
+
+//! Structure of arrays: values, next links and prev links lie in three parallel arrays,
+//! so value scans are dense and link walks don`t touch values
+template <typename T>
+struct SoaStorage {
+    static const int MAPPABLE = 0;
+
+    T*   values = NULL;
+    int* nexts  = NULL;
+    int* prevs  = NULL;
+
+    T&         value(int index)       { return values[index]; }
+    const T&   value(int index) const { return values[index]; }
+    int&        next(int index)       { return nexts[index];  }
+    int         next(int index) const { return nexts[index];  }
+    int&        prev(int index)       { return prevs[index];  }
+    int         prev(int index) const { return prevs[index];  }
+
+    void set(int index, const T& value, int next, int prev) {
+        values[index] = value;
+        nexts [index] = next;
+        prevs [index] = prev;
+    }
+
+    int alloc(int capacity) {
+        values = (T*)   calloc(capacity, sizeof(T));
+        nexts  = (int*) calloc(capacity, sizeof(int));
+        prevs  = (int*) calloc(capacity, sizeof(int));
+
+        if (values == NULL || nexts == NULL || prevs == NULL) {
+            free(values);
+            free(nexts);
+            free(prevs);
+            values = NULL;
+            nexts  = prevs = NULL;
+
+            return 0;
+        }
+        return 1;
+    }
+    int grow(int, int new_capacity) {
+        T* new_values = (T*) realloc(values, new_capacity * sizeof(T));
+        if (new_values == NULL) return 0;
+        values = new_values;
+
+        int* new_nexts = (int*) realloc(nexts, new_capacity * sizeof(int));
+        if (new_nexts == NULL) return 0;
+        nexts = new_nexts;
+
+        int* new_prevs = (int*) realloc(prevs, new_capacity * sizeof(int));
+        if (new_prevs == NULL) return 0;
+        prevs = new_prevs;
+
+        return 1;
+    }
+    int writable() const {
+        return 1;
+    }
+    int reserve(int) {
+        return 1;
+    }
+    void release() {
+        FREE_PTR(values, T);
+        FREE_PTR(nexts,  int);
+        FREE_PTR(prevs,  int);
+    }
+};
+
+//! Cells lie in chunks of (1 << LIST_CHUNK_BITS) cells. Growth allocates new chunks and
+//! doesn`t move old ones, so pointers to cells stay valid and old cells are never copied
+template <typename T>
+struct SegmentedStorage {
+    static const int MAPPABLE   = 0;
+    static const int CHUNK_SIZE = 1 << LIST_CHUNK_BITS;
+    static const int CHUNK_MASK = CHUNK_SIZE - 1;
+
+    ListElement<T>** chunks = NULL;
+    int n_chunks = 0;
+
+    ListElement<T>&       cell(int index)       { return chunks[index >> LIST_CHUNK_BITS][index & CHUNK_MASK]; }
+    const ListElement<T>& cell(int index) const { return chunks[index >> LIST_CHUNK_BITS][index & CHUNK_MASK]; }
+
+    T&         value(int index)       { return cell(index).value; }
+    const T&   value(int index) const { return cell(index).value; }
+    int&        next(int index)       { return cell(index).next;  }
+    int         next(int index) const { return cell(index).next;  }
+    int&        prev(int index)       { return cell(index).prev;  }
+    int         prev(int index) const { return cell(index).prev;  }
+
+    void set(int index, const T& value, int next, int prev) {
+        cell(index) = {
+            .value = value,
+            .next  = next,
+            .prev  = prev
+        };
+    }
+
+    int alloc(int capacity) {
+        chunks   = NULL;
+        n_chunks = 0;
+
+        if (!grow(0, capacity)) {
+            release();
+            return 0;
+        }
+        return 1;
+    }
+    int grow(int, int new_capacity) {
+        int new_n_chunks = (new_capacity + CHUNK_MASK) >> LIST_CHUNK_BITS;
+        if (new_n_chunks <= n_chunks) return 1;
+
+        // Only chunk table is reallocated, it is CHUNK_SIZE times smaller than cells
+        ListElement<T>** new_chunks = (ListElement<T>**) realloc(chunks, new_n_chunks * sizeof(ListElement<T>*));
+        if (new_chunks == NULL) return 0;
+        chunks = new_chunks;
+
+        for ( ; n_chunks < new_n_chunks; n_chunks++) {
+            chunks[n_chunks] = (ListElement<T>*) calloc(CHUNK_SIZE, sizeof(ListElement<T>));
+            if (chunks[n_chunks] == NULL) return 0;
+        }
+        return 1;
+    }
+    int writable() const {
+        return 1;
+    }
+    int reserve(int) {
+        return 1;
+    }
+    void release() {
+        for (int i = 0; i < n_chunks; i++) {
+            free(chunks[i]);
+        }
+        n_chunks = 0;
+
+        FREE_PTR(chunks, ListElement<T>*);
+    }
+};
+
+//! Chunk of CowStorage: cells and number of their owners (storage and snapshots)
+template <typename T>
+struct CowChunk {
+    int            refs;
+    ListElement<T> cells[1 << LIST_CHUNK_BITS];
+};
+
+//! Function drops one owner of chunk and frees chunk after last owner (owners can be in different threads)
+//! \param chunk ptr to chunk
+template <typename T>
+void cow_chunk_unref(CowChunk<T>* chunk) {
+    if (__atomic_sub_fetch(&chunk->refs, 1, __ATOMIC_ACQ_REL) == 0) {
+        free(chunk);
+    }
+}
+
+//! Cells lie in chunks like in SegmentedStorage, but chunks can be shared with snapshots (see list_cow.h).
+//! Non-const accessors copy shared chunk before they give cell, so snapshot never sees changes of list.
+//! Copies are taken from spare chunks, which mutator allocated by reserve before changes
+template <typename T>
+struct CowStorage {
+    static const int MAPPABLE   = 0;
+    static const int CHUNK_SIZE = 1 << LIST_CHUNK_BITS;
+    static const int CHUNK_MASK = CHUNK_SIZE - 1;
+
+    CowChunk<T>** chunks = NULL;
+    char*         owned  = NULL;    // owned[i] is 1, if chunk i is known not to be shared (snapshot clears it)
+    int n_chunks = 0;
+    int n_shared = 0;               // Number of chunks, which aren`t owned
+
+    CowChunk<T>** spares   = NULL;  // Allocated chunks for copies (n_chunks ptrs)
+    int           n_spares = 0;
+
+    ListElement<T>& cell(int index) {
+        int chunk = index >> LIST_CHUNK_BITS;
+        if (!owned[chunk]) own(chunk);
+
+        return chunks[chunk]->cells[index & CHUNK_MASK];
+    }
+    const ListElement<T>& cell(int index) const { return chunks[index >> LIST_CHUNK_BITS]->cells[index & CHUNK_MASK]; }
+
+    T&         value(int index)       { return cell(index).value; }
+    const T&   value(int index) const { return cell(index).value; }
+    int&        next(int index)       { return cell(index).next;  }
+    int         next(int index) const { return cell(index).next;  }
+    int&        prev(int index)       { return cell(index).prev;  }
+    int         prev(int index) const { return cell(index).prev;  }
+
+    void set(int index, const T& value, int next, int prev) {
+        cell(index) = {
+            .value = value,
+            .next  = next,
+            .prev  = prev
+        };
+    }
+
+    //! Copies chunk, if snapshots still have it. Accessor can`t report error, so copy is spare chunk
+    //! of reserve: lack of memory here means, that mutator changes more cells, than it reserved
+    void own(int chunk) {
+        CowChunk<T>* shared = chunks[chunk];
+
+        if (__atomic_load_n(&shared->refs, __ATOMIC_ACQUIRE) > 1) {
+            CowChunk<T>* copy = n_spares > 0 ? spares[--n_spares] : (CowChunk<T>*) malloc(sizeof(CowChunk<T>));
+            if (copy == NULL) {
+                PRINT_WARNING("!WARNING! List chunk, which is shared with snapshot, is changed without reserve.\n");
+                abort();
+            }
+
+            memcpy(copy->cells, shared->cells, sizeof(shared->cells));
+            copy->refs    = 1;
+            chunks[chunk] = copy;
+
+            cow_chunk_unref(shared);
+        }
+        owned[chunk] = 1;
+
+        if (--n_shared == 0) drop_spares();
+    }
+    //! Marks all chunks as shared (snapshot has added owner to each chunk)
+    void share() {
+        memset(owned, 0, n_chunks * sizeof(char));
+        n_shared = n_chunks;
+    }
+    void drop_spares() {
+        for ( ; n_spares > 0; n_spares--) {
+            free(spares[n_spares - 1]);
+        }
+    }
+
+    int alloc(int capacity) {
+        chunks   = NULL;
+        owned    = NULL;
+        spares   = NULL;
+        n_chunks = 0;
+        n_shared = 0;
+        n_spares = 0;
+
+        if (!grow(0, capacity)) {
+            release();
+            return 0;
+        }
+        return 1;
+    }
+    int grow(int, int new_capacity) {
+        int new_n_chunks = (new_capacity + CHUNK_MASK) >> LIST_CHUNK_BITS;
+        if (new_n_chunks <= n_chunks) return 1;
+
+        // Snapshots keep their own chunk tables, so table can be moved
+        CowChunk<T>** new_chunks = (CowChunk<T>**) realloc(chunks, new_n_chunks * sizeof(CowChunk<T>*));
+        if (new_chunks == NULL) return 0;
+        chunks = new_chunks;
+
+        char* new_owned = (char*) realloc(owned, new_n_chunks * sizeof(char));
+        if (new_owned == NULL) return 0;
+        owned = new_owned;
+
+        CowChunk<T>** new_spares = (CowChunk<T>**) realloc(spares, new_n_chunks * sizeof(CowChunk<T>*));
+        if (new_spares == NULL) return 0;
+        spares = new_spares;
+
+        for ( ; n_chunks < new_n_chunks; n_chunks++) {
+            chunks[n_chunks] = (CowChunk<T>*) calloc(1, sizeof(CowChunk<T>));
+            if (chunks[n_chunks] == NULL) return 0;
+
+            chunks[n_chunks]->refs = 1;
+            owned [n_chunks]       = 1;
+        }
+        return 1;
+    }
+    int writable() const {
+        return 1;
+    }
+    //! Allocates spare chunks for copies of shared chunks, which n_writes changed cells can lie in
+    int reserve(int n_writes) {
+        int need = n_writes < n_shared ? n_writes : n_shared;
+
+        for ( ; n_spares < need; n_spares++) {
+            spares[n_spares] = (CowChunk<T>*) malloc(sizeof(CowChunk<T>));
+            if (spares[n_spares] == NULL) return 0;
+        }
+        return 1;
+    }
+    void release() {
+        for (int i = 0; i < n_chunks; i++) {
+            cow_chunk_unref(chunks[i]);
+        }
+        n_chunks = 0;
+        n_shared = 0;
+
+        drop_spares();
+        FREE_PTR(chunks, CowChunk<T>*);
+        FREE_PTR(owned,  char);
+        FREE_PTR(spares, CowChunk<T>*);
+    }
+};
+// ----------------------------------------------------------------------------
+
+#endif // LIST_STORAGEH
@@ -4,19 +4,29 @@
 
 #include <cstdio>
 #include <cerrno>
+#include <cstring>
 
 #include "tests/test_work_graph.h"
+#include "tests/bench_list.h"
+#include "tests/test_list.h"
 
 #include "libs/baselib.h"
 #include "libs/file_funcs.h"
 
 #include "list.h"
 
-int main(void) {
+int main(int argc, char* argv[]) {
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+        return run_benchmarks();
+    }
+    if (argc > 1 && strcmp(argv[1], "--test") == 0) {
+        return run_tests();
+    }
+
     test_work_graph();
     return 1;
 
-    List lst = { };
+    List<int> lst = { };
 
     errno = 0;
     list_ctor(&lst);
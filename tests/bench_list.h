@@ -0,0 +1,1201 @@
+//
+//  Created by IvanBrekman on 03.11.2021.
+//
+
+#ifndef LIST_BENCHH
+#define LIST_BENCHH
+
+#include "../config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include <sys/resource.h>
+
+#include "../list.h"
+#include "../libs/baselib.h"
+#include "../libs/file_funcs.h"
+#include "../libs/text_scan.h"
+
+const int BENCH_LIST_SIZE = 1 << 18;
+const int BENCH_REPEATS   = 20;
+const int BENCH_THREAD_OPS = 1 << 17;   // Push/pop pairs of one thread in concurrent benchmark
+const int BENCH_MAX_THREADS = 8;
+const int BENCH_QUEUE_SIZE  = 1 << 10; // Capacity of ListQueue in queue benchmark
+
+//! Function returns monotonic time
+//! \return time in seconds
+static double bench_now() {
+    struct timespec ts = {};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+//! Function prints one row of benchmark table
+//! \param name    name of measured case
+//! \param seconds measured time
+//! \param ops     number of operations in measured case
+static void bench_report(const char* name, double seconds, double ops) {
+    printf("    %-40s %10.3f ms %10.2f ns/op\n", name, seconds * 1e3, seconds * 1e9 / ops);
+}
+
+//! Function measures push_back, value scan and link walk for one storage mode
+//! \param name name of storage mode
+//! \return     checksum (to keep compiler from dropping loops)
+template <template <typename> class Storage>
+static long bench_storage_mode(const char* name) {
+    printf("%s:\n", name);
+
+    List<int, Storage> lst = { };
+    list_ctor(&lst, BENCH_LIST_SIZE + 1);
+
+    double start = bench_now();
+    for (int i = 0; i < BENCH_LIST_SIZE; i++) {
+        push_back(&lst, i);
+    }
+    bench_report("push_back", bench_now() - start, BENCH_LIST_SIZE);
+
+    long checksum = 0;
+
+    start = bench_now();
+    for (int r = 0; r < BENCH_REPEATS; r++) {
+        checksum += find_value(&lst, -r - 1);
+    }
+    bench_report("find_value (value scan)", bench_now() - start, (double)BENCH_LIST_SIZE * BENCH_REPEATS);
+
+    start = bench_now();
+    for (int r = 0; r < BENCH_REPEATS; r++) {
+        for (int i = lst.head; i != 0; i = lst.data.next(i)) {
+            checksum += i;
+        }
+    }
+    bench_report("next walk (link scan)", bench_now() - start, (double)BENCH_LIST_SIZE * BENCH_REPEATS);
+
+    start = bench_now();
+    for (int r = 0; r < BENCH_REPEATS; r++) {
+        for (int i = lst.head; i != 0; i = lst.data.next(i)) {
+            checksum += lst.data.value(i);
+        }
+    }
+    bench_report("next walk with values", bench_now() - start, (double)BENCH_LIST_SIZE * BENCH_REPEATS);
+
+    list_dtor(&lst);
+    return checksum;
+}
+
+//! Function compares AoS and SoA storage modes of List
+//! \return checksum
+static long bench_storage_modes() {
+    printf("|-------------------------      Storage modes      -------------------------|\n");
+
+    long checksum = 0;
+    checksum += bench_storage_mode<AosStorage>("AosStorage (ListElement array)");
+    checksum += bench_storage_mode<SoaStorage>("SoaStorage (value/next/prev arrays)");
+    checksum += bench_storage_mode<SegmentedStorage>("SegmentedStorage (chunks of cells)");
+    checksum += bench_storage_mode<CowStorage>      ("CowStorage (shared chunks)");
+
+    return checksum;
+}
+
+//! Function measures one resize_list_capacity call on full list
+//! \param name name of storage mode
+//! \return     checksum
+template <template <typename> class Storage>
+static long bench_resize_mode(const char* name) {
+    List<int, Storage> lst = { };
+    list_ctor(&lst, BENCH_LIST_SIZE * 4 + 1);
+
+    for (int i = 0; i < BENCH_LIST_SIZE * 4; i++) {
+        lst.data.set(i + 1, i, i + 2, i);   // Filling directly: push_back is too slow for this size
+    }
+    lst.data.set(0, 0, 1, BENCH_LIST_SIZE * 4);
+    lst.data.next(BENCH_LIST_SIZE * 4) = 0;
+    lst.head = 1;
+    lst.tail = lst.size = BENCH_LIST_SIZE * 4;
+    lst.first_free = 0;
+
+    const int* first_value = &lst.data.value(1);
+
+    double start = bench_now();
+    resize_list_capacity(&lst, lst.capacity * 2);
+    bench_report(name, bench_now() - start, BENCH_LIST_SIZE * 4);
+    printf("    %-40s %10s\n", "old cells stayed in place", first_value == &lst.data.value(1) ? "yes" : "no");
+
+    long checksum = lst.capacity;
+    list_dtor(&lst);
+    return checksum;
+}
+
+//! Function compares growth of contiguous and segmented storage
+//! \return checksum
+static long bench_resize() {
+    printf("|-------------------------      Growth             -------------------------|\n");
+
+    long checksum = 0;
+    checksum += bench_resize_mode<AosStorage>      ("resize AosStorage (realloc)");
+    checksum += bench_resize_mode<SegmentedStorage>("resize SegmentedStorage (new chunks)");
+
+    return checksum;
+}
+
+//! Function fills list so that logical order is scattered over physical cells
+//! \param lst  ptr to List object
+//! \param size number of elements
+static void bench_fill_scattered(List<int>* lst, int size) {
+    unsigned seed = 12345;
+    for (int i = 0; i < size; i++) {
+        seed = seed * 1103515245 + 12345;
+
+        if ((seed >> 16) & 1) push_back (lst, i);
+        else                  push_front(lst, i);
+    }
+}
+
+//! Function compares calloc-and-copy sorting function with in-place list_linearize
+//! \return checksum
+static long bench_linearize() {
+    printf("|-------------------------      Linearization      -------------------------|\n");
+
+    List<int> copied  = { };
+    List<int> inplace = { };
+    list_ctor(&copied,  BENCH_LIST_SIZE + 1);
+    list_ctor(&inplace, BENCH_LIST_SIZE + 1);
+
+    bench_fill_scattered(&copied,  BENCH_LIST_SIZE);
+    bench_fill_scattered(&inplace, BENCH_LIST_SIZE);
+
+    double start = bench_now();
+    please_dont_use_sorted_by_next_values_func_because_it_too_slow__also_do_you_really_need_it__i_think_no__so_dont_do_stupid_things_and_better_look_at_memes_about_cats(&copied);
+    bench_report("calloc-and-copy sort", bench_now() - start, BENCH_LIST_SIZE);
+    printf("    %-40s %10zu bytes\n", "extra memory", (size_t)copied.capacity * sizeof(ListElement<int>));
+
+    start = bench_now();
+    list_linearize(&inplace);
+    bench_report("list_linearize (in place)", bench_now() - start, BENCH_LIST_SIZE);
+    printf("    %-40s %10d bytes\n", "extra memory", 0);
+
+    long checksum = 0;
+    for (int i = 1; i <= BENCH_LIST_SIZE; i++) {
+        if (copied.data.value(i) != inplace.data.value(i)) {
+            printf("    results differ at cell %d\n", i);
+            break;
+        }
+        checksum += inplace.data.value(i);
+    }
+
+    list_dtor(&copied);
+    list_dtor(&inplace);
+    return checksum;
+}
+
+//! Function measures scan-by-index pattern (get(i), get(i + 1), ...) on list with scattered cells
+//! \return checksum
+static long bench_indexed_scan() {
+    printf("|-------------------------      Indexed scan       -------------------------|\n");
+
+    List<int> lst = { };
+    list_ctor(&lst, BENCH_LIST_SIZE + 1);
+    bench_fill_scattered(&lst, BENCH_LIST_SIZE);
+
+    long checksum = 0;
+
+    double start = bench_now();
+    for (int i = 0; i < BENCH_LIST_SIZE; i++) {
+        checksum += get(&lst, i);
+    }
+    bench_report("forward get(i) scan", bench_now() - start, BENCH_LIST_SIZE);
+
+    start = bench_now();
+    for (int i = BENCH_LIST_SIZE - 1; i >= 0; i--) {
+        checksum += get(&lst, i);
+    }
+    bench_report("backward get(i) scan", bench_now() - start, BENCH_LIST_SIZE);
+
+    list_dtor(&lst);
+    return checksum;
+}
+
+//! Function compares per-element push_back/pop_front with bulk push_back_n/pop_front_n
+//! \return checksum
+static long bench_bulk() {
+    printf("|-------------------------      Bulk push/pop      -------------------------|\n");
+
+    int* values = (int*) calloc(BENCH_LIST_SIZE, sizeof(int));
+    for (int i = 0; i < BENCH_LIST_SIZE; i++) {
+        values[i] = i;
+    }
+
+    List<int> single = { };
+    List<int> bulk   = { };
+    list_ctor(&single);
+    list_ctor(&bulk);
+
+    double start = bench_now();
+    for (int i = 0; i < BENCH_LIST_SIZE; i++) {
+        push_back(&single, values[i]);
+    }
+    bench_report("push_back loop (with resizes)", bench_now() - start, BENCH_LIST_SIZE);
+
+    start = bench_now();
+    push_back_n(&bulk, values, BENCH_LIST_SIZE);
+    bench_report("push_back_n", bench_now() - start, BENCH_LIST_SIZE);
+    printf("    %-40s %10s\n", "push_back_n keeps list sorted", bulk.is_sorted ? "yes" : "no");
+
+    long checksum = 0;
+
+    start = bench_now();
+    for (int i = 0; i < BENCH_LIST_SIZE; i++) {
+        checksum += pop_front(&single);
+    }
+    bench_report("pop_front loop", bench_now() - start, BENCH_LIST_SIZE);
+
+    start = bench_now();
+    pop_front_n(&bulk, values, BENCH_LIST_SIZE);
+    bench_report("pop_front_n", bench_now() - start, BENCH_LIST_SIZE);
+
+    for (int i = 0; i < BENCH_LIST_SIZE; i++) {
+        checksum += values[i];
+    }
+
+    list_dtor(&single);
+    list_dtor(&bulk);
+    free(values);
+    return checksum;
+}
+
+//! Function runs random pop_index/push_index churn on half-empty list and measures traversal after it
+//! \param name     name of allocation mode
+//! \param free_map 1 if free map should be used, else 0
+//! \return         checksum
+static long bench_churn_mode(const char* name, int free_map) {
+    const int size = BENCH_LIST_SIZE / 4;
+
+    List<int> lst = { };
+    list_ctor(&lst, size * 2 + 1);
+    if (free_map) list_free_map_enable(&lst);
+
+    for (int i = 0; i < size * 2; i++) {
+        push_back(&lst, i);
+    }
+
+    // Popping every second element, so free cells are spread over whole list
+    for (int cell = lst.head; cell != 0; ) {
+        int next = lst.data.next(cell);
+        pop_index(&lst, cell);
+
+        cell = next == 0 ? 0 : lst.data.next(next);
+    }
+
+    unsigned seed = 12345;
+    for (int i = 0; i < size * 2; i++) {
+        int cell = 0;
+        do {
+            seed = seed * 1103515245 + 12345;
+            cell = 1 + (int)((seed >> 8) % (unsigned)(lst.capacity - 1));
+        } while (list_cell_is_free(&lst, cell));
+
+        if (i % 2 == 0) pop_index (&lst, cell);
+        else            push_index(&lst, i, cell);
+    }
+
+    long checksum = 0;
+
+    double start = bench_now();
+    for (int r = 0; r < BENCH_REPEATS; r++) {
+        for (int i = lst.head; i != 0; i = lst.data.next(i)) {
+            checksum += lst.data.value(i);
+        }
+    }
+    printf("%s:\n", name);
+    bench_report("next walk with values after churn", bench_now() - start, (double)size * BENCH_REPEATS);
+    printf("    %-40s %10.3f\n", "locality", list_locality(&lst));
+
+    list_dtor(&lst);
+    return checksum;
+}
+
+//! Function compares LIFO free cells chain with locality-preserving free map
+//! \return checksum
+static long bench_churn() {
+    printf("|-------------------------      Free cells         -------------------------|\n");
+
+    long checksum = 0;
+    checksum += bench_churn_mode("LIFO free cells chain", 0);
+    checksum += bench_churn_mode("Free map (nearest cell)", 1);
+
+    return checksum;
+}
+
+//! Function measures push_back, get and pop_front for one validation level
+//! \param name name of validation level
+//! \return     checksum
+template <typename Validation>
+static long bench_validation_level(const char* name) {
+    const int size = BENCH_LIST_SIZE / 16;
+    printf("%s:\n", name);
+
+    List<int, AosStorage, Validation> lst = { };
+    list_ctor(&lst, size + 1);
+
+    double start = bench_now();
+    for (int i = 0; i < size; i++) {
+        push_back(&lst, i);
+    }
+    bench_report("push_back", bench_now() - start, size);
+
+    long checksum = 0;
+    list_linearize(&lst);   // push_back after empty list leaves sorted prefix empty
+
+    start = bench_now();
+    for (int i = 0; i < size; i++) {
+        checksum += get(&lst, i);
+    }
+    bench_report("get (sorted list)", bench_now() - start, size);
+
+    start = bench_now();
+    for (int i = 0; i < size; i++) {
+        checksum += pop_front(&lst);
+    }
+    bench_report("pop_front", bench_now() - start, size);
+
+    list_dtor(&lst);
+    return checksum;
+}
+
+//! Function compares validation levels of List. Levels from MEDIUM_VALIDATE add only dumps
+//! in ctor/dtor and on errors, so their cost per operation is the same as WEAK_VALIDATE
+//! \return checksum
+static long bench_validation() {
+    printf("|-------------------------      Validation         -------------------------|\n");
+
+    long checksum = 0;
+    checksum += bench_validation_level<UncheckedValidation>          ("UncheckedValidation");
+    checksum += bench_validation_level<ListValidation<NO_VALIDATE>>  ("ListValidation<NO_VALIDATE>");
+    checksum += bench_validation_level<ListValidation<WEAK_VALIDATE>>("ListValidation<WEAK_VALIDATE>");
+
+    return checksum;
+}
+
+//! Thread function: VALID_PTR on own heap ptr
+//! \param arg ptr to long: number of checks on input, checksum on output
+//! \return    NULL
+static void* bench_ptr_check_worker(void* arg) {
+    long* result   = (long*)arg;
+    long  checks   = *result;
+    int*  heap_ptr = (int*) calloc(1, sizeof(int));
+
+    *result = 0;
+    for (long i = 0; i < checks; i++) {
+        *result += VALID_PTR(heap_ptr);
+    }
+
+    free(heap_ptr);
+    return NULL;
+}
+
+//! Function measures VALID_PTR (isbadreadptr) with backend chosen by PTR_CHECK
+//! \return checksum
+static long bench_ptr_check() {
+    printf("|-------------------------      Pointer checks     -------------------------|\n");
+    printf("%s:\n", PTR_CHECK == PTR_CHECK_MAPS ? "PTR_CHECK_MAPS (cached /proc/self/maps)" : "PTR_CHECK_PROBE (write to /dev/random)");
+
+    const int checks = BENCH_LIST_SIZE / 4;
+
+    int* heap_ptr  = (int*) calloc(1, sizeof(int));
+    int  stack_var = 0;
+    long checksum  = 0;
+
+    double start = bench_now();
+    for (int i = 0; i < checks; i++) {
+        checksum += VALID_PTR(heap_ptr);
+    }
+    bench_report("VALID_PTR(heap ptr)", bench_now() - start, checks);
+
+    start = bench_now();
+    for (int i = 0; i < checks; i++) {
+        checksum += VALID_PTR(&stack_var);
+    }
+    bench_report("VALID_PTR(stack ptr)", bench_now() - start, checks);
+
+    start = bench_now();
+    for (int i = 0; i < checks; i++) {
+        checksum += VALID_PTR(NULL);
+    }
+    bench_report("VALID_PTR(NULL)", bench_now() - start, checks);
+
+    const void* bad_ptr = (const void*)0x10000;   // Low pages aren`t mapped
+    start = bench_now();
+    for (int i = 0; i < checks / 16; i++) {
+        checksum += VALID_PTR(bad_ptr);
+    }
+    bench_report("VALID_PTR(unmapped ptr, repeated)", bench_now() - start, checks / 16);
+
+    for (int n_threads = 1; n_threads <= BENCH_MAX_THREADS; n_threads *= 2) {
+        pthread_t threads[BENCH_MAX_THREADS] = { };
+        long      results[BENCH_MAX_THREADS] = { };
+
+        start = bench_now();
+        for (int i = 0; i < n_threads; i++) {
+            results[i] = checks;
+            pthread_create(&threads[i], NULL, bench_ptr_check_worker, &results[i]);
+        }
+        for (int i = 0; i < n_threads; i++) pthread_join(threads[i], NULL);
+
+        char row_name[64] = "";
+        snprintf(row_name, sizeof(row_name), "VALID_PTR(heap ptr), %d threads (per op)", n_threads);
+        bench_report(row_name, bench_now() - start, (double)checks * n_threads);
+
+        for (int i = 0; i < n_threads; i++) checksum += results[i];
+    }
+
+    free(heap_ptr);
+    return checksum;
+}
+
+//! Function compares synchronous log writes (open, write and close file for each event) with asynchronous log
+//! \return checksum
+static long bench_logging() {
+    printf("|-------------------------      Logging            -------------------------|\n");
+
+    const int events = BENCH_LIST_SIZE / 16;
+
+    double start = bench_now();
+    for (int i = 0; i < events; i++) {
+        FILE* log = open_file("log.txt", "a");
+        fprintf(log, "bench event %d\n", i);
+        fclose(log);
+    }
+    bench_report("fopen/fprintf/fclose per event", bench_now() - start, events);
+
+    unsigned long dropped = async_log_dropped();
+
+    start = bench_now();
+    for (int i = 0; i < events; i++) {
+        async_log_printf(ASYNC_LOG_TXT, "bench event %d\n", i);
+    }
+    bench_report("async_log_printf", bench_now() - start, events);
+
+    async_log_flush();
+    bench_report("async_log_printf + flush", bench_now() - start, events);
+    printf("    %-40s %10lu\n", "dropped records", async_log_dropped() - dropped);
+
+    return events;
+}
+
+//! Function gets peak resident memory of process
+//! \return peak memory in KB
+static long bench_peak_memory() {
+    struct rusage usage = {};
+    getrusage(RUSAGE_SELF, &usage);
+
+    return usage.ru_maxrss;
+}
+
+//! Function measures list_dump throughput and memory, which dump takes beyond list itself
+//! \return checksum
+static long bench_dump() {
+    printf("|-------------------------      Dump               -------------------------|\n");
+
+    const int dumps = 4;
+
+    List<int> lst = { };
+    list_ctor(&lst, BENCH_LIST_SIZE + 1);
+    bench_fill_scattered(&lst, BENCH_LIST_SIZE / 2);
+
+    FILE* null_file = tmpfile();
+    long  memory    = bench_peak_memory();
+
+    double start = bench_now();
+    for (int r = 0; r < dumps; r++) {
+        list_dump(&lst, "bench dump", null_file);
+    }
+    double seconds = bench_now() - start;
+    bench_report("list_dump (per cell)", seconds, (double)lst.capacity * dumps);
+
+    printf("    %-40s %10.1f MB/s\n", "list_dump throughput", (double)ftell(null_file) / seconds / (1 << 20));
+    printf("    %-40s %10ld KB\n",    "peak memory growth while dumping", bench_peak_memory() - memory);
+
+    const int windows = 1000;
+
+    start = bench_now();
+    for (int r = 0; r < windows; r++) {
+        list_dump_window(&lst, "bench dump window", BENCH_LIST_SIZE / 4, BENCH_LIST_SIZE / 4 + 64, null_file);
+    }
+    bench_report("list_dump_window (64 cells, per dump)", bench_now() - start, windows);
+
+    fclose(null_file);
+
+    long checksum = lst.size;
+    list_dtor(&lst);
+    return checksum;
+}
+
+//! Function compares rebuilding list by push_back with loading it from snapshot
+//! \return checksum
+static long bench_snapshot() {
+    printf("|-------------------------      Snapshot           -------------------------|\n");
+
+    const char* filename = "bench_list.snapshot";
+    const int   size     = BENCH_LIST_SIZE * 4;
+
+    List<int> lst = { };
+    list_ctor(&lst, size + 1);
+
+    double start = bench_now();
+    for (int i = 0; i < size; i++) {
+        push_back(&lst, i);
+    }
+    bench_report("rebuild by push_back", bench_now() - start, 1);
+
+    start = bench_now();
+    list_save(&lst, filename);
+    bench_report("list_save", bench_now() - start, 1);
+
+    const int   modes[]      = { LIST_LOAD_COPY, LIST_LOAD_PRIVATE, LIST_LOAD_READONLY };
+    const char* mode_names[] = { "list_load (copy)", "list_load (mmap copy-on-write)", "list_load (mmap read-only)" };
+
+    long checksum = 0;
+    for (int m = 0; m < 3; m++) {
+        List<int> loaded = { };
+
+        start = bench_now();
+        list_load(&loaded, filename, modes[m]);
+        bench_report(mode_names[m], bench_now() - start, 1);
+
+        checksum += get(&loaded, size / 2);
+        list_dtor(&loaded);
+    }
+
+    unlink(filename);
+    list_dtor(&lst);
+    return checksum;
+}
+
+//! Function writes text file with lines of random length for text benchmarks
+//! \param filename ptr to path of file
+//! \param lines    number of lines
+static void bench_write_text(const char* filename, int lines) {
+    FILE* file = open_file(filename, "w");
+
+    unsigned seed = 12345;
+    for (int i = 0; i < lines; i++) {
+        seed = seed * 1103515245 + 12345;
+
+        int spaces = (seed >> 16) % 3;
+        fprintf(file, "%*s%d%*s\n", spaces, "", (int)(seed >> 8) % 1000000, spaces, "");
+    }
+
+    fclose(file);
+}
+
+//! Function compares loading of big text file by reading it to memory, by mapping it and by window stream
+//! \return checksum
+static long bench_text_loading() {
+    printf("|-------------------------      Text loading       -------------------------|\n");
+
+    const char* filename = "bench_text.txt";
+    const int   lines    = BENCH_LIST_SIZE * 16;
+    bench_write_text(filename, lines);
+
+    long checksum = 0;
+
+    double start = bench_now();
+    Text text = get_text_from_file(filename, 1, 1);
+    bench_report("get_text_from_file (per line)", bench_now() - start, lines);
+
+    checksum += (long)text.lines;
+    free(text.data);
+    free(text.text);
+
+    start = bench_now();
+    text = get_text_from_file_mapped(filename, 1, 1);
+    bench_report("get_text_from_file_mapped (per line)", bench_now() - start, lines);
+
+    checksum += (long)text.lines;
+    free_text(&text);
+
+    start = bench_now();
+    text = get_text_from_file(filename, 1, 1, TEXT_THREADS_AUTO);
+    bench_report("get_text_from_file (all CPUs, per line)", bench_now() - start, lines);
+
+    checksum += (long)text.lines;
+    free(text.data);
+    free(text.text);
+
+    start = bench_now();
+    text = get_text_from_file_mapped(filename, 1, 1, TEXT_THREADS_AUTO);
+    bench_report("get_text_from_file_mapped (all CPUs)", bench_now() - start, lines);
+
+    checksum += (long)text.lines;
+    free_text(&text);
+
+    start = bench_now();
+    TextStream stream = {};
+    text_stream_open(&stream, filename, 1, 1);
+    while (text_stream_next(&stream)) {
+        checksum += (long)stream.text.lines;
+    }
+    text_stream_close(&stream);
+    bench_report("text_stream_next (per line)", bench_now() - start, lines);
+
+    unlink(filename);
+    return checksum;
+}
+
+//! Function compares parsing of numeric file line by line and list_from_file
+//! \return checksum
+static long bench_ingest() {
+    printf("|-------------------------         Ingest          -------------------------|\n");
+
+    const char* filename = "bench_text.txt";
+    const int   lines    = BENCH_LIST_SIZE * 16;
+    bench_write_text(filename, lines);
+
+    long checksum = 0;
+
+    double start = bench_now();
+    Text text = get_text_from_file(filename, 1, 1);
+
+    List<int> lst = { };
+    list_ctor(&lst, (int)text.lines + 1);
+    for (size_t i = 0; i < text.lines; i++) {
+        push_back(&lst, atoi(text.text[i].ptr));
+    }
+    bench_report("get_text_from_file + push_back(atoi)", bench_now() - start, lines);
+
+    checksum += lst.size + lst.data.value(lst.tail);
+    list_dtor(&lst);
+    free(text.data);
+    free(text.text);
+
+    const char* kernels[] = { "list_from_file (scalar)", "list_from_file (sse2)", "list_from_file (avx2)" };
+    for (int kernel = TEXT_SCAN_SCALAR; kernel <= TEXT_SCAN_AVX2; kernel++) {
+        if (text_scan_use(kernel) != kernel) continue;
+
+        start = bench_now();
+        list_from_file(&lst, filename);
+        bench_report(kernels[kernel], bench_now() - start, lines);
+
+        checksum += lst.size + lst.data.value(lst.tail);
+        list_dtor(&lst);
+    }
+    text_scan_use(TEXT_SCAN_AUTO);
+
+    start = bench_now();
+    list_from_file(&lst, filename, TEXT_THREADS_AUTO);
+    bench_report("list_from_file (all CPUs)", bench_now() - start, lines);
+
+    checksum += lst.size + lst.data.value(lst.tail);
+    list_dtor(&lst);
+
+    unlink(filename);
+    return checksum;
+}
+
+//! Work of one thread in concurrent benchmark: thread pushes and pops after its own element
+struct BenchWorker {
+    void*            list;
+    pthread_mutex_t* mutex;     // Lock of whole list (only for List)
+    int              anchor;
+    long             checksum;
+};
+
+//! Thread function: push_index/pop_index pairs on List under one mutex
+//! \param arg ptr to BenchWorker object
+//! \return    NULL
+static void* bench_locked_worker(void* arg) {
+    BenchWorker* worker = (BenchWorker*)arg;
+    List<int>*   lst    = (List<int>*)worker->list;
+
+    for (int i = 0; i < BENCH_THREAD_OPS; i++) {
+        pthread_mutex_lock(worker->mutex);
+        int cell = push_index(lst, i, worker->anchor);
+        pthread_mutex_unlock(worker->mutex);
+
+        pthread_mutex_lock(worker->mutex);
+        worker->checksum += pop_index(lst, cell);
+        pthread_mutex_unlock(worker->mutex);
+    }
+
+    return NULL;
+}
+
+//! Thread function: push_index/pop_index pairs on ConcurrentList
+//! \param arg ptr to BenchWorker object
+//! \return    NULL
+static void* bench_concurrent_worker(void* arg) {
+    BenchWorker*         worker = (BenchWorker*)arg;
+    ConcurrentList<int>* lst    = (ConcurrentList<int>*)worker->list;
+
+    for (int i = 0; i < BENCH_THREAD_OPS; i++) {
+        int cell = push_index(lst, i, worker->anchor);
+        worker->checksum += pop_index(lst, cell);
+    }
+
+    return NULL;
+}
+
+//! Function runs workers in threads and reports throughput
+//! \param name      name of measured case
+//! \param workers   ptr to array of workers
+//! \param n_threads number of threads
+//! \param func      thread function
+//! \param ops       number of operations of one thread
+//! \return          checksum
+static long bench_run_workers(const char* name, BenchWorker* workers, int n_threads, void* (*func)(void*), double ops) {
+    pthread_t threads[BENCH_MAX_THREADS] = { };
+
+    double start = bench_now();
+    for (int i = 0; i < n_threads; i++) pthread_create(&threads[i], NULL, func, &workers[i]);
+    for (int i = 0; i < n_threads; i++) pthread_join(threads[i], NULL);
+
+    char row_name[64] = "";
+    snprintf(row_name, sizeof(row_name), "%s, %d threads (per op)", name, n_threads);
+    bench_report(row_name, bench_now() - start, ops * n_threads);
+
+    long checksum = 0;
+    for (int i = 0; i < n_threads; i++) checksum += workers[i].checksum;
+    return checksum;
+}
+
+//! Function compares List under one mutex and ConcurrentList: threads push and pop at distinct places
+//! \return checksum
+static long bench_concurrent() {
+    printf("|-------------------------   Concurrent push/pop   -------------------------|\n");
+
+    long checksum = 0;
+    for (int n_threads = 1; n_threads <= BENCH_MAX_THREADS; n_threads *= 2) {
+        BenchWorker workers[BENCH_MAX_THREADS] = { };
+
+        // Each thread has anchor and spacer, so neighbourhoods of threads don`t cross
+        pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+        List<int> locked = { };
+        list_ctor(&locked, 4 * BENCH_MAX_THREADS);
+        for (int i = 0; i < n_threads; i++) {
+            workers[i] = { &locked, &mutex, push_back(&locked, -i), 0 };
+            push_back(&locked, 0);
+        }
+        checksum += bench_run_workers("List + mutex", workers, n_threads, bench_locked_worker, 2.0 * BENCH_THREAD_OPS);
+        list_dtor(&locked);
+
+        ConcurrentList<int> concurrent = { };
+        list_ctor(&concurrent, 4 * BENCH_MAX_THREADS);
+        for (int i = 0; i < n_threads; i++) {
+            workers[i] = { &concurrent, NULL, push_back(&concurrent, -i), 0 };
+            push_back(&concurrent, 0);
+        }
+        checksum += bench_run_workers("ConcurrentList", workers, n_threads, bench_concurrent_worker, 2.0 * BENCH_THREAD_OPS);
+        list_dtor(&concurrent);
+    }
+
+    return checksum;
+}
+
+//! Thread function: push_back to List under one mutex
+//! \param arg ptr to BenchWorker object
+//! \return    NULL
+static void* bench_locked_appender(void* arg) {
+    BenchWorker* worker = (BenchWorker*)arg;
+    List<int>*   lst    = (List<int>*)worker->list;
+
+    for (int i = 0; i < BENCH_THREAD_OPS; i++) {
+        pthread_mutex_lock(worker->mutex);
+        push_back(lst, i);
+        pthread_mutex_unlock(worker->mutex);
+    }
+
+    return NULL;
+}
+
+//! Thread function: push_back to ShardedList
+//! \param arg ptr to BenchWorker object
+//! \return    NULL
+static void* bench_sharded_appender(void* arg) {
+    BenchWorker*      worker = (BenchWorker*)arg;
+    ShardedList<int>* lst    = (ShardedList<int>*)worker->list;
+
+    for (int i = 0; i < BENCH_THREAD_OPS; i++) {
+        sharded_push_back(lst, i, worker->anchor);
+    }
+
+    return NULL;
+}
+
+//! Thread function: push_back to own checked List (as shard was before unchecked shard lists)
+//! \param arg ptr to BenchWorker object
+//! \return    NULL
+static void* bench_own_appender(void* arg) {
+    BenchWorker* worker = (BenchWorker*)arg;
+    List<int>*   lst    = (List<int>*)worker->list;
+
+    for (int i = 0; i < BENCH_THREAD_OPS; i++) {
+        push_back(lst, i);
+    }
+
+    return NULL;
+}
+
+//! Function compares appends to List under one mutex, to checked List per thread and to ShardedList
+//! (thread per shard)
+//! \return checksum
+static long bench_sharded() {
+    printf("|-------------------------     Sharded append      -------------------------|\n");
+
+    long checksum = 0;
+    for (int n_threads = 1; n_threads <= BENCH_MAX_THREADS; n_threads *= 2) {
+        BenchWorker workers[BENCH_MAX_THREADS] = { };
+
+        pthread_mutex_t mutex  = PTHREAD_MUTEX_INITIALIZER;
+        List<int>       locked = { };
+        list_ctor(&locked, BENCH_THREAD_OPS * n_threads + 1);
+        for (int i = 0; i < n_threads; i++) workers[i] = { &locked, &mutex, 0, 0 };
+
+        checksum += bench_run_workers("List + mutex", workers, n_threads, bench_locked_appender, BENCH_THREAD_OPS);
+        checksum += locked.size;
+        list_dtor(&locked);
+
+        List<int> own[BENCH_MAX_THREADS] = { };
+        for (int i = 0; i < n_threads; i++) {
+            list_ctor(&own[i], BENCH_THREAD_OPS + 1);
+            workers[i] = { &own[i], NULL, 0, 0 };
+        }
+
+        checksum += bench_run_workers("Checked List/thread", workers, n_threads, bench_own_appender, BENCH_THREAD_OPS);
+        for (int i = 0; i < n_threads; i++) {
+            checksum += own[i].size;
+            list_dtor(&own[i]);
+        }
+
+        ShardedList<int> sharded = { };
+        list_ctor(&sharded, BENCH_THREAD_OPS + 1, n_threads);
+        for (int i = 0; i < n_threads; i++) workers[i] = { &sharded, NULL, i, 0 };
+
+        checksum += bench_run_workers("ShardedList", workers, n_threads, bench_sharded_appender, BENCH_THREAD_OPS);
+
+        if (n_threads == BENCH_MAX_THREADS) {
+            List<int> merged = { };
+
+            double start = bench_now();
+            merge_shards(&sharded, &merged);
+            bench_report("merge_shards", bench_now() - start, merged.size);
+
+            checksum += get(&merged, merged.size - 1) + get(&sharded, merged.size / 2);
+            list_dtor(&merged);
+        }
+        list_dtor(&sharded);
+    }
+
+    return checksum;
+}
+
+//! Function measures copy-on-write snapshot: take, walk by reader, writes of list after it
+//! \return checksum
+static long bench_cow() {
+    printf("|-------------------------  Copy-on-write snapshot  -------------------------|\n");
+
+    const int size = BENCH_LIST_SIZE * 4;
+
+    List<int, CowStorage> lst = { };
+    list_ctor(&lst, size + 1);
+
+    for (int i = 0; i < size; i++) {
+        lst.data.set(i + 1, i, i + 2, i);   // Filling directly: push_back is too slow for this size
+    }
+    lst.data.set(0, 0, 1, size);
+    lst.data.next(size) = 0;
+    lst.head = 1;
+    lst.tail = lst.size = size;
+    lst.first_free = 0;
+
+    ListElement<int>* copy = (ListElement<int>*) calloc(size + 1, sizeof(ListElement<int>));
+    double start = bench_now();
+    for (int i = 0; i <= size; i++) {
+        copy[i] = lst.data.cell(i);
+    }
+    bench_report("full copy of cells (without snapshot)", bench_now() - start, size);
+
+    ListSnapshot<int> snap = { };
+    start = bench_now();
+    snapshot_take(&lst, &snap);
+    bench_report("snapshot_take (per element)", bench_now() - start, size);
+
+    long checksum = copy[size / 2].value;
+    free(copy);
+
+    start = bench_now();
+    for (int i = snap.head; i != 0; i = snap.next(i)) {
+        checksum += snap.value(i);
+    }
+    bench_report("snapshot walk with values", bench_now() - start, size);
+
+    // Each pass touches every chunk: first pass copies them, second one writes in place
+    const int step = CowStorage<int>::CHUNK_SIZE;
+    for (int pass = 0; pass < 2; pass++) {
+        start = bench_now();
+        for (int i = 1; i < size; i += step) {
+            lst.data.value(i) += 1;
+        }
+        bench_report(pass == 0 ? "first write to chunk (copy)" : "next write to chunk", bench_now() - start, size / step);
+    }
+
+    checksum += get(&snap, size - 1) + lst.data.value(1);
+    snapshot_release(&snap);
+    list_dtor(&lst);
+    return checksum;
+}
+
+//! Function measures journal: push_back with group commits and recovery by batched replay
+//! \return checksum
+static long bench_journal() {
+    printf("|-------------------------         Journal          -------------------------|\n");
+
+    const char* image_name   = "bench_journal.list";
+    const char* journal_name = "bench_journal.log";
+    const int   size         = BENCH_LIST_SIZE;
+    const int   commit_ops   = 1 << 10;      // Operations in one group commit
+
+    const int   modes[]      = { -1, JOURNAL_SYNC_NONE, JOURNAL_SYNC_COMMIT };
+    const char* mode_names[] = { "push_back (no journal)", "push_back (journal, commit to OS)", "push_back (journal, fdatasync per commit)" };
+
+    long checksum = 0;
+    for (int m = 0; m < 3; m++) {
+        List<int> lst = { };
+        list_ctor(&lst, size + 1);
+        if (modes[m] >= 0) list_journal_open(&lst, image_name, journal_name, modes[m]);
+
+        double start = bench_now();
+        for (int i = 0; i < size; i++) {
+            push_back(&lst, i);
+
+            if (modes[m] >= 0 && (i + 1) % commit_ops == 0) list_journal_commit(&lst);
+        }
+        if (modes[m] >= 0) list_journal_commit(&lst);
+        bench_report(mode_names[m], bench_now() - start, size);
+
+        checksum += get(&lst, size - 1);
+        list_dtor(&lst);
+    }
+
+    // Journal of last case has all pushes after empty snapshot file
+    List<int> recovered = { };
+    double start = bench_now();
+    list_load(&recovered, image_name, LIST_LOAD_COPY);
+    list_journal_replay(&recovered, journal_name);
+    bench_report("list_load + journal replay (per record)", bench_now() - start, size);
+
+    checksum += recovered.size + get(&recovered, size / 2);
+    list_dtor(&recovered);
+
+    unlink(image_name);
+    unlink(journal_name);
+    return checksum;
+}
+
+//! Producer of queue benchmark
+struct BenchProducer {
+    void*            queue;
+    pthread_mutex_t* mutex;     // Lock of whole list (only for List)
+};
+
+//! Thread function: push_back to List under one mutex
+//! \param arg ptr to BenchProducer object
+//! \return    NULL
+static void* bench_locked_producer(void* arg) {
+    BenchProducer* producer = (BenchProducer*)arg;
+    List<int>*     lst      = (List<int>*)producer->queue;
+
+    for (int i = 0; i < BENCH_THREAD_OPS; i++) {
+        pthread_mutex_lock(producer->mutex);
+        push_back(lst, i);
+        pthread_mutex_unlock(producer->mutex);
+    }
+
+    return NULL;
+}
+
+//! Thread function: push_back to ListQueue (waits, while queue is full)
+//! \param arg ptr to BenchProducer object
+//! \return    NULL
+static void* bench_queue_producer(void* arg) {
+    BenchProducer*  producer = (BenchProducer*)arg;
+    ListQueue<int>* queue    = (ListQueue<int>*)producer->queue;
+
+    for (int i = 0; i < BENCH_THREAD_OPS; i++) {
+        while (push_back(queue, i) < 0) sched_yield();
+    }
+
+    return NULL;
+}
+
+//! Function runs producers in threads, pops all values by current thread and reports throughput
+//! \param name        name of measured case
+//! \param producer    ptr to producer object (it is shared by all producer threads)
+//! \param n_producers number of producer threads
+//! \param func        thread function
+//! \return            checksum
+static long bench_run_queue(const char* name, BenchProducer* producer, int n_producers, void* (*func)(void*)) {
+    pthread_t threads[BENCH_MAX_THREADS] = { };
+    long checksum = 0;
+    long items    = (long)BENCH_THREAD_OPS * n_producers;
+
+    double start = bench_now();
+    for (int i = 0; i < n_producers; i++) pthread_create(&threads[i], NULL, func, producer);
+
+    for (long popped = 0; popped < items; ) {
+        int value = -1;
+        if (producer->mutex != NULL) {
+            List<int>* lst = (List<int>*)producer->queue;
+
+            pthread_mutex_lock(producer->mutex);
+            if (lst->size > 0) value = pop_front(lst);
+            pthread_mutex_unlock(producer->mutex);
+        } else {
+            value = pop_front((ListQueue<int>*)producer->queue);
+        }
+
+        if (value < 0) {
+            sched_yield();
+            continue;
+        }
+        checksum += value;
+        popped++;
+    }
+
+    for (int i = 0; i < n_producers; i++) pthread_join(threads[i], NULL);
+
+    char row_name[64] = "";
+    snprintf(row_name, sizeof(row_name), "%s, %d producers (per item)", name, n_producers);
+    bench_report(row_name, bench_now() - start, (double)items);
+
+    return checksum;
+}
+
+//! Function compares List under one mutex and ListQueue as work queue: producers push_back, main thread pop_front
+//! \return checksum
+static long bench_queue() {
+    printf("|-------------------------     Work queue          -------------------------|\n");
+
+    long checksum = 0;
+    for (int n_producers = 1; n_producers < BENCH_MAX_THREADS; n_producers *= 2) {
+        pthread_mutex_t mutex  = PTHREAD_MUTEX_INITIALIZER;
+        List<int>       locked = { };
+        list_ctor(&locked, BENCH_THREAD_OPS * n_producers + 1);
+
+        BenchProducer producer = { &locked, &mutex };
+        checksum += bench_run_queue("List + mutex", &producer, n_producers, bench_locked_producer);
+        list_dtor(&locked);
+
+        ListQueue<int> queue = { };
+        if (n_producers == 1) {
+            list_ctor(&queue, BENCH_QUEUE_SIZE, QUEUE_SPSC);
+
+            producer = { &queue, NULL };
+            checksum += bench_run_queue("ListQueue SPSC", &producer, n_producers, bench_queue_producer);
+            list_dtor(&queue);
+        }
+
+        list_ctor(&queue, BENCH_QUEUE_SIZE, QUEUE_MPSC);
+
+        producer = { &queue, NULL };
+        checksum += bench_run_queue("ListQueue MPSC", &producer, n_producers, bench_queue_producer);
+        list_dtor(&queue);
+    }
+
+    return checksum;
+}
+
+//! Function prints one row of throughput table
+//! \param name    name of measured case
+//! \param seconds measured time
+//! \param bytes   number of processed bytes
+static void bench_report_bandwidth(const char* name, double seconds, double bytes) {
+    printf("    %-40s %10.3f ms %10.2f GB/s\n", name, seconds * 1e3, bytes / seconds / (1 << 30));
+}
+
+//! Function compares scalar and SIMD text scanning kernels on big text in memory
+//! \return checksum
+static long bench_text_scan() {
+    printf("|-------------------------      Text scanning      -------------------------|\n");
+
+    const char* filename = "bench_text.txt";
+    bench_write_text(filename, BENCH_LIST_SIZE * 16);
+
+    Text   source = get_text_from_file_mapped(filename);
+    size_t size   = source.data_size;
+
+    char*   buffer  = (char*)   calloc(size, sizeof(char));
+    String* strings = (String*) calloc(source.lines, sizeof(String));
+
+    double start = bench_now();
+    memcpy(buffer, source.data, size);
+    bench_report_bandwidth("memcpy (memory bandwidth)", bench_now() - start, (double)size);
+
+    long checksum = 0;
+    const int kernels[] = { TEXT_SCAN_SCALAR, TEXT_SCAN_SSE2, TEXT_SCAN_AVX2 };
+    for (int k = 0; k < 3; k++) {
+        if (text_scan_use(kernels[k]) != kernels[k]) continue;
+        printf("  %s:\n", text_scan_kernel_name());
+
+        memcpy(buffer, source.data, size);
+
+        start = bench_now();
+        checksum += replace(buffer, size, '\n', '\0');
+        bench_report_bandwidth("replace", bench_now() - start, (double)size);
+
+        Text text = { buffer, size, strings, source.lines, 0 };
+
+        start = bench_now();
+        load_string_pointers(&text, 1, 1);
+        bench_report_bandwidth("load_string_pointers (skip spaces)", bench_now() - start, (double)size);
+        checksum += (long)text.lines;
+
+        start = bench_now();
+        checksum += (long)count_lines(source.data, size);
+        bench_report_bandwidth("count_lines", bench_now() - start, (double)size);
+
+        start = bench_now();
+        checksum += (long)index_lines(source.data, size, strings, 1, 1);
+        bench_report_bandwidth("index_lines (skip spaces)", bench_now() - start, (double)size);
+    }
+    text_scan_use(TEXT_SCAN_AUTO);
+
+    free(buffer);
+    free(strings);
+    free_text(&source);
+    unlink(filename);
+
+    return checksum;
+}
+
+//! Function runs all List benchmarks
+//! \return 0
+static int run_benchmarks() {
+    long checksum = 0;
+
+    checksum += bench_storage_modes();
+    checksum += bench_linearize();
+    checksum += bench_indexed_scan();
+    checksum += bench_bulk();
+    checksum += bench_resize();
+    checksum += bench_churn();
+    checksum += bench_validation();
+    checksum += bench_ptr_check();
+    checksum += bench_logging();
+    checksum += bench_dump();
+    checksum += bench_snapshot();
+    checksum += bench_text_loading();
+    checksum += bench_ingest();
+    checksum += bench_text_scan();
+    checksum += bench_concurrent();
+    checksum += bench_queue();
+    checksum += bench_sharded();
+    checksum += bench_cow();
+    checksum += bench_journal();
+
+    printf("checksum: %ld\n", checksum);
+    return 0;
+}
+
+#endif // LIST_BENCHH
@@ -0,0 +1,44 @@
+#ifndef TEST_BASEH
+#define TEST_BASEH
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "../libs/baselib.h"
+
+// Tests-----------------------------------------------------------------------
+// Each test function returns number of failed checks. Failed check prints its condition and place,
+// so test goes on and shows all differences at once.
+
+//! Checks condition and counts failure in failures variable of test
+#define TEST_CHECK(failures, cond) {                                                \
+    if (!(cond)) {                                                                  \
+        printf(RED "    check failed: %s (%s:%d)" NATURAL "\n", #cond, __FILE__, __LINE__); \
+        (failures)++;                                                               \
+    }                                                                               \
+}
+
+//! Function prints result of one test
+//! \param name     name of test
+//! \param failures number of failed checks
+//! \return         failures
+static int test_report(const char* name, int failures) {
+    if (failures == 0) printf(GREEN "[  OK  ]" NATURAL " %s\n", name);
+    else               printf(RED   "[ FAIL ]" NATURAL " %s: %d failed checks\n", name, failures);
+
+    return failures;
+}
+
+//! Function fills buffer with random symbols of set
+//! \param buffer   ptr to buffer
+//! \param size     size of buffer
+//! \param set      ptr to symbols, which are taken (can contain '\0')
+//! \param set_size number of symbols in set (0 means all bytes)
+static void test_random_buffer(char* buffer, size_t size, const char* set, size_t set_size) {
+    for (size_t i = 0; i < size; i++) {
+        buffer[i] = set_size > 0 ? set[rand() % set_size] : (char)(rand() % 256);
+    }
+}
+// ----------------------------------------------------------------------------
+
+#endif // TEST_BASEH
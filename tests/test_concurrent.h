@@ -0,0 +1,239 @@
+#ifndef TEST_CONCURRENTH
+#define TEST_CONCURRENTH
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "test_base.h"
+#include "../list.h"
+
+// ConcurrentList tests--------------------------------------------------------
+// Threads push and pop after own anchors and at both ends at once. Each thread counts values,
+// which it pushed and popped, so after join links must be correct and list must contain exactly
+// pushed and not popped values. make test-tsan runs it under ThreadSanitizer.
+
+const int TEST_CONCURRENT_THREADS  = 6;
+const int TEST_CONCURRENT_OPS      = 1 << 16;
+const int TEST_CONCURRENT_CAPACITY = 1;         // One start chunk, so threads grow list
+const int TEST_CONCURRENT_RECENT   = 16;
+const int TEST_CONCURRENT_TIMEOUT  = 600;       // Seconds for join: broken links make threads spin forever
+
+struct TestConcurrentWorker {
+    ConcurrentList<int>* lst;
+    int                  id;
+    int                  anchor;
+
+    long long            pushed;
+    long long            popped;
+    long long            pushed_sum;
+    long long            popped_sum;
+    int                  push_errors;
+};
+
+//! Function counts popped value of worker (values are >= 0, errors are < 0)
+//! \param worker ptr to TestConcurrentWorker
+//! \param value  popped value
+static void test_concurrent_popped(TestConcurrentWorker* worker, int value) {
+    if (value < 0) return;
+
+    worker->popped++;
+    worker->popped_sum += value;
+}
+
+//! Function counts pushed value of worker
+//! \param worker ptr to TestConcurrentWorker
+//! \param index  index of pushed element (< 0 if error)
+//! \param value  pushed value
+//! \return       index
+static int test_concurrent_pushed(TestConcurrentWorker* worker, int index, int value) {
+    if (index < 0) {
+        if (index != errors::BAD_PH_INDEX) worker->push_errors++;
+        return index;
+    }
+
+    worker->pushed++;
+    worker->pushed_sum += value;
+    return index;
+}
+
+//! Thread function of stress test: mixed pushes and pops by indexes and at ends
+//! \param arg ptr to TestConcurrentWorker
+//! \return    NULL
+static void* test_concurrent_worker(void* arg) {
+    TestConcurrentWorker* worker = (TestConcurrentWorker*) arg;
+    ConcurrentList<int>*  lst    = worker->lst;
+
+    int recent[TEST_CONCURRENT_RECENT] = { };
+    unsigned seed = 2021u + (unsigned)worker->id;
+
+    for (int op = 0; op < TEST_CONCURRENT_OPS; op++) {
+        int value = worker->id * TEST_CONCURRENT_OPS + op + 1;
+        int slot  = op % TEST_CONCURRENT_RECENT;
+        int kind  = rand_r(&seed) % 10;
+
+        if (kind < 2) {
+            // Anchor can be popped from end by other thread: its cell is free or reused then
+            int index = test_concurrent_pushed(worker, push_index(lst, value, worker->anchor), value);
+            if (index < 0) worker->anchor = test_concurrent_pushed(worker, push_back(lst, 0), 0);
+            else           recent[slot]   = index;
+        } else if (kind < 3) {
+            recent[slot] = test_concurrent_pushed(worker, push_index(lst, value, recent[(slot + 1) % TEST_CONCURRENT_RECENT]), value);
+            if (recent[slot] < 0) recent[slot] = 0;
+        } else if (kind < 5) {
+            // Element can be popped by other thread already, so index can be free or reused cell
+            if (recent[slot] > 0) test_concurrent_popped(worker, pop_index(lst, recent[slot]));
+            recent[slot] = 0;
+        } else if (kind < 6) {
+            test_concurrent_pushed(worker, push_back(lst, value), value);
+        } else if (kind < 7) {
+            test_concurrent_pushed(worker, push_front(lst, value), value);
+        } else if (kind < 8 || (kind < 9 && op % 2)) {
+            test_concurrent_popped(worker, pop_back(lst));
+        } else {
+            test_concurrent_popped(worker, pop_front(lst));
+        }
+    }
+
+    return NULL;
+}
+
+//! Function checks list after threads of stress test
+//! \param lst       ptr to ConcurrentList object
+//! \param workers   ptr to workers of threads
+//! \param n_anchors number of anchors, which were pushed before threads
+//! \return          number of failed checks
+static int test_concurrent_check(ConcurrentList<int>* lst, TestConcurrentWorker* workers, int n_anchors) {
+    int failures = 0;
+
+    long long size = n_anchors;
+    long long sum  = 0;
+    for (int i = 0; i < TEST_CONCURRENT_THREADS; i++) {
+        TEST_CHECK(failures, workers[i].push_errors == 0);
+
+        size += workers[i].pushed     - workers[i].popped;
+        sum  += workers[i].pushed_sum - workers[i].popped_sum;
+    }
+
+    TEST_CHECK(failures, list_error(lst) == errors::OK);
+    TEST_CHECK(failures, list_size(lst) == size);
+
+    long long list_sum = 0;
+    int       walked   = 0;
+    for (int cell = concurrent_cell(lst, 0)->next; cell != 0 && walked <= size; cell = concurrent_cell(lst, cell)->next) {
+        list_sum += concurrent_cell(lst, cell)->value;
+        walked++;
+    }
+    TEST_CHECK(failures, walked   == size);
+    TEST_CHECK(failures, list_sum == sum);
+
+    // Draining from both ends must give the same values and empty list
+    long long drained_sum = 0;
+    int       drained     = 0;
+    for (int value = 0; drained <= size; drained++) {
+        value = drained % 2 ? pop_back(lst) : pop_front(lst);
+        if (value < 0) break;
+
+        drained_sum += value;
+    }
+    TEST_CHECK(failures, drained     == size);
+    TEST_CHECK(failures, drained_sum == sum);
+    TEST_CHECK(failures, list_size(lst) == 0);
+    TEST_CHECK(failures, list_error(lst) == errors::OK);
+
+    return failures;
+}
+
+//! Function runs threads of stress test
+//! \return number of failed checks
+static int test_concurrent_stress() {
+    int failures = 0;
+
+    ConcurrentList<int> lst = { };
+    TEST_CHECK(failures, list_ctor(&lst, TEST_CONCURRENT_CAPACITY));
+    if (failures) return failures;
+
+    TestConcurrentWorker workers[TEST_CONCURRENT_THREADS] = { };
+    pthread_t            threads[TEST_CONCURRENT_THREADS] = { };
+
+    for (int i = 0; i < TEST_CONCURRENT_THREADS; i++) {
+        workers[i] = { &lst, i, push_back(&lst, 0), 0, 0, 0, 0, 0 };
+        TEST_CHECK(failures, workers[i].anchor > 0);
+    }
+
+    int started = 0;
+    for (; started < TEST_CONCURRENT_THREADS; started++) {
+        if (pthread_create(&threads[started], NULL, test_concurrent_worker, &workers[started]) != 0) break;
+    }
+    TEST_CHECK(failures, started == TEST_CONCURRENT_THREADS);
+
+    struct timespec deadline = { };
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += TEST_CONCURRENT_TIMEOUT;
+
+    for (int i = 0; i < started; i++) {
+        if (pthread_timedjoin_np(threads[i], NULL, &deadline) != 0) {
+            // Threads still use list, so it can`t be checked and freed
+            test_report("concurrent list: threads stress (threads hang)", 1);
+            exit(1);
+        }
+    }
+
+    if (started == TEST_CONCURRENT_THREADS) {
+        failures += test_concurrent_check(&lst, workers, TEST_CONCURRENT_THREADS);
+    }
+
+    list_dtor(&lst);
+    return failures;
+}
+
+//! Function checks single thread semantics of ConcurrentList
+//! \return number of failed checks
+static int test_concurrent_single() {
+    int failures = 0;
+
+    ConcurrentList<int> lst = { };
+    TEST_CHECK(failures, list_ctor(&lst, 1));
+
+    TEST_CHECK(failures, pop_front(&lst) == errors::LST_EMPTY);
+    TEST_CHECK(failures, pop_back (&lst) == errors::LST_EMPTY);
+
+    int first = push_back(&lst, 1);
+    int last  = push_back(&lst, 3);
+    int mid   = push_index(&lst, 2, first);
+    push_front(&lst, 0);
+
+    TEST_CHECK(failures, list_size(&lst) == 4);
+    TEST_CHECK(failures, list_error(&lst) == errors::OK);
+    TEST_CHECK(failures, concurrent_cell(&lst, first)->next == mid);
+    TEST_CHECK(failures, concurrent_cell(&lst, mid)->next   == last);
+
+    TEST_CHECK(failures, pop_index(&lst, mid) == 2);
+    TEST_CHECK(failures, pop_index(&lst, mid) == errors::BAD_PH_INDEX);     // Cell is free now
+    TEST_CHECK(failures, push_index(&lst, 5, mid) == errors::BAD_PH_INDEX);
+    TEST_CHECK(failures, pop_index(&lst, -1)  == errors::BAD_PH_INDEX);
+
+    TEST_CHECK(failures, pop_front(&lst) == 0);
+    TEST_CHECK(failures, pop_back (&lst) == 3);
+    TEST_CHECK(failures, pop_back (&lst) == 1);
+    TEST_CHECK(failures, list_size(&lst) == 0);
+    TEST_CHECK(failures, list_error(&lst) == errors::OK);
+
+    list_dtor(&lst);
+    return failures;
+}
+
+//! Function runs ConcurrentList tests
+//! \return number of failed checks
+static int test_concurrent() {
+    int failures = 0;
+
+    failures += test_report("concurrent list: single thread", test_concurrent_single());
+    failures += test_report("concurrent list: threads stress", test_concurrent_stress());
+
+    return failures;
+}
+// ----------------------------------------------------------------------------
+
+#endif // TEST_CONCURRENTH
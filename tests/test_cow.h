@@ -0,0 +1,274 @@
+#ifndef TEST_COWH
+#define TEST_COWH
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "test_base.h"
+#include "../list.h"
+
+// Copy-on-write snapshot tests------------------------------------------------
+// Snapshot is taken from list of several chunks. Read functions of list mustn`t copy chunks, and
+// snapshot must keep values and order of moment of snapshot_take after any mutator of list (pushes
+// and pops, bulk functions, compaction, linearize and growth of list). Reader thread walks snapshot,
+// while main thread changes list.
+
+const int TEST_COW_SIZE     = 3 * (1 << LIST_CHUNK_BITS) + 100;   // Elements in several chunks
+const int TEST_COW_CAPACITY = TEST_COW_SIZE + 1;                  // Filling doesn`t grow list
+const int TEST_COW_WALKS    = 64;                                 // Walks of reader thread
+
+struct TestCowReader {
+    ListSnapshot<int>* snap;
+    long long          sum;         // Expected sum of values
+    int                errors;      // Walks with wrong sum or size
+};
+
+//! Function copies values of list in logical order
+//! \param lst    ptr to List object
+//! \param values ptr to array of list_size(lst) values
+static void test_cow_values(List<int, CowStorage>* lst, int* values) {
+    const CowStorage<int>& data = lst->data;
+
+    int i = 0;
+    for (int cell = lst->head; cell != 0 && i < lst->size; cell = data.next(cell)) {
+        values[i++] = data.value(cell);
+    }
+}
+
+//! Function fills list with values 0, 1, ... n - 1
+//! \param lst ptr to List object
+//! \param n   number of values
+//! \return    number of failed checks
+static int test_cow_fill(List<int, CowStorage>* lst, int n) {
+    int failures = 0;
+
+    TEST_CHECK(failures, list_ctor(lst, TEST_COW_CAPACITY));
+    for (int i = 0; i < n; i++) {
+        if (push_back(lst, i) <= 0) failures++;
+    }
+    TEST_CHECK(failures, lst->size == n);
+    TEST_CHECK(failures, list_error(lst) == errors::OK);
+
+    return failures;
+}
+
+//! Function checks, that snapshot has expected values (by walk and by get)
+//! \param snap     ptr to ListSnapshot object
+//! \param expected ptr to expected values
+//! \param size     number of expected values
+//! \return         number of failed checks
+static int test_cow_check_snapshot(ListSnapshot<int>* snap, const int* expected, int size) {
+    int failures = 0;
+
+    TEST_CHECK(failures, list_error(snap) == errors::OK);
+    TEST_CHECK(failures, list_size(snap) == size);
+
+    int walked = 0;
+    int wrong  = 0;
+    for (int cell = snap->head; cell != 0 && walked < size; cell = snap->next(cell), walked++) {
+        if (snap->value(cell) != expected[walked]) wrong++;
+    }
+    TEST_CHECK(failures, walked == size);
+    TEST_CHECK(failures, wrong  == 0);
+
+    for (int i = 0; i < size; i += size / 7 + 1) {
+        TEST_CHECK(failures, get(snap, i) == expected[i]);
+    }
+    if (size > 0) TEST_CHECK(failures, get(snap, size - 1) == expected[size - 1]);
+
+    return failures;
+}
+
+//! Function checks, that read functions of list don`t copy chunks of snapshot
+//! \return number of failed checks
+static int test_cow_reads() {
+    int failures = 0;
+
+    List<int, CowStorage> lst = { };
+    failures += test_cow_fill(&lst, TEST_COW_SIZE);
+
+    ListSnapshot<int> snap = { };
+    TEST_CHECK(failures, snapshot_take(&lst, &snap));
+
+    int wrong = 0;
+    for (int i = 0; i < TEST_COW_SIZE; i += 97) {
+        if (get(&lst, i) != i) wrong++;
+    }
+    TEST_CHECK(failures, wrong == 0);
+    TEST_CHECK(failures, find_value(&lst, TEST_COW_SIZE - 1) > 0);
+    TEST_CHECK(failures, list_locality(&lst) >= 0);
+
+    char filename[] = "/tmp/test_cow_XXXXXX";
+    int  fd = mkstemp(filename);
+    TEST_CHECK(failures, fd >= 0);
+    if (fd >= 0) {
+        close(fd);
+        TEST_CHECK(failures, list_save(&lst, filename));
+        unlink(filename);
+    }
+
+    TEST_CHECK(failures, list_error(&lst) == errors::OK);
+    TEST_CHECK(failures, snap.n_chunks == lst.data.n_chunks);
+    for (int i = 0; i < snap.n_chunks && i < lst.data.n_chunks; i++) {
+        TEST_CHECK(failures, lst.data.chunks[i] == snap.chunks[i]);
+    }
+
+    // The first change of chunk copies it only for list
+    TEST_CHECK(failures, pop_front(&lst) == 0);
+    TEST_CHECK(failures, lst.data.chunks[0] != snap.chunks[0]);
+    TEST_CHECK(failures, snap.value(snap.head) == 0);
+
+    snapshot_release(&snap);
+    list_dtor(&lst);
+    return failures;
+}
+
+//! Function changes list by all mutators and checks snapshots after each of them
+//! \return number of failed checks
+static int test_cow_mutations() {
+    int failures = 0;
+
+    List<int, CowStorage> lst = { };
+    failures += test_cow_fill(&lst, TEST_COW_SIZE);
+
+    int* first  = (int*) calloc(TEST_COW_SIZE, sizeof(int));
+    int* second = (int*) calloc(TEST_COW_SIZE * 2, sizeof(int));
+    int* bulk   = (int*) calloc(TEST_COW_SIZE, sizeof(int));
+    TEST_CHECK(failures, first != NULL && second != NULL && bulk != NULL);
+    if (failures) {
+        free(first); free(second); free(bulk);
+        list_dtor(&lst);
+        return failures;
+    }
+
+    ListSnapshot<int> snap1 = { };
+    test_cow_values(&lst, first);
+    TEST_CHECK(failures, snapshot_take(&lst, &snap1));
+    int size1 = lst.size;
+
+    // Pushes and pops by indexes and at ends
+    int mid = find_value(&lst, TEST_COW_SIZE / 2);
+    TEST_CHECK(failures, push_index(&lst, -1, mid) > 0);
+    TEST_CHECK(failures, pop_index(&lst, find_value(&lst, 5)) == 5);
+    TEST_CHECK(failures, push_front(&lst, -2) > 0);
+    TEST_CHECK(failures, pop_back(&lst) == TEST_COW_SIZE - 1);
+    TEST_CHECK(failures, list_error(&lst) == errors::OK);
+    failures += test_cow_check_snapshot(&snap1, first, size1);
+
+    // Bulk functions
+    for (int i = 0; i < TEST_COW_SIZE; i++) bulk[i] = TEST_COW_SIZE + i;
+    TEST_CHECK(failures, push_back_n(&lst, bulk, TEST_COW_SIZE / 2));
+    TEST_CHECK(failures, pop_front_n(&lst, bulk, 1000));
+    TEST_CHECK(failures, bulk[0] == -2 && bulk[1] == 0);
+    TEST_CHECK(failures, list_error(&lst) == errors::OK);
+    failures += test_cow_check_snapshot(&snap1, first, size1);
+
+    // Second snapshot of changed list
+    ListSnapshot<int> snap2 = { };
+    test_cow_values(&lst, second);
+    TEST_CHECK(failures, snapshot_take(&lst, &snap2));
+    int size2 = lst.size;
+
+    // Compaction after pushes and pops, then linearize
+    lst.compact_budget = 4;
+    for (int i = 0; i < 2000; i++) {
+        if (i % 3 == 2) pop_index(&lst, find_value(&lst, TEST_COW_SIZE / 2 + i));
+        else            push_index(&lst, -3 - i, lst.head);
+    }
+    TEST_CHECK(failures, list_error(&lst) == errors::OK);
+    failures += test_cow_check_snapshot(&snap1, first,  size1);
+    failures += test_cow_check_snapshot(&snap2, second, size2);
+
+    TEST_CHECK(failures, list_linearize(&lst));
+    TEST_CHECK(failures, list_error(&lst) == errors::OK);
+    failures += test_cow_check_snapshot(&snap1, first,  size1);
+    failures += test_cow_check_snapshot(&snap2, second, size2);
+
+    // Release of one snapshot doesn`t change another one
+    snapshot_release(&snap1);
+    failures += test_cow_check_snapshot(&snap2, second, size2);
+
+    // Growth of list: snapshot keeps own chunk table
+    int capacity = lst.capacity;
+    for (int i = 0; lst.capacity == capacity && i < 2 * TEST_COW_SIZE; i++) {
+        TEST_CHECK(failures, push_back(&lst, i) > 0);
+    }
+    TEST_CHECK(failures, lst.capacity > capacity);
+    TEST_CHECK(failures, list_error(&lst) == errors::OK);
+    failures += test_cow_check_snapshot(&snap2, second, size2);
+
+    snapshot_release(&snap2);
+    free(first);
+    free(second);
+    free(bulk);
+    list_dtor(&lst);
+    return failures;
+}
+
+//! Thread function: walks snapshot and checks sum of its values
+//! \param arg ptr to TestCowReader
+//! \return    NULL
+static void* test_cow_reader(void* arg) {
+    TestCowReader*     reader = (TestCowReader*) arg;
+    ListSnapshot<int>* snap   = reader->snap;
+
+    for (int walk = 0; walk < TEST_COW_WALKS; walk++) {
+        long long sum    = 0;
+        int       walked = 0;
+        for (int cell = snap->head; cell != 0 && walked < snap->size; cell = snap->next(cell), walked++) {
+            sum += snap->value(cell);
+        }
+
+        if (sum != reader->sum || walked != snap->size) reader->errors++;
+    }
+
+    return NULL;
+}
+
+//! Function runs reader of snapshot, while main thread changes list
+//! \return number of failed checks
+static int test_cow_reader_thread() {
+    int failures = 0;
+
+    List<int, CowStorage> lst = { };
+    failures += test_cow_fill(&lst, TEST_COW_SIZE);
+
+    ListSnapshot<int> snap = { };
+    TEST_CHECK(failures, snapshot_take(&lst, &snap));
+
+    TestCowReader reader = { &snap, (long long)TEST_COW_SIZE * (TEST_COW_SIZE - 1) / 2, 0 };
+    pthread_t     thread = { };
+    int started = pthread_create(&thread, NULL, test_cow_reader, &reader) == 0;
+    TEST_CHECK(failures, started);
+
+    for (int i = 0; i < TEST_COW_SIZE; i++) {
+        if (i % 2) pop_front(&lst);
+        else       push_back(&lst, -i);
+    }
+    TEST_CHECK(failures, list_linearize(&lst));
+
+    if (started) pthread_join(thread, NULL);
+    TEST_CHECK(failures, reader.errors == 0);
+    TEST_CHECK(failures, list_error(&lst) == errors::OK);
+
+    snapshot_release(&snap);
+    list_dtor(&lst);
+    return failures;
+}
+
+//! Function runs copy-on-write snapshot tests
+//! \return number of failed checks
+static int test_cow() {
+    int failures = 0;
+
+    failures += test_report("cow snapshot: reads don`t copy chunks",  test_cow_reads());
+    failures += test_report("cow snapshot: isolation from mutators",  test_cow_mutations());
+    failures += test_report("cow snapshot: reader thread and writer", test_cow_reader_thread());
+
+    return failures;
+}
+// ----------------------------------------------------------------------------
+
+#endif // TEST_COWH
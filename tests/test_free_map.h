@@ -0,0 +1,106 @@
+#ifndef TEST_FREE_MAPH
+#define TEST_FREE_MAPH
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "test_base.h"
+#include "../list.h"
+
+// Free map tests--------------------------------------------------------------
+// list_free_map_nearest must give free cell at the least distance from target (after target, if
+// distances are equal). Targets at bit 0 and bit 63 of word check neighbours in other words, random
+// maps are compared with linear search.
+
+const int TEST_FREE_MAP_WORDS = 8;
+const int TEST_FREE_MAP_MAPS  = 256;
+
+//! Function finds the nearest free cell by linear search
+//! \param map    ptr to ListFreeMap object
+//! \param target physical index of desired cell
+//! \return       physical index of free cell (0 if there are no free cells)
+static int test_free_map_linear(const ListFreeMap* map, int target) {
+    int n_cells = map->n_words * 64;
+
+    for (int dist = 0; dist < n_cells; dist++) {
+        int after  = target + dist;
+        int before = target - dist;
+
+        if (after  < n_cells && (map->bits[after  >> 6] >> (after  & 63) & 1)) return after;
+        if (before >= 0      && (map->bits[before >> 6] >> (before & 63) & 1)) return before;
+    }
+
+    return 0;
+}
+
+//! Function checks targets at edges of words
+//! \return number of failed checks
+static int test_free_map_edges() {
+    int failures = 0;
+
+    unsigned long long bits[TEST_FREE_MAP_WORDS] = { };
+    ListFreeMap map = { bits, TEST_FREE_MAP_WORDS };
+
+    // Target at bit 0: free cell of its own word is far, cell of previous word is near
+    list_free_map_set(&map, 63);
+    list_free_map_set(&map, 127);
+    TEST_CHECK(failures, list_free_map_nearest(&map, 64) == 63);
+
+    // Target at bit 63: free cell of next word is near
+    list_free_map_set(&map, 64);
+    list_free_map_set(&map, 128);
+    list_free_map_clear(&map, 127);
+    TEST_CHECK(failures, list_free_map_nearest(&map, 127) == 128);
+
+    // Free target and equal distances
+    TEST_CHECK(failures, list_free_map_nearest(&map, 64) == 64);
+    list_free_map_clear(&map, 64);
+    list_free_map_set(&map, 65);
+    TEST_CHECK(failures, list_free_map_nearest(&map, 64) == 65);
+
+    // Empty map
+    for (int i = 0; i < TEST_FREE_MAP_WORDS; i++) bits[i] = 0;
+    TEST_CHECK(failures, list_free_map_nearest(&map, 300) == 0);
+
+    return failures;
+}
+
+//! Function compares nearest free cells of random maps with linear search
+//! \return number of failed checks
+static int test_free_map_random() {
+    int failures = 0;
+
+    unsigned long long bits[TEST_FREE_MAP_WORDS] = { };
+    ListFreeMap map = { bits, TEST_FREE_MAP_WORDS };
+
+    unsigned seed  = 2009u;
+    int      wrong = 0;
+    for (int i = 0; i < TEST_FREE_MAP_MAPS; i++) {
+        int density = 1 + rand_r(&seed) % 200;      // Free cells per 1000 cells
+        for (int cell = 0; cell < TEST_FREE_MAP_WORDS * 64; cell++) {
+            if (rand_r(&seed) % 1000 < density) list_free_map_set  (&map, cell);
+            else                                list_free_map_clear(&map, cell);
+        }
+
+        for (int target = 0; target < TEST_FREE_MAP_WORDS * 64; target++) {
+            if (list_free_map_nearest(&map, target) != test_free_map_linear(&map, target)) wrong++;
+        }
+    }
+    TEST_CHECK(failures, wrong == 0);
+
+    return failures;
+}
+
+//! Function runs free map tests
+//! \return number of failed checks
+static int test_free_map() {
+    int failures = 0;
+
+    failures += test_report("free map: nearest cell at word edges", test_free_map_edges());
+    failures += test_report("free map: nearest cell of random maps", test_free_map_random());
+
+    return failures;
+}
+// ----------------------------------------------------------------------------
+
+#endif // TEST_FREE_MAPH
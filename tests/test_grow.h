@@ -0,0 +1,96 @@
+#ifndef TEST_GROWH
+#define TEST_GROWH
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "test_base.h"
+#include "../list.h"
+
+// Failed growth tests---------------------------------------------------------
+// Storage, which can`t grow, imitates lack of memory for bigger capacity. Pushes to full list must
+// return NOT_ENOUGH_MEMORY and leave list the same: links, values and cached positions of get.
+
+const int TEST_GROW_CAPACITY = 16;
+
+//! AosStorage, which can`t grow (as if realloc failed)
+template <typename T>
+struct TestNoGrowStorage : AosStorage<T> {
+    int grow(int, int) { return 0; }
+};
+
+//! Function checks, that list has values 0, 1, ... size - 1 and correct fields
+//! \param lst  ptr to List object
+//! \param size expected size
+//! \return     number of failed checks
+static int test_grow_same(List<int, TestNoGrowStorage>* lst, int size) {
+    int failures = 0;
+
+    TEST_CHECK(failures, list_error(lst) == errors::OK);
+    TEST_CHECK(failures, lst->size     == size);
+    TEST_CHECK(failures, lst->capacity == TEST_GROW_CAPACITY);
+    TEST_CHECK(failures, lst->data.next(0) == lst->head && lst->data.prev(0) == lst->tail);
+
+    int wrong = 0;
+    for (int i = 0; i < size; i++) {
+        if (get(lst, i) != i) wrong++;
+    }
+    TEST_CHECK(failures, wrong == 0);
+
+    return failures;
+}
+
+//! Function pushes to full list, which can`t grow
+//! \param free_map 1 if free map is on
+//! \return         number of failed checks
+static int test_grow_full(int free_map) {
+    int failures = 0;
+
+    List<int, TestNoGrowStorage> lst = { };
+    TEST_CHECK(failures, list_ctor(&lst, TEST_GROW_CAPACITY));
+    if (free_map) TEST_CHECK(failures, list_free_map_enable(&lst));
+
+    int size = TEST_GROW_CAPACITY - 1;
+    for (int i = 0; i < size; i++) {
+        TEST_CHECK(failures, push_back(&lst, i) > 0);
+    }
+
+    // Not sorted list: get goes through fingers, which mustn`t shift after failed push
+    int mid = lst.data.next(lst.head);
+    TEST_CHECK(failures, pop_index(&lst, mid) == 1);
+    TEST_CHECK(failures, push_index(&lst, 1, lst.head) > 0);
+    failures += test_grow_same(&lst, size);
+
+    int before_finger = find_value(&lst, size / 2);
+    TEST_CHECK(failures, get(&lst, size / 2 + 2) == size / 2 + 2);
+
+    int values[2] = { };
+    TEST_CHECK(failures, push_index(&lst, -1, before_finger) == errors::NOT_ENOUGH_MEMORY && errno == errors::NOT_ENOUGH_MEMORY);
+    TEST_CHECK(failures, get(&lst, size / 2 + 2) == size / 2 + 2);
+    TEST_CHECK(failures, push_back (&lst, -1)      == errors::NOT_ENOUGH_MEMORY);
+    TEST_CHECK(failures, push_front(&lst, -1)      == errors::NOT_ENOUGH_MEMORY);
+    TEST_CHECK(failures, push_back_n(&lst, values, 2) == 0);
+    failures += test_grow_same(&lst, size);
+
+    // List works after failed pushes
+    TEST_CHECK(failures, pop_back(&lst) == size - 1);
+    TEST_CHECK(failures, push_back(&lst, size - 1) > 0);
+    failures += test_grow_same(&lst, size);
+
+    list_dtor(&lst);
+    return failures;
+}
+
+//! Function runs failed growth tests
+//! \return number of failed checks
+static int test_grow() {
+    int failures = 0;
+
+    failures += test_report("failed growth: push to full list",           test_grow_full(0));
+    failures += test_report("failed growth: push to full list (free map)", test_grow_full(1));
+
+    return failures;
+}
+// ----------------------------------------------------------------------------
+
+#endif // TEST_GROWH
@@ -0,0 +1,233 @@
+#ifndef TEST_INGESTH
+#define TEST_INGESTH
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdint.h>
+
+#include "test_base.h"
+#include "../list.h"
+#include "../libs/file_funcs.h"
+#include "../libs/text_scan.h"
+
+// Number ingest tests---------------------------------------------------------
+// Number parsing of every kernel is compared with byte loop on words, which check signs, leading
+// zeros, int bounds and wrong words. list_from_text of several threads is compared with numbers,
+// which were written to text.
+
+const char* const TEST_INGEST_FILE    = "test_ingest.txt";
+const int         TEST_INGEST_WORDS   = 2000;
+const int         TEST_INGEST_NUMBERS = 1 << 20;   // Several TEXT_THREAD_MIN_CHUNK of text
+const int         TEST_INGEST_THREADS[] = { 1, 2, 3, 5 };
+
+const char* const TEST_INGEST_GOOD_WORDS[] = {
+    "2147483647", "-2147483648", "+2147483647", "00000000000000000042", "-0", "+0"
+};
+const char* const TEST_INGEST_BAD_WORDS[] = {
+    "2147483648", "-2147483649", "99999999999999999999", "12a", "-", "+", "--1", "1-2", "\x80"
+};
+
+//! Function checks if symbol is space (like isspace in "C" locale)
+//! \param symbol checked symbol
+//! \return       1 if symbol is space, else 0
+static int test_ingest_space(char symbol) {
+    return symbol == ' ' || ('\t' <= symbol && symbol <= '\r');
+}
+
+//! Function parses one word by bytes
+//! \param begin ptr to beginning of word
+//! \param end   ptr to end of word
+//! \param value ptr to result
+//! \return      1 if word is int number, else 0
+static int test_ingest_word(const char* begin, const char* end, int* value) {
+    int negative = *begin == '-';
+    if (negative || *begin == '+') begin++;
+    if (begin == end) return 0;
+
+    int64_t number = 0;
+    for ( ; begin < end; begin++) {
+        if (*begin < '0' || *begin > '9') return 0;
+
+        number = number * 10 + (*begin - '0');
+        if (number > (int64_t)INT_MAX + 1) return 0;
+    }
+
+    number = negative ? -number : number;
+    if (number > INT_MAX) return 0;
+
+    *value = (int)number;
+    return 1;
+}
+
+//! Byte loop of scan_parse_ints (see libs/text_scan.h)
+static size_t test_parse_ints_loop(const char* begin, const char* end, int* values, size_t max_values, const char** stop) {
+    size_t n_values = 0;
+    for ( ; n_values < max_values; n_values++) {
+        while (begin < end && test_ingest_space(*begin)) begin++;
+        if (begin == end) break;
+
+        const char* word_end = begin;
+        while (word_end < end && !test_ingest_space(*word_end)) word_end++;
+
+        if (!test_ingest_word(begin, word_end, &values[n_values])) break;
+        begin = word_end;
+    }
+
+    *stop = begin;
+    return n_values;
+}
+
+//! Function writes random word to buffer (number of random length, number near int bounds or wrong word)
+//! \param buffer ptr to buffer (it should have place for 24 symbols)
+//! \param wrong  flag to allow wrong words
+//! \return       length of word
+static int test_ingest_random_word(char* buffer, int wrong) {
+    int roll = rand() % 100;
+    if (roll < 5 && wrong) {
+        return snprintf(buffer, 24, "%s", TEST_INGEST_BAD_WORDS [rand() % (sizeof(TEST_INGEST_BAD_WORDS)  / sizeof(char*))]);
+    }
+    if (roll < 10) {
+        return snprintf(buffer, 24, "%s", TEST_INGEST_GOOD_WORDS[rand() % (sizeof(TEST_INGEST_GOOD_WORDS) / sizeof(char*))]);
+    }
+
+    int length = 0;
+    if (roll < 30) buffer[length++] = roll < 20 ? '-' : '+';
+
+    int n_digits = 1 + rand() % (roll < 60 ? 9 : 4);
+    for (int i = 0; i < n_digits; i++) buffer[length++] = (char)('0' + rand() % 10);
+
+    buffer[length] = '\0';
+    return length;
+}
+
+//! Function writes words divided by random spaces
+//! \param buffer  ptr to buffer (24 + 4 symbols for each word)
+//! \param n_words number of words
+//! \param wrong   flag to allow wrong words
+//! \return        size of text
+static size_t test_ingest_random_text(char* buffer, int n_words, int wrong) {
+    const char spaces[] = " \t\n\r\v\f";
+
+    size_t size = 0;
+    for (int i = 0; i < n_words; i++) {
+        int n_spaces = i == 0 ? rand() % 2 : 1 + rand() % 3;
+        for (int j = 0; j < n_spaces; j++) buffer[size++] = spaces[rand() % (sizeof(spaces) - 1)];
+
+        size += (size_t)test_ingest_random_word(buffer + size, wrong);
+    }
+    if (rand() % 2) buffer[size++] = '\n';
+
+    return size;
+}
+
+//! Function compares number parsing of used kernel with byte loop
+//! \return number of failed checks
+static int test_ingest_kernel() {
+    int failures = 0;
+
+    const size_t TEXT_SIZE = TEST_INGEST_WORDS * 28;
+
+    char* text     = (char*) calloc(TEXT_SIZE + 64, sizeof(char));
+    int*  values   = (int*)  calloc(TEST_INGEST_WORDS, sizeof(int));
+    int*  expected = (int*)  calloc(TEST_INGEST_WORDS, sizeof(int));
+
+    for (int round = 0; round < 200; round++) {
+        int    n_words = 1 + rand() % TEST_INGEST_WORDS;
+        size_t size    = test_ingest_random_text(text, n_words, round % 2);
+
+        size_t max_values = round % 3 == 0 ? (size_t)(rand() % n_words) : (size_t)TEST_INGEST_WORDS;
+
+        const char* stop          = NULL;
+        const char* expected_stop = NULL;
+        size_t n_values   = scan_parse_ints     (text, text + size, values,   max_values, &stop);
+        size_t n_expected = test_parse_ints_loop(text, text + size, expected, max_values, &expected_stop);
+
+        TEST_CHECK(failures, n_values == n_expected);
+        TEST_CHECK(failures, stop == expected_stop);
+        TEST_CHECK(failures, memcmp(values, expected, n_expected * sizeof(int)) == 0);
+
+        if (round % 2 == 0) TEST_CHECK(failures, scan_count_words(text, text + size) == (size_t)n_words);
+    }
+
+    free(text);
+    free(values);
+    free(expected);
+
+    return failures;
+}
+
+//! Function compares list_from_text and list_from_file of several threads with written numbers
+//! \return number of failed checks
+static int test_ingest_lists() {
+    int failures = 0;
+
+    char* text     = (char*) calloc((size_t)TEST_INGEST_NUMBERS * 28, sizeof(char));
+    int*  expected = (int*)  calloc(TEST_INGEST_NUMBERS, sizeof(int));
+
+    size_t size = test_ingest_random_text(text, TEST_INGEST_NUMBERS, 0);
+
+    const char* stop = NULL;
+    TEST_CHECK(failures, test_parse_ints_loop(text, text + size, expected, TEST_INGEST_NUMBERS, &stop) == (size_t)TEST_INGEST_NUMBERS);
+
+    FILE* file = fopen(TEST_INGEST_FILE, "wb");
+    TEST_CHECK(failures, file != NULL && fwrite(text, sizeof(char), size, file) == size);
+    if (file != NULL) fclose(file);
+
+    for (int n_threads : TEST_INGEST_THREADS) {
+        for (int from_file = 0; from_file < 2; from_file++) {
+            List<int> lst = { };
+            int ok = from_file ? list_from_file(&lst, TEST_INGEST_FILE, n_threads) : list_from_text(&lst, text, size, n_threads);
+
+            TEST_CHECK(failures, ok);
+            if (!ok) continue;
+
+            TEST_CHECK(failures, list_error(&lst) == errors::OK);
+            TEST_CHECK(failures, lst.size == TEST_INGEST_NUMBERS && lst.is_sorted == 1);
+
+            int index = 0, prev = 0, same = 1;
+            for (int cell = lst.head; cell != 0 && index < TEST_INGEST_NUMBERS; prev = cell, cell = lst.data.next(cell), index++) {
+                same = same && lst.data.value(cell) == expected[index] && lst.data.prev(cell) == prev;
+            }
+            TEST_CHECK(failures, same && index == TEST_INGEST_NUMBERS && lst.tail == prev);
+
+            list_dtor(&lst);
+        }
+    }
+
+    // Wrong word in the last chunk fails ingest of any number of threads
+    memcpy(text + size - 4, " 1x ", 4);
+    for (int n_threads : TEST_INGEST_THREADS) {
+        List<int> lst = { };
+        TEST_CHECK(failures, !list_from_text(&lst, text, size, n_threads) && errno == errors::BAD_NUMBER);
+    }
+
+    remove(TEST_INGEST_FILE);
+    free(text);
+    free(expected);
+
+    return failures;
+}
+
+//! Function runs number ingest tests
+//! \return number of failed checks
+static int test_ingest() {
+    int failures = 0;
+
+    const int kernels[] = { TEXT_SCAN_SCALAR, TEXT_SCAN_SSE2, TEXT_SCAN_AVX2 };
+    for (int kernel : kernels) {
+        if (text_scan_use(kernel) != kernel) continue;      // CPU doesn`t support kernel
+
+        char name[64] = "";
+        snprintf(name, sizeof(name), "number parsing with %s kernel", text_scan_kernel_name());
+        failures += test_report(name, test_ingest_kernel());
+    }
+    text_scan_use(TEXT_SCAN_AUTO);
+
+    failures += test_report("list_from_text/list_from_file equal to written numbers", test_ingest_lists());
+    return failures;
+}
+// ----------------------------------------------------------------------------
+
+#endif // TEST_INGESTH
@@ -0,0 +1,358 @@
+#ifndef TEST_JOURNALH
+#define TEST_JOURNALH
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "test_base.h"
+#include "../list.h"
+
+// Journal replay tests--------------------------------------------------------
+// List with journal is changed by random pushes and pops (by indexes, at ends and by bulk
+// functions), resize, linearize, sort, compaction and switches of free map and rank index. Recovery
+// (list_load of snapshot file and list_journal_replay) must give the same cells, links and fields
+// as list after last commit. Crashes are imitated by files: records after commit are lost, journal
+// is truncated in the middle of record or has torn tail, checkpoint saved snapshot file, but
+// journal wasn`t truncated.
+
+const int TEST_JOURNAL_ROUNDS   = 16;
+const int TEST_JOURNAL_OPS      = 2000;
+const int TEST_JOURNAL_RECOVERY = 100;     // Ops between recoveries
+const int TEST_JOURNAL_BULK     = 64;
+const int TEST_JOURNAL_CAPACITY = 512;     // Less than size of list after round: resize records are replayed
+
+struct TestJournalFiles {
+    char image  [32];
+    char journal[32];
+    char old    [32];       // Copy of journal before checkpoint
+};
+
+//! Function creates temporary files for test
+//! \param files ptr to TestJournalFiles object
+//! \return      1 if success, else 0
+static int test_journal_files(TestJournalFiles* files) {
+    char* names[] = { files->image, files->journal, files->old };
+
+    for (int i = 0; i < 3; i++) {
+        snprintf(names[i], sizeof(files->image), "/tmp/test_journal_XXXXXX");
+
+        int fd = mkstemp(names[i]);
+        if (fd < 0) return 0;
+        close(fd);
+    }
+
+    return 1;
+}
+
+//! Function copies file
+//! \param from ptr to path of source file
+//! \param to   ptr to path of destination file
+//! \return     1 if success, else 0
+static int test_journal_copy(const char* from, const char* to) {
+    int src = open(from, O_RDONLY);
+    int dst = open(to,   O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    int  ok = src >= 0 && dst >= 0;
+    char buffer[1 << 12] = "";
+    for (ssize_t n = 0; ok && (n = read(src, buffer, sizeof(buffer))) != 0; ) {
+        ok = n > 0 && write(dst, buffer, (size_t)n) == n;
+    }
+
+    if (src >= 0) close(src);
+    if (dst >= 0) close(dst);
+    return ok;
+}
+
+//! Function compares fields, links and values of lists
+//! \param lst       ptr to List object
+//! \param recovered ptr to recovered List object
+//! \return          1 if lists are the same, else 0
+static int test_journal_same(List<int>* lst, List<int>* recovered) {
+    if (lst->capacity   != recovered->capacity   || lst->head      != recovered->head      ||
+        lst->tail       != recovered->tail       || lst->size      != recovered->size      ||
+        lst->first_free != recovered->first_free || lst->is_sorted != recovered->is_sorted ||
+        list_sorted_prefix(lst) != list_sorted_prefix(recovered)                           ||
+        (lst->free_map.bits != NULL) != (recovered->free_map.bits != NULL)) {
+        return 0;
+    }
+
+    const AosStorage<int>& data      = lst->data;
+    const AosStorage<int>& rec_data  = recovered->data;
+    for (int i = 0; i < lst->capacity; i++) {
+        if (data.next(i) != rec_data.next(i) || data.prev(i) != rec_data.prev(i)) return 0;
+        if (!list_cell_is_free(lst, i) && data.value(i) != rec_data.value(i))    return 0;
+    }
+
+    // Rank index of list (it has no records) gives the same elements
+    for (int i = 0; i < lst->size; i += lst->size / 5 + 1) {
+        if (get(lst, i) != get(recovered, i)) return 0;
+    }
+
+    return 1;
+}
+
+//! Function recovers list from files of journal
+//! \param files     ptr to TestJournalFiles object
+//! \param recovered ptr to List object (it should be empty)
+//! \return          1 if success, else 0
+static int test_journal_recover(TestJournalFiles* files, List<int>* recovered) {
+    *recovered = { };
+    if (!list_load(recovered, files->image, LIST_LOAD_COPY)) return 0;
+
+    return list_journal_replay(recovered, files->journal);
+}
+
+//! Function checks, that recovery from files gives list
+//! \param files ptr to TestJournalFiles object
+//! \param lst   ptr to expected List object
+//! \return      1 if recovered list is the same, else 0
+static int test_journal_recovers(TestJournalFiles* files, List<int>* lst) {
+    List<int> recovered = { };
+
+    int ok = test_journal_recover(files, &recovered) && test_journal_same(lst, &recovered);
+    if (recovered.capacity > 0) list_dtor(&recovered);
+
+    return ok;
+}
+
+//! Function gets cell of random element
+//! \param lst  ptr to List object (it shouldn`t be empty)
+//! \param seed ptr to seed of rand_r
+//! \return     physical index of element
+static int test_journal_random_cell(List<int>* lst, unsigned* seed) {
+    const AosStorage<int>& data = lst->data;
+
+    int cell = lst->head;
+    for (int i = rand_r(seed) % lst->size; i > 0; i--) cell = data.next(cell);
+
+    return cell;
+}
+
+//! Function changes list by random operation
+//! \param lst  ptr to List object
+//! \param seed ptr to seed of rand_r
+static void test_journal_random_op(List<int>* lst, unsigned* seed) {
+    int values[TEST_JOURNAL_BULK] = { };
+    int kind  = rand_r(seed) % 100;
+    int value = rand_r(seed) % 1000;
+
+    if      (kind < 25) push_back (lst, value);
+    else if (kind < 32) push_front(lst, value);
+    else if (kind < 42) {
+        if (lst->size > 0) push_index(lst, value, test_journal_random_cell(lst, seed));
+    }
+    else if (kind < 54) {
+        if (lst->size > 0) pop_index(lst, test_journal_random_cell(lst, seed));
+    }
+    else if (kind < 60) {
+        if (lst->size > 0) pop_back(lst);
+    }
+    else if (kind < 66) {
+        if (lst->size > 0) pop_front(lst);
+    }
+    else if (kind < 74) {
+        int n = rand_r(seed) % TEST_JOURNAL_BULK;
+        for (int i = 0; i < n; i++) values[i] = value + i;
+        push_back_n(lst, values, n);
+    }
+    else if (kind < 80) {
+        int n = rand_r(seed) % (lst->size < TEST_JOURNAL_BULK ? lst->size + 1 : TEST_JOURNAL_BULK);
+        pop_front_n(lst, values, n);
+    }
+    else if (kind < 83) {
+        if (lst->free_map.bits != NULL) list_free_map_disable(lst);
+        else                            list_free_map_enable (lst);
+    }
+    else if (kind < 85) {
+        if (lst->rank.block_of != NULL) list_rank_disable(lst);
+        else                            list_rank_enable (lst);
+    }
+    else if (kind < 86) list_linearize(lst);
+    else if (kind < 87) please_dont_use_sorted_by_next_values_func_because_it_too_slow__also_do_you_really_need_it__i_think_no__so_dont_do_stupid_things_and_better_look_at_memes_about_cats(lst);
+    else if (kind < 90) lst->compact_budget = lst->compact_budget ? 0 : 1 + rand_r(seed) % 8;
+    else                list_journal_commit(lst);
+}
+
+//! Function imitates crash after checkpoint saved snapshot file, but before journal was truncated
+//! \param files ptr to TestJournalFiles object
+//! \param lst   ptr to List object with journal
+//! \return      number of failed checks
+static int test_journal_stale(TestJournalFiles* files, List<int>* lst) {
+    int failures = 0;
+
+    TEST_CHECK(failures, list_journal_commit(lst));
+    TEST_CHECK(failures, test_journal_copy(files->journal, files->old));
+    TEST_CHECK(failures, list_checkpoint(lst));
+    TEST_CHECK(failures, test_journal_copy(files->old, files->journal));
+
+    // Records of old journal are in snapshot file already
+    TEST_CHECK(failures, test_journal_recovers(files, lst));
+
+    TEST_CHECK(failures, list_checkpoint(lst));
+    return failures;
+}
+
+//! Function imitates crashes at the end of round: lost records after commit, journal truncated in
+//! the middle of record and torn tail
+//! \param files ptr to TestJournalFiles object
+//! \param lst   ptr to List object with journal
+//! \param seed  ptr to seed of rand_r
+//! \return      number of failed checks
+static int test_journal_crash(TestJournalFiles* files, List<int>* lst, unsigned* seed) {
+    int failures = 0;
+
+    TEST_CHECK(failures, list_journal_commit(lst));
+
+    List<int> committed = { };
+    TEST_CHECK(failures, test_journal_recover(files, &committed));
+    TEST_CHECK(failures, test_journal_same(lst, &committed));
+
+    struct stat journal_stat = { };
+    TEST_CHECK(failures, stat(files->journal, &journal_stat) == 0);
+
+    // Changes without commit are lost
+    for (int i = 0; i < 8; i++) {
+        int value = rand_r(seed) % 1000;
+        push_back(lst, value);
+        if (lst->size > 1) pop_index(lst, test_journal_random_cell(lst, seed));
+    }
+    TEST_CHECK(failures, test_journal_recovers(files, &committed));
+
+    // Journal is cut in the middle of the first record after commit
+    TEST_CHECK(failures, list_journal_commit(lst));
+    TEST_CHECK(failures, test_journal_recovers(files, lst));
+    TEST_CHECK(failures, truncate(files->journal, journal_stat.st_size + (off_t)sizeof(ListJournalRecord<int>) / 2) == 0);
+    TEST_CHECK(failures, test_journal_recovers(files, &committed));
+
+    // Torn tail after whole records
+    TEST_CHECK(failures, truncate(files->journal, journal_stat.st_size) == 0);
+    int fd = open(files->journal, O_WRONLY | O_APPEND);
+    TEST_CHECK(failures, fd >= 0 && write(fd, "torn", 4) == 4);
+    if (fd >= 0) close(fd);
+    TEST_CHECK(failures, test_journal_recovers(files, &committed));
+
+    list_dtor(&committed);
+    return failures;
+}
+
+//! Function runs rounds of random changes and recoveries
+//! \return number of failed checks
+static int test_journal_replay() {
+    int failures = 0;
+
+    TestJournalFiles files = { };
+    TEST_CHECK(failures, test_journal_files(&files));
+    if (failures) return failures;
+
+    unsigned seed = 2025u;
+    for (int round = 0; round < TEST_JOURNAL_ROUNDS; round++) {
+        List<int> lst = { };
+        TEST_CHECK(failures, list_ctor(&lst, TEST_JOURNAL_CAPACITY));
+        TEST_CHECK(failures, list_journal_open(&lst, files.image, files.journal, round % 4 == 3 ? JOURNAL_SYNC_COMMIT : JOURNAL_SYNC_NONE));
+        if (lst.journal == NULL) {
+            list_dtor(&lst);
+            break;
+        }
+
+        int diverged = 0;
+        for (int op = 1; op <= TEST_JOURNAL_OPS; op++) {
+            test_journal_random_op(&lst, &seed);
+            if (op == TEST_JOURNAL_OPS / 2) resize_list_capacity(&lst, lst.capacity + 1 + round);   // Pushes don`t grow list to it
+
+            if (op % TEST_JOURNAL_RECOVERY == 0) {
+                if (!list_journal_commit(&lst) || !test_journal_recovers(&files, &lst)) diverged++;
+            }
+            if (op % (TEST_JOURNAL_OPS / 3) == 0) failures += test_journal_stale(&files, &lst);
+        }
+        TEST_CHECK(failures, diverged == 0);
+        TEST_CHECK(failures, list_error(&lst) == errors::OK);
+
+        failures += test_journal_crash(&files, &lst, &seed);
+        list_dtor(&lst);
+    }
+
+    unlink(files.image);
+    unlink(files.journal);
+    unlink(files.old);
+    return failures;
+}
+
+//! Function changes value of pop record in journal file
+//! \param filename ptr to path of journal file
+//! \param nth      number of pop record (from 0)
+//! \return         1 if record was changed, else 0
+static int test_journal_break_pop(const char* filename, int nth) {
+    int fd = open(filename, O_RDWR);
+    if (fd < 0) return 0;
+
+    ListJournalRecord<int> record = { };
+    int changed = 0;
+    for (off_t offset = sizeof(ListJournalHeader); !changed && pread(fd, &record, sizeof(record), offset) == (ssize_t)sizeof(record);
+         offset += sizeof(record)) {
+        if (record.op != JOURNAL_POP || nth-- > 0) continue;
+
+        record.value++;
+        changed = pwrite(fd, &record, sizeof(record), offset) == (ssize_t)sizeof(record);
+    }
+
+    close(fd);
+    return changed;
+}
+
+//! Function checks, that replay fails on pop record with wrong value (by index and from head)
+//! \return number of failed checks
+static int test_journal_wrong_pop() {
+    int failures = 0;
+
+    TestJournalFiles files = { };
+    TEST_CHECK(failures, test_journal_files(&files));
+    if (failures) return failures;
+
+    // Pop records: 0 - pop_index in the middle, 1 and 2 - run of pops from head
+    for (int nth = 0; nth < 3; nth++) {
+        List<int> lst = { };
+        TEST_CHECK(failures, list_ctor(&lst, TEST_JOURNAL_CAPACITY));
+        TEST_CHECK(failures, list_journal_open(&lst, files.image, files.journal));
+        if (lst.journal == NULL) {
+            list_dtor(&lst);
+            break;
+        }
+
+        for (int i = 0; i < 8; i++) push_back(&lst, i);
+        TEST_CHECK(failures, pop_index(&lst, find_value(&lst, 5)) == 5);
+        TEST_CHECK(failures, pop_front(&lst) == 0);
+        TEST_CHECK(failures, pop_front(&lst) == 1);
+        TEST_CHECK(failures, list_journal_commit(&lst));
+        TEST_CHECK(failures, test_journal_recovers(&files, &lst));
+
+        TEST_CHECK(failures, test_journal_break_pop(files.journal, nth));
+
+        List<int> recovered = { };
+        TEST_CHECK(failures, !test_journal_recover(&files, &recovered) && errno == errors::BAD_JOURNAL);
+
+        if (recovered.capacity > 0) list_dtor(&recovered);
+        list_dtor(&lst);
+    }
+
+    unlink(files.image);
+    unlink(files.journal);
+    unlink(files.old);
+    return failures;
+}
+
+//! Function runs journal tests
+//! \return number of failed checks
+static int test_journal() {
+    int failures = 0;
+
+    failures += test_report("journal: replay equals list after commits and crashes", test_journal_replay());
+    failures += test_report("journal: replay fails on wrong popped value",            test_journal_wrong_pop());
+
+    return failures;
+}
+// ----------------------------------------------------------------------------
+
+#endif // TEST_JOURNALH
@@ -0,0 +1,44 @@
+#ifndef LIST_TESTSH
+#define LIST_TESTSH
+
+#include "../config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "test_base.h"
+#include "test_text_scan.h"
+#include "test_text_split.h"
+#include "test_ingest.h"
+#include "test_concurrent.h"
+#include "test_queue.h"
+#include "test_sharded.h"
+#include "test_cow.h"
+#include "test_journal.h"
+#include "test_snapshot.h"
+#include "test_free_map.h"
+#include "test_grow.h"
+
+//! Function runs all tests (make test builds them with sanitizers)
+//! \return 0 if all tests passed, else 1
+static int run_tests() {
+    srand(2021);
+
+    int failures = 0;
+    failures += test_text_scan();
+    failures += test_text_split();
+    failures += test_ingest();
+    failures += test_concurrent();
+    failures += test_queue();
+    failures += test_sharded();
+    failures += test_cow();
+    failures += test_journal();
+    failures += test_snapshot();
+    failures += test_free_map();
+    failures += test_grow();
+
+    printf("%s%d failed checks" NATURAL "\n", failures == 0 ? GREEN : RED, failures);
+    return failures != 0;
+}
+
+#endif // LIST_TESTSH
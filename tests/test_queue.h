@@ -0,0 +1,161 @@
+#ifndef TEST_QUEUEH
+#define TEST_QUEUEH
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sched.h>
+#include <pthread.h>
+
+#include "test_base.h"
+#include "../list.h"
+
+// ListQueue tests-------------------------------------------------------------
+// Small capacities check full and empty queue and wrapping of ring. In stress test producer threads
+// push numbered values into small ring, while main thread pops them: values of each producer must
+// come in order, without losses and duplicates.
+
+const int TEST_QUEUE_PRODUCERS = 4;
+const int TEST_QUEUE_VALUES    = 1 << 16;      // Values of each producer
+const int TEST_QUEUE_CAPACITY  = 8;
+
+struct TestQueueProducer {
+    ListQueue<int>* lst;
+    int             id;
+    int             push_errors;    // Errors of push_back except QUEUE_FULL
+};
+
+//! Function checks queue with one element of capacity (ring of 1 cell overwrote values)
+//! \return number of failed checks
+static int test_queue_small() {
+    int failures = 0;
+
+    for (int producers = QUEUE_SPSC; producers <= QUEUE_MPSC; producers++) {
+        ListQueue<int> lst = { };
+        TEST_CHECK(failures, list_ctor(&lst, 1, producers));
+        TEST_CHECK(failures, lst.capacity == 2);
+        TEST_CHECK(failures, pop_front(&lst) == errors::LST_EMPTY);
+
+        for (int round = 0; round < 5; round++) {
+            TEST_CHECK(failures, push_back(&lst, 10 * round + 1) >= 0);
+            TEST_CHECK(failures, push_back(&lst, 10 * round + 2) >= 0);
+            TEST_CHECK(failures, push_back(&lst, 10 * round + 3) == errors::QUEUE_FULL);
+            TEST_CHECK(failures, list_size(&lst) == 2);
+            TEST_CHECK(failures, list_error(&lst) == errors::OK);
+
+            TEST_CHECK(failures, pop_front(&lst) == 10 * round + 1);
+            TEST_CHECK(failures, push_back(&lst, 10 * round + 4) >= 0);
+            TEST_CHECK(failures, pop_front(&lst) == 10 * round + 2);
+            TEST_CHECK(failures, pop_front(&lst) == 10 * round + 4);
+            TEST_CHECK(failures, pop_front(&lst) == errors::LST_EMPTY);
+            TEST_CHECK(failures, list_error(&lst) == errors::OK);
+        }
+
+        list_dtor(&lst);
+    }
+
+    // Capacity is rounded up to power of 2
+    ListQueue<int> lst = { };
+    TEST_CHECK(failures, list_ctor(&lst, 5));
+    TEST_CHECK(failures, lst.capacity == 8);
+
+    int pushed = 0;
+    while (push_back(&lst, pushed) >= 0) pushed++;
+    TEST_CHECK(failures, pushed == 8);
+
+    for (int i = 0; i < pushed; i++) {
+        TEST_CHECK(failures, pop_front(&lst) == i);
+    }
+    TEST_CHECK(failures, list_error(&lst) == errors::OK);
+
+    list_dtor(&lst);
+    return failures;
+}
+
+//! Thread function of producer: pushes numbered values and waits, while queue is full
+//! \param arg ptr to TestQueueProducer
+//! \return    NULL
+static void* test_queue_producer(void* arg) {
+    TestQueueProducer* producer = (TestQueueProducer*) arg;
+
+    for (int i = 0; i < TEST_QUEUE_VALUES; i++) {
+        int index = 0;
+        while ((index = push_back(producer->lst, producer->id * TEST_QUEUE_VALUES + i)) == errors::QUEUE_FULL) {
+            sched_yield();
+        }
+
+        if (index < 0) producer->push_errors++;
+    }
+
+    return NULL;
+}
+
+//! Function runs producers and pops their values in main thread
+//! \param producers number of producer threads (QUEUE_SPSC means one thread)
+//! \return          number of failed checks
+static int test_queue_stress(int producers) {
+    int failures = 0;
+    int n_threads = producers == QUEUE_SPSC ? 1 : TEST_QUEUE_PRODUCERS;
+
+    ListQueue<int> lst = { };
+    TEST_CHECK(failures, list_ctor(&lst, TEST_QUEUE_CAPACITY, producers));
+    if (failures) return failures;
+
+    TestQueueProducer workers[TEST_QUEUE_PRODUCERS] = { };
+    pthread_t         threads[TEST_QUEUE_PRODUCERS] = { };
+    int               next   [TEST_QUEUE_PRODUCERS] = { };     // Next expected value of each producer
+
+    int started = 0;
+    for (; started < n_threads; started++) {
+        workers[started] = { &lst, started, 0 };
+        if (pthread_create(&threads[started], NULL, test_queue_producer, &workers[started]) != 0) break;
+    }
+    TEST_CHECK(failures, started == n_threads);
+
+    int order_errors = 0;
+    for (int popped = 0; popped < started * TEST_QUEUE_VALUES; ) {
+        int value = pop_front(&lst);
+        if (value == errors::LST_EMPTY) {
+            sched_yield();
+            continue;
+        }
+
+        // Popping goes on after wrong value, else producers wait for free cells forever
+        int id = value / TEST_QUEUE_VALUES;
+        popped++;
+
+        if (value < 0 || id >= started || value % TEST_QUEUE_VALUES != next[id]) {
+            order_errors++;
+            continue;
+        }
+        next[id]++;
+    }
+
+    for (int i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+        TEST_CHECK(failures, workers[i].push_errors == 0);
+        TEST_CHECK(failures, next[i] == TEST_QUEUE_VALUES);
+    }
+
+    TEST_CHECK(failures, order_errors == 0);
+    TEST_CHECK(failures, list_size(&lst) == 0);
+    TEST_CHECK(failures, pop_front(&lst) == errors::LST_EMPTY);
+    TEST_CHECK(failures, list_error(&lst) == errors::OK);
+
+    list_dtor(&lst);
+    return failures;
+}
+
+//! Function runs ListQueue tests
+//! \return number of failed checks
+static int test_queue() {
+    int failures = 0;
+
+    failures += test_report("queue: capacity 1 and full ring",    test_queue_small());
+    failures += test_report("queue: spsc producer and consumer",  test_queue_stress(QUEUE_SPSC));
+    failures += test_report("queue: mpsc producers and consumer", test_queue_stress(QUEUE_MPSC));
+
+    return failures;
+}
+// ----------------------------------------------------------------------------
+
+#endif // TEST_QUEUEH
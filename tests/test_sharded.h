@@ -0,0 +1,149 @@
+#ifndef TEST_SHARDEDH
+#define TEST_SHARDEDH
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#include "test_base.h"
+#include "../list.h"
+
+// ShardedList tests-----------------------------------------------------------
+// Threads append numbered values to own shards (sharded_push_back) or to shards of threads
+// (push_back, several threads share shard then). Merged view, get and merge_shards must give
+// values of each thread in order of pushes, without losses and duplicates. Shards start small, so
+// unchecked shard lists grow while threads push.
+
+const int TEST_SHARDED_THREADS  = 6;
+const int TEST_SHARDED_VALUES   = 1 << 14;     // Values of each thread
+const int TEST_SHARDED_CAPACITY = 1 << 12;    // Less than values of thread: shard lists grow
+
+struct TestShardedWorker {
+    ShardedList<int>* lst;
+    int               id;
+    int               shard;        // < 0 means push_back to shard of thread
+    int               push_errors;
+};
+
+//! Thread function: appends values id * TEST_SHARDED_VALUES + i
+//! \param arg ptr to TestShardedWorker
+//! \return    NULL
+static void* test_sharded_worker(void* arg) {
+    TestShardedWorker* worker = (TestShardedWorker*) arg;
+
+    for (int i = 0; i < TEST_SHARDED_VALUES; i++) {
+        int value = worker->id * TEST_SHARDED_VALUES + i;
+        int index = worker->shard < 0 ? push_back(worker->lst, value) : sharded_push_back(worker->lst, value, worker->shard);
+
+        if (index <= 0) worker->push_errors++;
+    }
+
+    return NULL;
+}
+
+//! Function checks merged view of shards: walk, get and merge_shards give the same values, values
+//! of each thread are in order
+//! \param lst ptr to ShardedList object
+//! \return    number of failed checks
+static int test_sharded_view(ShardedList<int>* lst) {
+    int failures = 0;
+    int size     = TEST_SHARDED_THREADS * TEST_SHARDED_VALUES;
+
+    TEST_CHECK(failures, list_error(lst) == errors::OK);
+    TEST_CHECK(failures, list_size(lst) == size);
+
+    List<int> merged = { };
+    TEST_CHECK(failures, merge_shards(lst, &merged));
+    TEST_CHECK(failures, merged.size == size);
+    TEST_CHECK(failures, list_error(&merged) == errors::OK);
+
+    int next[TEST_SHARDED_THREADS] = { };
+    int order_errors = 0;
+    int view_errors  = 0;
+    int walked       = 0;
+
+    ShardedCursor cursor = sharded_begin(lst);
+    for (int has_value = cursor.ph_index != 0; has_value && walked < size; has_value = sharded_next(lst, &cursor), walked++) {
+        int value = lst->shards[cursor.shard].list.data.value(cursor.ph_index);
+
+        if (get(lst, walked) != value || get(&merged, walked) != value) view_errors++;
+
+        int id = value / TEST_SHARDED_VALUES;
+        if (value < 0 || id >= TEST_SHARDED_THREADS || value % TEST_SHARDED_VALUES != next[id]) {
+            order_errors++;
+            continue;
+        }
+        next[id]++;
+    }
+
+    TEST_CHECK(failures, walked       == size);
+    TEST_CHECK(failures, view_errors  == 0);
+    TEST_CHECK(failures, order_errors == 0);
+    for (int i = 0; i < TEST_SHARDED_THREADS; i++) {
+        TEST_CHECK(failures, next[i] == TEST_SHARDED_VALUES);
+    }
+
+    TEST_CHECK(failures, get(lst, -1)   == errors::BAD_LOG_INDEX);
+    TEST_CHECK(failures, get(lst, size) == errors::BAD_LOG_INDEX);
+
+    list_dtor(&merged);
+    return failures;
+}
+
+//! Function runs threads, which append to shards
+//! \param n_shards  number of shards
+//! \param own_shard 1 if thread i appends to shard i (sharded_push_back), else push_back is used
+//! \return          number of failed checks
+static int test_sharded_threads(int n_shards, int own_shard) {
+    int failures = 0;
+
+    ShardedList<int> lst = { };
+    TEST_CHECK(failures, list_ctor(&lst, TEST_SHARDED_CAPACITY, n_shards));
+    if (failures) return failures;
+
+    TestShardedWorker workers[TEST_SHARDED_THREADS] = { };
+    pthread_t         threads[TEST_SHARDED_THREADS] = { };
+
+    int started = 0;
+    for (; started < TEST_SHARDED_THREADS; started++) {
+        workers[started] = { &lst, started, own_shard ? started % n_shards : -1, 0 };
+        if (pthread_create(&threads[started], NULL, test_sharded_worker, &workers[started]) != 0) break;
+    }
+    TEST_CHECK(failures, started == TEST_SHARDED_THREADS);
+
+    for (int i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+        TEST_CHECK(failures, workers[i].push_errors == 0);
+    }
+
+    if (started == TEST_SHARDED_THREADS) {
+        failures += test_sharded_view(&lst);
+
+        // Thread i owns shard i: merged view is values in order
+        if (own_shard && n_shards == TEST_SHARDED_THREADS) {
+            int wrong = 0;
+            for (int i = 0; i < TEST_SHARDED_THREADS * TEST_SHARDED_VALUES; i++) {
+                if (get(&lst, i) != i) wrong++;
+            }
+            TEST_CHECK(failures, wrong == 0);
+        }
+    }
+
+    list_dtor(&lst);
+    return failures;
+}
+
+//! Function runs ShardedList tests
+//! \return number of failed checks
+static int test_sharded() {
+    int failures = 0;
+
+    failures += test_report("sharded list: own shard of each thread", test_sharded_threads(TEST_SHARDED_THREADS, 1));
+    failures += test_report("sharded list: threads share shards",     test_sharded_threads(2, 1));
+    failures += test_report("sharded list: push_back of threads",     test_sharded_threads(3, 0));
+
+    return failures;
+}
+// ----------------------------------------------------------------------------
+
+#endif // TEST_SHARDEDH
@@ -0,0 +1,117 @@
+#ifndef TEST_SNAPSHOTH
+#define TEST_SNAPSHOTH
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <unistd.h>
+
+#include "test_base.h"
+#include "../list.h"
+
+// Snapshot file tests---------------------------------------------------------
+// Snapshot file with broken next link of element or cycle in free cells chain must be rejected by
+// every load, which copies cells: LIST_LOAD_COPY and all modes of storages, which can`t map cells.
+// Correct file is loaded by all storages and modes.
+
+const int TEST_SNAPSHOT_SIZE     = 100;
+const int TEST_SNAPSHOT_CAPACITY = 128;
+
+//! Function writes next link of cell in snapshot file
+//! \param filename ptr to path of file
+//! \param cell     physical index of cell
+//! \param next     new next link
+//! \return         1 if success, else 0
+static int test_snapshot_corrupt(const char* filename, int cell, int next) {
+    FILE* file = fopen(filename, "r+b");
+    if (file == NULL) return 0;
+
+    long offset = (long)sizeof(ListFileHeader) + cell * (long)sizeof(ListElement<int>) + (long)offsetof(ListElement<int>, next);
+    int  ok = fseek(file, offset, SEEK_SET) == 0 && fwrite(&next, sizeof(next), 1, file) == 1;
+
+    return (fclose(file) == 0) && ok;
+}
+
+//! Function loads snapshot file by list with Storage in all modes
+//! \param filename ptr to path of file
+//! \param mapped   1 if storage maps cells, so modes except LIST_LOAD_COPY trust links
+//! \param correct  1 if file is correct
+//! \return         number of failed checks
+template <template <typename> class Storage>
+static int test_snapshot_load(const char* filename, int mapped, int correct) {
+    int failures = 0;
+
+    for (int mode = LIST_LOAD_COPY; mode <= LIST_LOAD_READONLY; mode++) {
+        List<int, Storage> lst = { };
+        int loaded = list_load(&lst, filename, mode);
+
+        if (correct) {
+            TEST_CHECK(failures, loaded);
+            TEST_CHECK(failures, loaded && lst.size == TEST_SNAPSHOT_SIZE && get(&lst, TEST_SNAPSHOT_SIZE - 1) == TEST_SNAPSHOT_SIZE - 1);
+        } else if (!mapped || mode == LIST_LOAD_COPY) {
+            TEST_CHECK(failures, !loaded && errno == errors::BAD_SNAPSHOT);
+        }
+
+        if (loaded) list_dtor(&lst);
+    }
+
+    return failures;
+}
+
+//! Function checks loads of correct and broken snapshot files
+//! \return number of failed checks
+static int test_snapshot_links() {
+    int failures = 0;
+
+    char filename[] = "/tmp/test_snapshot_XXXXXX";
+    int  fd = mkstemp(filename);
+    TEST_CHECK(failures, fd >= 0);
+    if (fd < 0) return failures;
+    close(fd);
+
+    List<int> lst = { };
+    TEST_CHECK(failures, list_ctor(&lst, TEST_SNAPSHOT_CAPACITY));
+    for (int i = 0; i < TEST_SNAPSHOT_SIZE; i++) push_back(&lst, i);
+
+    int head       = lst.head;
+    int first_free = lst.first_free;
+
+    // Correct file
+    TEST_CHECK(failures, list_save(&lst, filename));
+    failures += test_snapshot_load<AosStorage>      (filename, 1, 1);
+    failures += test_snapshot_load<SoaStorage>      (filename, 0, 1);
+    failures += test_snapshot_load<SegmentedStorage>(filename, 0, 1);
+    failures += test_snapshot_load<CowStorage>      (filename, 0, 1);
+
+    // Element chain loops back to head
+    TEST_CHECK(failures, test_snapshot_corrupt(filename, head, head));
+    failures += test_snapshot_load<AosStorage>      (filename, 1, 0);
+    failures += test_snapshot_load<SoaStorage>      (filename, 0, 0);
+    failures += test_snapshot_load<SegmentedStorage>(filename, 0, 0);
+    failures += test_snapshot_load<CowStorage>      (filename, 0, 0);
+
+    // Cycle in free cells chain
+    TEST_CHECK(failures, list_save(&lst, filename));
+    TEST_CHECK(failures, test_snapshot_corrupt(filename, first_free, first_free));
+    failures += test_snapshot_load<AosStorage>      (filename, 1, 0);
+    failures += test_snapshot_load<SoaStorage>      (filename, 0, 0);
+    failures += test_snapshot_load<SegmentedStorage>(filename, 0, 0);
+    failures += test_snapshot_load<CowStorage>      (filename, 0, 0);
+
+    list_dtor(&lst);
+    unlink(filename);
+    return failures;
+}
+
+//! Function runs snapshot file tests
+//! \return number of failed checks
+static int test_snapshot() {
+    int failures = 0;
+
+    failures += test_report("snapshot file: broken links are rejected by copying loads", test_snapshot_links());
+
+    return failures;
+}
+// ----------------------------------------------------------------------------
+
+#endif // TEST_SNAPSHOTH
@@ -0,0 +1,268 @@
+#ifndef TEST_TEXT_SCANH
+#define TEST_TEXT_SCANH
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "test_base.h"
+#include "../libs/file_funcs.h"
+#include "../libs/text_scan.h"
+
+// Text scanning tests---------------------------------------------------------
+// Every kernel, which CPU supports, is compared with byte loops (the loops, which were used
+// before kernels) on random buffers of all small sizes and alignments.
+
+const char   TEST_TEXT_SET[]     = "ab7-+ \t\n\v\f\r\0\x80\xff";
+const size_t TEST_TEXT_SET_SIZE  = sizeof(TEST_TEXT_SET) - 1;
+const int    TEST_TEXT_MAX_SIZE  = 300;     // Covers tails and several 64-byte blocks
+const int    TEST_TEXT_ROUNDS    = 20;
+
+//! Function checks if symbol is space by isspace of "C" locale
+//! \param symbol checked symbol
+//! \return       1 if symbol is space, else 0
+static int test_is_space(char symbol) {
+    return isspace((unsigned char)symbol) != 0;
+}
+
+//! Byte loop of replace (see replace in libs/file_funcs.cpp)
+static int test_replace_loop(char* string, size_t size, char old_symbol, char new_symbol, int n_replace) {
+    int n_rep = 0;
+
+    for (int i = 0; i < (int)size; i++) {
+        if (n_rep >= n_replace && n_replace >= 0) {
+            break;
+        }
+        if (string[i] == old_symbol) {
+            string[i] = new_symbol;
+            n_rep++;
+        }
+    }
+
+    return n_rep;
+}
+
+//! Byte loop of load_string_pointers (see load_string_pointers in libs/file_funcs.cpp)
+static int test_load_string_pointers_loop(Text* text, int skip_empty_strings, int skip_first_last_spaces) {
+    int skiped_str = 0, letters_started = 0, spaces_count = 0;
+    char* start_ptr = (char*)text->data;
+
+    for (int i = 0, str_index = 0; i < (int)text->data_size && str_index < (int)text->lines; i++) {
+        if (text->data[i] == '\0') {
+            char* end_ptr = (char*)&(text->data[i]);
+
+            if (skip_first_last_spaces) {
+                if (spaces_count) {
+                    text->data[i - spaces_count] = '\0';
+                    end_ptr -= spaces_count;
+
+                    spaces_count = 0;
+                }
+
+                if (!letters_started) {
+                    start_ptr    += spaces_count;
+                    spaces_count  = 0;
+                }
+            }
+
+            struct String string = {
+                    start_ptr,
+                    (size_t)(end_ptr - start_ptr)
+            };
+
+            if (skip_empty_strings && string.len == 0) {
+                skiped_str++;
+            } else {
+                text->text[str_index++] = string;
+            }
+
+            start_ptr = (char*)&(text->data[i + 1]);
+            letters_started = 0;
+
+            continue;
+        }
+
+        if (skip_first_last_spaces) {
+            if (test_is_space(text->data[i])) {
+                spaces_count++;
+            }
+            if (!test_is_space(text->data[i]) && !letters_started) {
+                start_ptr += spaces_count;
+                letters_started = 1;
+            }
+            if (!test_is_space(text->data[i])) {
+                spaces_count = 0;
+            }
+        }
+    }
+
+    text->lines -= skiped_str;
+
+    return 1;
+}
+
+//! Byte loop of index_lines: lines are ended by '\n' or end of buffer, spaces line becomes empty at its end
+static size_t test_index_lines_loop(char* data, size_t size, String* strings, int skip_empty_strings, int skip_first_last_spaces) {
+    size_t n_strings = 0;
+
+    for (char* start = data, *end = data + size; start < end; ) {
+        char* line_end = start;
+        while (line_end < end && *line_end != '\n') line_end++;
+
+        char* first = start;
+        char* last  = line_end;
+        if (skip_first_last_spaces) {
+            while (first < line_end && test_is_space(*first)) first++;
+            while (last  > first    && test_is_space(last[-1])) last--;
+            if (first == line_end) last = first;
+        }
+
+        if (!skip_empty_strings || last != first) strings[n_strings++] = { first, (size_t)(last - first) };
+        start = line_end + 1;
+    }
+
+    return n_strings;
+}
+
+//! Function compares string arrays of two copies of one buffer
+//! \return 1 if strings have the same places and lengths, else 0
+static int test_same_strings(const String* strings, const char* data, const String* expected, const char* expected_data, size_t n_strings) {
+    for (size_t i = 0; i < n_strings; i++) {
+        if (strings[i].ptr - data != expected[i].ptr - expected_data || strings[i].len != expected[i].len) return 0;
+    }
+
+    return 1;
+}
+
+//! Function compares scanning funcs of used kernel with byte loops
+//! \return number of failed checks
+static int test_text_scan_kernel() {
+    int failures = 0;
+
+    char buffer  [TEST_TEXT_MAX_SIZE + 64] = "";
+    char expected[TEST_TEXT_MAX_SIZE + 64] = "";
+
+    for (int round = 0; round < TEST_TEXT_ROUNDS; round++) {
+        for (int size = 0; size <= TEST_TEXT_MAX_SIZE; size++) {
+            char* begin = buffer + round % 32;      // All alignments of beginning
+            char* end   = begin + size;
+            test_random_buffer(begin, (size_t)size, TEST_TEXT_SET, TEST_TEXT_SET_SIZE);
+
+            char byte = TEST_TEXT_SET[rand() % TEST_TEXT_SET_SIZE];
+
+            const char* found = begin;
+            while (found < end && *found != byte) found++;
+            TEST_CHECK(failures, scan_find_byte(begin, end, byte) == found);
+
+            size_t count = 0;
+            for (const char* ptr = begin; ptr < end; ptr++) count += *ptr == byte;
+            TEST_CHECK(failures, scan_count_byte(begin, end, byte) == count);
+
+            const char* first = begin;
+            while (first < end && test_is_space(*first)) first++;
+            TEST_CHECK(failures, scan_skip_spaces(begin, end) == first);
+
+            const char* last = end;
+            while (last > begin && test_is_space(last[-1])) last--;
+            TEST_CHECK(failures, scan_trim_spaces(begin, end) == last);
+
+            int n_replace = round % 4 == 0 ? -1 : rand() % 8;
+            char new_byte = TEST_TEXT_SET[rand() % TEST_TEXT_SET_SIZE];
+            memcpy(expected, begin, (size_t)size);
+
+            int replaced = test_replace_loop(expected, (size_t)size, byte, new_byte, n_replace);
+            TEST_CHECK(failures, replace(begin, (size_t)size, byte, new_byte, n_replace) == replaced);
+            TEST_CHECK(failures, memcmp(begin, expected, (size_t)size) == 0);
+        }
+
+        char block[TEXT_SCAN_BLOCK] = "";
+        test_random_buffer(block, sizeof(block), TEST_TEXT_SET, TEST_TEXT_SET_SIZE);
+
+        uint64_t byte_mask = 0, space_mask = 0, expected_bytes = 0, expected_spaces = 0;
+        scan_block_masks(block, '\n', &byte_mask, &space_mask);
+        for (int i = 0; i < TEXT_SCAN_BLOCK; i++) {
+            if (block[i] == '\n')          expected_bytes  |= 1ULL << i;
+            if (test_is_space(block[i]))   expected_spaces |= 1ULL << i;
+        }
+        TEST_CHECK(failures, byte_mask == expected_bytes && space_mask == expected_spaces);
+    }
+
+    return failures;
+}
+
+//! Function compares line splitting (load_string_pointers and index_lines) with byte loops
+//! \return number of failed checks
+static int test_text_scan_lines() {
+    int failures = 0;
+
+    const int MAX_SIZE = 4 * TEST_TEXT_MAX_SIZE;
+
+    char*   data          = (char*)   calloc(MAX_SIZE, sizeof(char));
+    char*   expected_data = (char*)   calloc(MAX_SIZE, sizeof(char));
+    String* strings       = (String*) calloc(MAX_SIZE, sizeof(String));
+    String* expected      = (String*) calloc(MAX_SIZE, sizeof(String));
+
+    for (int round = 0; round < 40 * TEST_TEXT_ROUNDS; round++) {
+        size_t size = (size_t)(rand() % MAX_SIZE);
+        test_random_buffer(data, size, TEST_TEXT_SET, TEST_TEXT_SET_SIZE);
+        memcpy(expected_data, data, size);
+
+        int skip_empty  = round % 2;
+        int skip_spaces = round / 2 % 2;
+
+        // Lines ended by '\0' (like after get_text_from_file)
+        size_t lines = 0;
+        for (size_t i = 0; i < size; i++) lines += data[i] == '\0';
+
+        Text text          = { data,          size, strings,  lines, 0 };
+        Text expected_text = { expected_data, size, expected, lines, 0 };
+        load_string_pointers(&text, skip_empty, skip_spaces);
+        test_load_string_pointers_loop(&expected_text, skip_empty, skip_spaces);
+
+        TEST_CHECK(failures, text.lines == expected_text.lines);
+        TEST_CHECK(failures, test_same_strings(strings, data, expected, expected_data, expected_text.lines));
+        TEST_CHECK(failures, memcmp(data, expected_data, size) == 0);
+
+        // Lines ended by '\n' (like in mapped text)
+        test_random_buffer(data, size, TEST_TEXT_SET, TEST_TEXT_SET_SIZE);
+
+        size_t n_strings          = index_lines(data, size, strings, skip_empty, skip_spaces);
+        size_t expected_n_strings = test_index_lines_loop(data, size, expected, skip_empty, skip_spaces);
+
+        TEST_CHECK(failures, count_lines(data, size) >= n_strings);
+        TEST_CHECK(failures, n_strings == expected_n_strings);
+        TEST_CHECK(failures, test_same_strings(strings, data, expected, data, expected_n_strings));
+    }
+
+    free(data);
+    free(expected_data);
+    free(strings);
+    free(expected);
+
+    return failures;
+}
+
+//! Function runs text scanning tests for all kernels, which CPU supports
+//! \return number of failed checks
+static int test_text_scan() {
+    int failures = 0;
+
+    const int kernels[] = { TEXT_SCAN_SCALAR, TEXT_SCAN_SSE2, TEXT_SCAN_AVX2 };
+    for (int kernel : kernels) {
+        if (text_scan_use(kernel) != kernel) continue;      // CPU doesn`t support kernel
+
+        char name[64] = "";
+        snprintf(name, sizeof(name), "text scan kernel %s", text_scan_kernel_name());
+        failures += test_report(name, test_text_scan_kernel());
+
+        snprintf(name, sizeof(name), "line splitting with %s kernel", text_scan_kernel_name());
+        failures += test_report(name, test_text_scan_lines());
+    }
+    text_scan_use(TEXT_SCAN_AUTO);
+
+    return failures;
+}
+// ----------------------------------------------------------------------------
+
+#endif // TEST_TEXT_SCANH
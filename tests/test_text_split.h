@@ -0,0 +1,133 @@
+#ifndef TEST_TEXT_SPLITH
+#define TEST_TEXT_SPLITH
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test_base.h"
+#include "../libs/file_funcs.h"
+
+// Parallel line splitting tests-----------------------------------------------
+// Texts, which are split by several threads, are compared with serial split of the same file.
+// Files are bigger than several TEXT_THREAD_MIN_CHUNK, so they are really cut to chunks.
+
+const char* const TEST_SPLIT_FILE     = "test_split.txt";
+const size_t      TEST_SPLIT_SIZE     = 5 * TEXT_THREAD_MIN_CHUNK + 12345;
+const int         TEST_SPLIT_THREADS[] = { 2, 3, 5, 8 };
+
+enum test_split_files {
+    TEST_SPLIT_LINES      = 0,  // Short lines with spaces and empty lines, file ends by '\n'
+    TEST_SPLIT_NO_NEWLINE = 1,  // The same, but last line isn`t ended by '\n'
+    TEST_SPLIT_LONG_LINES = 2,  // Lines are longer than chunks
+    TEST_SPLIT_ZEROS      = 3,  // File has '\0' bytes (serial split limits lines by number of '\n')
+
+    TEST_SPLIT_N_FILES
+};
+
+//! Function writes test file
+//! \param kind kind of file (see test_split_files)
+//! \return     1 if file is written, else 0
+static int test_split_write(int kind) {
+    const char set[] = "ab1 \t\r\v";
+
+    char* data = (char*) calloc(TEST_SPLIT_SIZE, sizeof(char));
+    if (data == NULL) return 0;
+
+    size_t line_len = 0;
+    for (size_t i = 0; i < TEST_SPLIT_SIZE; i++) {
+        int    roll      = rand() % 1000;
+        int    long_kind = kind == TEST_SPLIT_LONG_LINES;
+        size_t max_line  = long_kind ? TEXT_THREAD_MIN_CHUNK * 3 / 2 : 120;
+
+        if (line_len >= max_line || (!long_kind && roll < 20)) {
+            data[i]  = '\n';
+            line_len = 0;
+            continue;
+        }
+
+        data[i] = kind == TEST_SPLIT_ZEROS && roll < 22 ? '\0' : set[rand() % (sizeof(set) - 1)];
+        line_len++;
+    }
+
+    if (kind == TEST_SPLIT_NO_NEWLINE) data[TEST_SPLIT_SIZE - 1] = 'z';
+    else                               data[TEST_SPLIT_SIZE - 1] = '\n';
+
+    FILE* file = fopen(TEST_SPLIT_FILE, "wb");
+    int   ok   = file != NULL && fwrite(data, sizeof(char), TEST_SPLIT_SIZE, file) == TEST_SPLIT_SIZE;
+    if (file != NULL) ok = fclose(file) == 0 && ok;
+
+    free(data);
+    return ok;
+}
+
+//! Function compares two texts of the same file
+//! \param text     ptr to checked Text object
+//! \param expected ptr to Text object of serial split
+//! \return         1 if texts have the same data and strings, else 0
+static int test_split_same(const Text* text, const Text* expected) {
+    if (text->lines != expected->lines || text->data_size != expected->data_size) return 0;
+    if (memcmp(text->data, expected->data, text->data_size) != 0)                 return 0;
+
+    for (size_t i = 0; i < text->lines; i++) {
+        if (text->text[i].ptr - text->data != expected->text[i].ptr - expected->data) return 0;
+        if (text->text[i].len != expected->text[i].len)                             return 0;
+    }
+
+    return 1;
+}
+
+//! Function frees text, which was read (not mapped) by get_text_from_file
+//! \param text ptr to Text object
+static void test_split_free(Text* text) {
+    free(text->data);
+    free(text->text);
+    *text = { };
+}
+
+//! Function compares split of several threads with serial split for all kinds of files and skip flags
+//! \return number of failed checks
+static int test_text_split_files() {
+    int failures = 0;
+
+    for (int kind = 0; kind < TEST_SPLIT_N_FILES; kind++) {
+        if (!test_split_write(kind)) {
+            TEST_CHECK(failures, !"test file is written");
+            continue;
+        }
+
+        for (int flags = 0; flags < 4; flags++) {
+            int skip_empty  = flags % 2;
+            int skip_spaces = flags / 2;
+
+            Text expected        = get_text_from_file       (TEST_SPLIT_FILE, skip_empty, skip_spaces, 1);
+            Text expected_mapped = get_text_from_file_mapped(TEST_SPLIT_FILE, skip_empty, skip_spaces, 1);
+
+            for (int n_threads : TEST_SPLIT_THREADS) {
+                Text text   = get_text_from_file       (TEST_SPLIT_FILE, skip_empty, skip_spaces, n_threads);
+                Text mapped = get_text_from_file_mapped(TEST_SPLIT_FILE, skip_empty, skip_spaces, n_threads);
+
+                TEST_CHECK(failures, test_split_same(&text,   &expected));
+                TEST_CHECK(failures, test_split_same(&mapped, &expected_mapped));
+
+                test_split_free(&text);
+                free_text(&mapped);
+            }
+
+            test_split_free(&expected);
+            free_text(&expected_mapped);
+        }
+    }
+
+    remove(TEST_SPLIT_FILE);
+    return failures;
+}
+
+//! Function runs parallel line splitting tests
+//! \return number of failed checks
+static int test_text_split() {
+    return test_report("parallel line splitting equals serial split", test_text_split_files());
+}
+// ----------------------------------------------------------------------------
+
+#endif // TEST_TEXT_SPLITH
@@ -14,7 +14,7 @@
 #include "../libs/file_funcs.h"
 
 int test_work_graph() {
-    List lst = { };
+    List<int> lst = { };
     list_ctor(&lst);
 
     for (int i = 0; i < 5; i++) {